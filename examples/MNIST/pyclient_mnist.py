@@ -44,7 +44,8 @@ def test_mnist_cnn(FLAGS):
     results = client.get_results()
     results = np.round(results, 2)
 
-    y_pred_reshape = np.array(results).reshape(10, batch_size)
+    # Results are batch-major
+    y_pred_reshape = np.array(results).reshape(batch_size, 10).T
     with np.printoptions(precision=3, suppress=True):
         print(y_pred_reshape.T)
 
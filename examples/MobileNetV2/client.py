@@ -115,10 +115,11 @@ def main(FLAGS):
         top5 = results.argsort()[-5:]
     else:
         print('results shape', results.shape)
+        # Results are batch-major
         results = np.reshape(results, (
-            1001,
             FLAGS.batch_size,
-        ))
+            1001,
+        )).T
         print('results.shape', results.shape)
 
         try:
@@ -1,5 +1,5 @@
 //*****************************************************************************
-// Copyright 2017-2019 Intel Corporation
+// Copyright 2018-2019 Intel Corporation
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,30 +16,152 @@
 
 #pragma once
 
+#include <chrono>
+#include <future>
 #include <iterator>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <boost/asio.hpp>
 
 #include "he_seal_client.hpp"
 #include "seal/he_seal_client.hpp"
+#include "tcp/transport_uri.hpp"
 
 namespace py = pybind11;
 
+namespace ngraph {
+namespace he {
+// Accepts any float32 C-contiguous buffer without copying; other sequences
+// are converted once
+using float_array =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+// Returns a NumPy array owning values, without copying them
+inline py::array_t<float> to_numpy(std::vector<float>&& values) {
+  auto owned_values = new std::vector<float>(std::move(values));
+  py::capsule owner(owned_values, [](void* ptr) {
+    delete reinterpret_cast<std::vector<float>*>(ptr);
+  });
+  return py::array_t<float>(owned_values->size(), owned_values->data(),
+                            owner);
+}
+
+/// \brief Python handle to the results of a query submitted to HESealClient.
+/// Waiting for the results releases the GIL.
+class HESealClientFuture {
+ public:
+  HESealClientFuture(std::future<std::vector<float>>&& future)
+      : m_future(std::move(future)) {}
+
+  bool done() const {
+    return m_results != nullptr ||
+           m_future.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+  }
+
+  // Returns the query results, waiting at most timeout seconds if timeout is
+  // not None
+  py::array_t<float> result(py::object timeout) {
+    if (m_results == nullptr) {
+      bool ready = true;
+      if (timeout.is_none()) {
+        py::gil_scoped_release release;
+        m_future.wait();
+      } else {
+        double timeout_seconds = timeout.cast<double>();
+        py::gil_scoped_release release;
+        ready = m_future.wait_for(std::chrono::duration<double>(
+                    timeout_seconds)) == std::future_status::ready;
+      }
+      if (!ready) {
+        PyErr_SetString(PyExc_TimeoutError, "Query results not ready");
+        throw py::error_already_set();
+      }
+      // Rethrows errors of the query, e.g. a closed connection
+      m_results =
+          std::make_shared<py::array_t<float>>(to_numpy(m_future.get()));
+    }
+    return *m_results;
+  }
+
+ private:
+  std::future<std::vector<float>> m_future;
+  std::shared_ptr<py::array_t<float>> m_results;
+};
+}  // namespace he
+}  // namespace ngraph
+
 PYBIND11_MODULE(he_seal_client, m) {
-  py::class_<ngraph::he::HESealClient> he_seal_client(m, "HESealClient");
+  using ngraph::he::float_array;
+  using ngraph::he::HESealClient;
+  using ngraph::he::HESealClientFuture;
+
+  py::class_<HESealClientFuture> he_seal_client_future(m,
+                                                       "HESealClientFuture");
+  he_seal_client_future.doc() = "Results of a query submitted to HESealClient";
+  he_seal_client_future.def("done", &HESealClientFuture::done);
+  he_seal_client_future.def("result", &HESealClientFuture::result,
+                            py::arg("timeout") = py::none());
+
+  py::class_<HESealClient> he_seal_client(m, "HESealClient");
   he_seal_client.doc() = "he_seal_client wraps ngraph::he::HESealClient";
 
-  he_seal_client.def(py::init<const std::string&, const std::size_t,
-                              const size_t, const std::vector<float>&>());
+  // Asynchronous client for any number of queries passed to submit. Listed
+  // before the blocking constructors, so an integer third argument is taken
+  // as num_threads
+  he_seal_client.def(
+      py::init<const std::string&, const size_t, const size_t>(),
+      py::arg("server_uri"), py::arg("batch_size"), py::arg("num_threads") = 1,
+      py::call_guard<py::gil_scoped_release>());
+
+  // Blocking clients, which perform one inference on inputs. The GIL is
+  // released during key generation, encryption and network I/O
+  he_seal_client.def(
+      py::init([](const std::string& hostname, const size_t port,
+                  const size_t batch_size, float_array inputs) {
+        const float* data = inputs.data();
+        const size_t size = inputs.size();
+        py::gil_scoped_release release;
+        return std::make_unique<HESealClient>(
+            ngraph::he::TransportURI::from_host_port(hostname, port)
+                .to_string(),
+            batch_size, data, size);
+      }));
+  he_seal_client.def(py::init([](const std::string& server_uri,
+                                 const size_t batch_size, float_array inputs) {
+    const float* data = inputs.data();
+    const size_t size = inputs.size();
+    py::gil_scoped_release release;
+    return std::make_unique<HESealClient>(server_uri, batch_size, data, size);
+  }));
+
+  // inputs is only read while submit runs, during which the caller holds it
+  he_seal_client.def(
+      "submit",
+      [](HESealClient& client, float_array inputs) {
+        const float* data = inputs.data();
+        const size_t size = inputs.size();
+        py::gil_scoped_release release;
+        return HESealClientFuture(client.submit(data, size));
+      },
+      py::arg("inputs"));
 
-  he_seal_client.def("set_seal_context",
-                     &ngraph::he::HESealClient::set_seal_context);
-  he_seal_client.def("is_done", &ngraph::he::HESealClient::is_done);
-  he_seal_client.def("get_results", &ngraph::he::HESealClient::get_results);
-  he_seal_client.def("close_connection",
-                     &ngraph::he::HESealClient::close_connection);
+  he_seal_client.def("set_seal_context", &HESealClient::set_seal_context,
+                     py::call_guard<py::gil_scoped_release>());
+  he_seal_client.def("is_done", &HESealClient::is_done);
+  // Returns a view of the results of the blocking inference, which keeps the
+  // client alive
+  he_seal_client.def("get_results", [](py::object self) {
+    const std::vector<float>& results =
+        self.cast<HESealClient&>().get_results();
+    return py::array_t<float>(results.size(), results.data(), self);
+  });
+  he_seal_client.def("close_connection", &HESealClient::close_connection,
+                     py::call_guard<py::gil_scoped_release>());
 }
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -34,10 +35,24 @@ class HEPlaintext {
   const std::vector<float>& values() const { return m_values; }
 
   bool is_single_value() const { return num_values() == 1; }
+
+  /// \brief Returns true if all values are equal, e.g. a scalar repeated
+  /// across the batch. Such plaintexts multiply and add as single values
+  bool is_uniform() const {
+    return !m_values.empty() &&
+           std::all_of(m_values.begin(), m_values.end(),
+                       [this](float f) { return f == m_values[0]; });
+  }
   size_t num_values() const { return m_values.size(); }
 
+  /// \brief Returns the scale at which to encode the plaintext when it
+  /// multiplies a ciphertext, or 0 to use the scale of the ciphertext
+  double encoding_scale() const { return m_encoding_scale; }
+  double& encoding_scale() { return m_encoding_scale; }
+
  private:
   std::vector<float> m_values;
+  double m_encoding_scale{0};
 };
 }  // namespace he
 }  // namespace ngraph
@@ -0,0 +1,52 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "op/biased_convolution.hpp"
+#include "ngraph/util.hpp"
+
+using namespace std;
+using namespace ngraph;
+
+op::BiasedConvolution::BiasedConvolution(
+    const shared_ptr<op::Convolution>& convolution, shared_ptr<Node> bias)
+    : Op("BiasedConvolution",
+         check_single_output_args({convolution->get_argument(0),
+                                   convolution->get_argument(1), bias})),
+      m_window_movement_strides(convolution->get_window_movement_strides()),
+      m_window_dilation_strides(convolution->get_window_dilation_strides()),
+      m_padding_below(convolution->get_padding_below()),
+      m_padding_above(convolution->get_padding_above()),
+      m_data_dilation_strides(convolution->get_data_dilation_strides()) {
+  constructor_validate_and_infer_types();
+  NODE_VALIDATION_CHECK(this, bias->get_shape() == convolution->get_shape(),
+                        "Bias shape ", bias->get_shape(),
+                        " does not match the convolution output shape ",
+                        convolution->get_shape());
+  set_output_type(0, convolution->get_element_type(),
+                  convolution->get_shape());
+}
+
+shared_ptr<Node> op::BiasedConvolution::copy_with_new_args(
+    const NodeVector& new_args) const {
+  if (new_args.size() != 3) {
+    throw ngraph_error("Incorrect number of new arguments");
+  }
+  auto convolution = make_shared<Convolution>(
+      new_args.at(0), new_args.at(1), m_window_movement_strides,
+      m_window_dilation_strides, m_padding_below, m_padding_above,
+      m_data_dilation_strides);
+  return make_shared<BiasedConvolution>(convolution, new_args.at(2));
+}
@@ -0,0 +1,61 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+
+#include "ngraph/node.hpp"
+#include "ngraph/op/convolution.hpp"
+#include "ngraph/op/op.hpp"
+
+namespace ngraph {
+namespace op {
+/// \brief Convolution followed by an Add of a bias. The HE kernels add the
+/// bias to each output in the epilogue of the convolution loop.
+///
+class BiasedConvolution : public ngraph::op::Op {
+ public:
+  /// \brief Constructs a BiasedConvolution operation.
+  ///
+  /// \param convolution Convolution whose arguments and attributes to use.
+  /// \param bias Node added to the convolution output, of the output shape.
+  BiasedConvolution(const std::shared_ptr<ngraph::op::Convolution>& convolution,
+                    std::shared_ptr<ngraph::Node> bias);
+
+  const Strides& get_window_movement_strides() const {
+    return m_window_movement_strides;
+  }
+  const Strides& get_window_dilation_strides() const {
+    return m_window_dilation_strides;
+  }
+  const CoordinateDiff& get_padding_below() const { return m_padding_below; }
+  const CoordinateDiff& get_padding_above() const { return m_padding_above; }
+  const Strides& get_data_dilation_strides() const {
+    return m_data_dilation_strides;
+  }
+  virtual std::shared_ptr<Node> copy_with_new_args(
+      const NodeVector& new_args) const override;
+
+ private:
+  Strides m_window_movement_strides;
+  Strides m_window_dilation_strides;
+  CoordinateDiff m_padding_below;
+  CoordinateDiff m_padding_above;
+  Strides m_data_dilation_strides;
+};
+}  // namespace op
+}  // namespace ngraph
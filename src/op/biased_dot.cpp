@@ -0,0 +1,43 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "op/biased_dot.hpp"
+#include "ngraph/util.hpp"
+
+using namespace std;
+using namespace ngraph;
+
+op::BiasedDot::BiasedDot(const shared_ptr<op::Dot>& dot, shared_ptr<Node> bias)
+    : Op("BiasedDot", check_single_output_args(
+                          {dot->get_argument(0), dot->get_argument(1), bias})),
+      m_reduction_axes_count(dot->get_reduction_axes_count()) {
+  constructor_validate_and_infer_types();
+  NODE_VALIDATION_CHECK(this, bias->get_shape() == dot->get_shape(),
+                        "Bias shape ", bias->get_shape(),
+                        " does not match the dot output shape ",
+                        dot->get_shape());
+  set_output_type(0, dot->get_element_type(), dot->get_shape());
+}
+
+shared_ptr<Node> op::BiasedDot::copy_with_new_args(
+    const NodeVector& new_args) const {
+  if (new_args.size() != 3) {
+    throw ngraph_error("Incorrect number of new arguments");
+  }
+  auto dot = make_shared<Dot>(new_args.at(0), new_args.at(1),
+                              m_reduction_axes_count);
+  return make_shared<BiasedDot>(dot, new_args.at(2));
+}
@@ -0,0 +1,47 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+
+#include "ngraph/node.hpp"
+#include "ngraph/op/dot.hpp"
+#include "ngraph/op/op.hpp"
+
+namespace ngraph {
+namespace op {
+/// \brief Dot followed by an Add of a bias. The HE kernels add the bias to
+/// each output in the epilogue of the dot loop.
+///
+class BiasedDot : public ngraph::op::Op {
+ public:
+  /// \brief Constructs a BiasedDot operation.
+  ///
+  /// \param dot Dot whose arguments and reduction axes count to use.
+  /// \param bias Node added to the dot output, of the output shape.
+  BiasedDot(const std::shared_ptr<ngraph::op::Dot>& dot,
+            std::shared_ptr<ngraph::Node> bias);
+
+  size_t get_reduction_axes_count() const { return m_reduction_axes_count; }
+  virtual std::shared_ptr<Node> copy_with_new_args(
+      const NodeVector& new_args) const override;
+
+ private:
+  size_t m_reduction_axes_count;
+};
+}  // namespace op
+}  // namespace ngraph
@@ -0,0 +1,208 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "ngraph/function.hpp"
+#include "ngraph/graph_util.hpp"
+#include "ngraph/log.hpp"
+#include "ngraph/op/add.hpp"
+#include "ngraph/op/batch_norm.hpp"
+#include "ngraph/op/broadcast.hpp"
+#include "ngraph/op/constant.hpp"
+#include "ngraph/op/convolution.hpp"
+#include "ngraph/op/dot.hpp"
+#include "pass/he_batch_norm_folding.hpp"
+
+namespace {
+std::shared_ptr<ngraph::op::Constant> as_f32_constant(
+    const std::shared_ptr<ngraph::Node>& node) {
+  auto constant = std::dynamic_pointer_cast<ngraph::op::Constant>(node);
+  if (constant == nullptr ||
+      constant->get_element_type() != ngraph::element::f32) {
+    return nullptr;
+  }
+  return constant;
+}
+
+bool is_linear_op(const std::shared_ptr<ngraph::Node>& node) {
+  return std::dynamic_pointer_cast<ngraph::op::Convolution>(node) != nullptr ||
+         std::dynamic_pointer_cast<ngraph::op::Dot>(node) != nullptr;
+}
+
+// Returns a copy of the Convolution or Dot node whose weights of output
+// channel c are multiplied by scale[c], or nullptr if the weights are not a
+// constant of the expected layout
+std::shared_ptr<ngraph::Node> scale_linear_op(
+    const std::shared_ptr<ngraph::Node>& node,
+    const std::vector<double>& scale) {
+  auto weights = as_f32_constant(node->get_argument(1));
+  if (weights == nullptr || node->get_users().size() != 1) {
+    return nullptr;
+  }
+  const size_t channels = scale.size();
+  const ngraph::Shape& weight_shape = weights->get_shape();
+  std::vector<float> weight_vals = weights->get_vector<float>();
+
+  if (std::dynamic_pointer_cast<ngraph::op::Convolution>(node) != nullptr) {
+    // Filters are laid out output channel first
+    if (weight_shape.empty() || weight_shape[0] != channels) {
+      return nullptr;
+    }
+    const size_t channel_size = weight_vals.size() / channels;
+    for (size_t i = 0; i < weight_vals.size(); ++i) {
+      weight_vals[i] *= scale[i / channel_size];
+    }
+  } else {
+    auto dot = std::static_pointer_cast<ngraph::op::Dot>(node);
+    // Output channels are the columns of a matrix of weights
+    if (dot->get_reduction_axes_count() != 1 || weight_shape.size() != 2 ||
+        weight_shape[1] != channels || node->get_shape().size() != 2) {
+      return nullptr;
+    }
+    for (size_t i = 0; i < weight_vals.size(); ++i) {
+      weight_vals[i] *= scale[i % channels];
+    }
+  }
+  auto new_weights = ngraph::op::Constant::create(ngraph::element::f32,
+                                                  weight_shape, weight_vals);
+  return node->copy_with_new_args(
+      ngraph::NodeVector{node->get_argument(0), new_weights});
+}
+
+// Returns the bias scale[c] * bias + shift[c] of output channel c, where bias
+// is nullptr (zero), a Broadcast of a constant along the channel axis, or a
+// constant of the output shape. Returns nullptr for any other bias
+std::shared_ptr<ngraph::Node> fold_bias(
+    const std::shared_ptr<ngraph::Node>& bias, const ngraph::Shape& out_shape,
+    const std::vector<double>& scale, const std::vector<double>& shift) {
+  const size_t channels = scale.size();
+  ngraph::AxisSet broadcast_axes;
+  for (size_t axis = 0; axis < out_shape.size(); ++axis) {
+    if (axis != 1) {
+      broadcast_axes.insert(axis);
+    }
+  }
+
+  std::vector<float> channel_bias(channels, 0);
+  if (bias != nullptr) {
+    if (auto constant = as_f32_constant(bias)) {
+      if (constant->get_shape() != out_shape) {
+        return nullptr;
+      }
+      std::vector<float> bias_vals = constant->get_vector<float>();
+      const size_t inner_size = bias_vals.size() / (out_shape.at(0) * channels);
+      for (size_t i = 0; i < bias_vals.size(); ++i) {
+        size_t c = (i / inner_size) % channels;
+        bias_vals[i] = scale[c] * bias_vals[i] + shift[c];
+      }
+      return ngraph::op::Constant::create(ngraph::element::f32, out_shape,
+                                          bias_vals);
+    }
+    auto broadcast = std::dynamic_pointer_cast<ngraph::op::Broadcast>(bias);
+    if (broadcast == nullptr ||
+        broadcast->get_broadcast_axes() != broadcast_axes) {
+      return nullptr;
+    }
+    auto constant = as_f32_constant(broadcast->get_argument(0));
+    if (constant == nullptr) {
+      return nullptr;
+    }
+    channel_bias = constant->get_vector<float>();
+  }
+
+  for (size_t c = 0; c < channels; ++c) {
+    channel_bias[c] = scale[c] * channel_bias[c] + shift[c];
+  }
+  auto channel_constant = ngraph::op::Constant::create(
+      ngraph::element::f32, ngraph::Shape{channels}, channel_bias);
+  return std::make_shared<ngraph::op::Broadcast>(channel_constant, out_shape,
+                                                 broadcast_axes);
+}
+}  // namespace
+
+bool ngraph::he::pass::HEBatchNormFolding::run_on_function(
+    std::shared_ptr<ngraph::Function> function) {
+  bool modified = false;
+  for (const std::shared_ptr<Node>& node : function->get_ordered_ops()) {
+    auto bn = std::dynamic_pointer_cast<op::BatchNormInference>(node);
+    if (bn == nullptr || bn->get_element_type() != element::f32) {
+      continue;
+    }
+    // Arguments are ordered gamma, beta, input, mean, variance
+    auto gamma = as_f32_constant(bn->get_argument(0));
+    auto beta = as_f32_constant(bn->get_argument(1));
+    auto mean = as_f32_constant(bn->get_argument(3));
+    auto variance = as_f32_constant(bn->get_argument(4));
+    if (gamma == nullptr || beta == nullptr || mean == nullptr ||
+        variance == nullptr) {
+      NGRAPH_DEBUG << "BatchNorm " << bn->get_name()
+                   << " has non-constant parameters";
+      continue;
+    }
+
+    std::shared_ptr<Node> linear = bn->get_argument(2);
+    std::shared_ptr<Node> bias;
+    if (std::dynamic_pointer_cast<op::Add>(linear) != nullptr) {
+      if (linear->get_users().size() != 1) {
+        continue;
+      }
+      bias = linear->get_argument(1);
+      linear = linear->get_argument(0);
+      if (!is_linear_op(linear)) {
+        std::swap(linear, bias);
+      }
+    }
+    if (!is_linear_op(linear)) {
+      NGRAPH_DEBUG << "BatchNorm " << bn->get_name()
+                   << " does not follow Convolution or Dot";
+      continue;
+    }
+
+    const std::vector<float> gamma_vals = gamma->get_vector<float>();
+    const std::vector<float> beta_vals = beta->get_vector<float>();
+    const std::vector<float> mean_vals = mean->get_vector<float>();
+    const std::vector<float> variance_vals = variance->get_vector<float>();
+    const double eps = bn->get_eps_value();
+    std::vector<double> scale(gamma_vals.size());
+    std::vector<double> shift(gamma_vals.size());
+    for (size_t c = 0; c < gamma_vals.size(); ++c) {
+      scale[c] = gamma_vals[c] / std::sqrt(variance_vals[c] + eps);
+      shift[c] = beta_vals[c] - scale[c] * mean_vals[c];
+    }
+
+    std::shared_ptr<Node> new_bias =
+        fold_bias(bias, bn->get_shape(), scale, shift);
+    if (new_bias == nullptr) {
+      NGRAPH_DEBUG << "BatchNorm " << bn->get_name()
+                   << " follows a non-constant bias";
+      continue;
+    }
+    std::shared_ptr<Node> new_linear = scale_linear_op(linear, scale);
+    if (new_linear == nullptr) {
+      NGRAPH_DEBUG << "BatchNorm " << bn->get_name()
+                   << " follows non-constant weights";
+      continue;
+    }
+    NGRAPH_DEBUG << "Folding BatchNorm " << bn->get_name() << " into "
+                 << linear->get_name();
+    ngraph::replace_node(bn, std::make_shared<op::Add>(new_linear, new_bias));
+    modified = true;
+  }
+  return modified;
+}
@@ -0,0 +1,41 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include "ngraph/pass/pass.hpp"
+
+namespace ngraph {
+namespace he {
+namespace pass {
+
+/// \brief Folds BatchNormInference into the preceding Convolution or Dot, so
+/// the batch norm costs no ciphertext multiplication and no level.
+///
+/// Applies when gamma, beta, mean and variance are constants, and the batch
+/// norm input is a Convolution or Dot with constant weights, optionally
+/// followed by an Add of a constant bias. The weights of output channel c are
+/// scaled by s_c = gamma_c / sqrt(variance_c + eps), and the bias becomes
+/// s_c * (bias_c - mean_c) + beta_c. The linear op and bias must have no other
+/// users. Complements CoreFusion, which only folds into 2D convolutions
+/// without bias.
+class HEBatchNormFolding : public ngraph::pass::FunctionPass {
+ public:
+  bool run_on_function(std::shared_ptr<ngraph::Function> function) override;
+};
+}  // namespace pass
+}  // namespace he
+}  // namespace ngraph
@@ -0,0 +1,180 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+
+#include "ngraph/check.hpp"
+#include "ngraph/function.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/op/avg_pool.hpp"
+#include "ngraph/op/constant.hpp"
+#include "node_wrapper.hpp"
+#include "pass/he_depth_analysis.hpp"
+#include "seal/kernel/avg_pool_seal.hpp"
+
+namespace {
+bool is_zero_constant(const ngraph::Node* node) {
+  auto constant = dynamic_cast<const ngraph::op::Constant*>(node);
+  if (constant == nullptr ||
+      constant->get_element_type() != ngraph::element::f32) {
+    return false;
+  }
+  const std::vector<float> values = constant->get_vector<float>();
+  return std::all_of(values.begin(), values.end(),
+                     [](float f) { return f == 0.f; });
+}
+}  // namespace
+
+bool ngraph::he::pass::HEDepthAnalysis::run_on_function(
+    std::shared_ptr<ngraph::Function> function) {
+  m_cipher_nodes.clear();
+  m_depths.clear();
+  m_rescaled_nodes.clear();
+  m_segment_levels = {0};
+  m_combines_segments = false;
+
+  for (const std::shared_ptr<Node>& node_ptr : function->get_ordered_ops()) {
+    const Node* node = node_ptr.get();
+    const OP_TYPEID op_typeid = NodeWrapper(node_ptr).get_typeid();
+    if (op_typeid == OP_TYPEID::Parameter ||
+        (op_typeid == OP_TYPEID::Constant && m_encrypt_model)) {
+      m_cipher_nodes.insert(node);
+      m_depths[node] = Depth();
+      continue;
+    }
+
+    // Every other op produces a ciphertext if any input is one, and inherits
+    // the deepest input
+    Depth depth;
+    size_t cipher_input_count = 0;
+    bool zero_input = false;
+    int encoding_bits = -1;
+    for (const auto& input : node->inputs()) {
+      const Node* arg = input.get_source_output().get_node();
+      // The bias of BiasedConvolution and BiasedDot is no factor of the
+      // product
+      const bool factor = input.get_index() < 2;
+      // Encrypted constants are not known values
+      zero_input |= !m_encrypt_model && factor && is_zero_constant(arg);
+      if (!is_cipher(arg)) {
+        if (m_scale_planning != nullptr && factor) {
+          encoding_bits = m_scale_planning->encoding_bits(arg);
+        }
+        continue;
+      }
+      const Depth& arg_depth = m_depths[arg];
+      if (cipher_input_count > 0 && arg_depth.segment != depth.segment) {
+        m_combines_segments = true;
+      }
+      depth.segment = std::max(depth.segment, arg_depth.segment);
+      depth.rescalings = std::max(depth.rescalings, arg_depth.rescalings);
+      depth.unrescaled = std::max(depth.unrescaled, arg_depth.unrescaled);
+      depth.excess_bits = std::max(depth.excess_bits, arg_depth.excess_bits);
+      cipher_input_count++;
+    }
+    if (cipher_input_count == 0) {
+      continue;
+    }
+
+    switch (op_typeid) {
+      case OP_TYPEID::BiasedConvolution:
+      case OP_TYPEID::BiasedDot:
+      case OP_TYPEID::Convolution:
+      case OP_TYPEID::Dot:
+      case OP_TYPEID::Multiply:
+        if (zero_input) {
+          // Products with zero are known values
+          continue;
+        }
+        if (cipher_input_count > 1 && m_naive_rescaling) {
+          depth.unrescaled++;
+        } else if (encoding_bits >= 0) {
+          depth.excess_bits += encoding_bits;
+          if (depth.excess_bits >= m_scale_planning->scale_bits()) {
+            depth.excess_bits -= m_scale_planning->scale_bits();
+            depth.rescalings++;
+            m_rescaled_nodes.insert(node);
+          }
+        } else {
+          depth.rescalings++;
+          m_rescaled_nodes.insert(node);
+        }
+        break;
+      case OP_TYPEID::AvgPool: {
+        auto avg_pool = static_cast<const op::AvgPool*>(node);
+        if (!avg_pool_scale_division(
+                avg_pool->get_padding_below(), avg_pool->get_padding_above(),
+                avg_pool->get_include_padding_in_avg_computation())) {
+          depth.rescalings++;
+          m_rescaled_nodes.insert(node);
+        }
+        break;
+      }
+      case OP_TYPEID::BatchNormInference:
+        if (m_naive_rescaling) {
+          depth.rescalings++;
+        } else {
+          depth.unrescaled++;
+        }
+        break;
+      case OP_TYPEID::BoundedRelu:
+      case OP_TYPEID::Relu:
+        if (m_polynomial_activation.enabled()) {
+          depth.rescalings += m_polynomial_activation.depth();
+          break;
+        }
+        // Fall through
+      case OP_TYPEID::Exp:
+      case OP_TYPEID::MaxPool:
+      case OP_TYPEID::Sigmoid:
+      case OP_TYPEID::Softmax:
+      case OP_TYPEID::Tanh:
+        // The client returns fresh ciphertexts
+        depth.segment++;
+        depth.rescalings = 0;
+        depth.unrescaled = 0;
+        depth.excess_bits = 0;
+        break;
+      default:
+        break;
+    }
+    m_cipher_nodes.insert(node);
+    m_depths[node] = depth;
+    if (m_segment_levels.size() <= depth.segment) {
+      m_segment_levels.resize(depth.segment + 1, 0);
+    }
+    m_segment_levels[depth.segment] =
+        std::max(m_segment_levels[depth.segment],
+                 depth.rescalings + depth.unrescaled);
+  }
+  return false;
+}
+
+size_t ngraph::he::pass::HEDepthAnalysis::segment(const Node* node) const {
+  auto it = m_depths.find(node);
+  NGRAPH_CHECK(it != m_depths.end(), "No depth of ", node->get_name());
+  return it->second.segment;
+}
+
+size_t ngraph::he::pass::HEDepthAnalysis::levels(const Node* node) const {
+  auto it = m_depths.find(node);
+  NGRAPH_CHECK(it != m_depths.end(), "No depth of ", node->get_name());
+  return it->second.rescalings + it->second.unrescaled;
+}
+
+size_t ngraph::he::pass::HEDepthAnalysis::max_levels() const {
+  return *std::max_element(m_segment_levels.begin(), m_segment_levels.end());
+}
@@ -0,0 +1,118 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ngraph/pass/pass.hpp"
+#include "pass/he_scale_planning.hpp"
+#include "seal/polynomial_activation.hpp"
+
+namespace ngraph {
+namespace he {
+namespace pass {
+
+/// \brief Computes the multiplicative depth of the ciphertexts of a function,
+/// without modifying it.
+///
+/// Client round trips (e.g. Relu, MaxPool) return fresh ciphertexts and start
+/// a new segment. Within a segment, the levels of an op's output count the
+/// coefficient moduli its computation consumed since the segment started:
+/// - Ops rescaled after multiplying (lazy rescaling: AvgPool, Convolution,
+///   Dot, Multiply and their biased variants; naive rescaling: products with
+///   plaintexts) consume a chain index each.
+/// - Products left at the squared scale (lazy rescaling: BatchNormInference;
+///   naive rescaling: products of ciphertexts) consume no chain index, but the
+///   larger scale takes the bits of one modulus.
+/// - Polynomial activations consume their depth.
+/// - Scale divisions (ScaleDivision, AvgPool with equally sized windows)
+///   consume no chain index.
+/// - Products with all-zero constants are known values, not ciphertexts.
+/// - With scale_planning, products with planned constants grow the scale by
+///   their encoding bits, and consume a chain index only once the scale
+///   exceeds the fresh scale by a modulus of scale_bits bits.
+/// Parameters are assumed encrypted, constants only if encrypt_model.
+class HEDepthAnalysis : public ngraph::pass::FunctionPass {
+ public:
+  HEDepthAnalysis(
+      bool encrypt_model, bool naive_rescaling,
+      const PolynomialActivation& polynomial_activation,
+      std::shared_ptr<const HEScalePlanning> scale_planning = nullptr)
+      : m_encrypt_model(encrypt_model),
+        m_naive_rescaling(naive_rescaling),
+        m_polynomial_activation(polynomial_activation),
+        m_scale_planning(std::move(scale_planning)) {}
+
+  bool run_on_function(std::shared_ptr<ngraph::Function> function) override;
+
+  /// \brief Returns the ops whose outputs are ciphertexts
+  const std::unordered_set<const Node*>& cipher_nodes() const {
+    return m_cipher_nodes;
+  }
+
+  bool is_cipher(const Node* node) const {
+    return m_cipher_nodes.find(node) != m_cipher_nodes.end();
+  }
+
+  /// \brief Returns the number of client round trips preceding node
+  size_t segment(const Node* node) const;
+
+  /// \brief Returns the levels the output of node consumed within its segment
+  size_t levels(const Node* node) const;
+
+  /// \brief Returns the largest number of levels of each segment
+  const std::vector<size_t>& segment_levels() const { return m_segment_levels; }
+
+  /// \brief Returns the largest number of levels over all segments
+  size_t max_levels() const;
+
+  /// \brief Returns true if lazy rescaling consumes a chain index after the
+  /// product computed by node, e.g. a Dot with a plaintext
+  bool rescales(const Node* node) const {
+    return m_rescaled_nodes.find(node) != m_rescaled_nodes.end();
+  }
+
+  /// \brief Returns true if an op combines ciphertexts of different segments,
+  /// e.g. a residual connection around a client round trip
+  bool combines_segments() const { return m_combines_segments; }
+
+ private:
+  struct Depth {
+    size_t segment{0};
+    size_t rescalings{0};
+    size_t unrescaled{0};
+    // Bits of the scale above the fresh scale, from planned plaintext scales
+    int excess_bits{0};
+  };
+
+  bool m_encrypt_model;
+  bool m_naive_rescaling;
+  PolynomialActivation m_polynomial_activation;
+  std::shared_ptr<const HEScalePlanning> m_scale_planning;
+
+  std::unordered_set<const Node*> m_cipher_nodes;
+  std::unordered_map<const Node*, Depth> m_depths;
+  std::unordered_set<const Node*> m_rescaled_nodes;
+  std::vector<size_t> m_segment_levels;
+  bool m_combines_segments{false};
+};
+}  // namespace pass
+}  // namespace he
+}  // namespace ngraph
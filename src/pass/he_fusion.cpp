@@ -14,14 +14,24 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include "ngraph/builder/make_constant.hpp"
+#include "ngraph/op/add.hpp"
+#include "ngraph/op/broadcast.hpp"
+#include "ngraph/op/convolution.hpp"
+#include "ngraph/op/dot.hpp"
 #include "ngraph/op/minimum.hpp"
+#include "ngraph/op/multiply.hpp"
 #include "ngraph/op/relu.hpp"
 #include "ngraph/pattern/matcher.hpp"
 #include "ngraph/pattern/op/label.hpp"
 #include "ngraph/runtime/cpu/op/bounded_relu.hpp"
+#include "op/biased_convolution.hpp"
+#include "op/biased_dot.hpp"
+#include "op/scale_division.hpp"
 #include "pass/he_fusion.hpp"
 
 void ngraph::he::pass::HEFusion::construct_bounded_relu() {
@@ -80,3 +90,105 @@ void ngraph::he::pass::HEFusion::construct_bounded_relu() {
   auto m = std::make_shared<pattern::Matcher>(min, "BoundedRelu");
   this->add_matcher(m, callback);
 }
+
+void ngraph::he::pass::HEFusion::construct_scale_division() {
+  auto input = std::make_shared<pattern::op::Label>(element::f32, Shape{});
+  auto constant_pred = [](std::shared_ptr<Node> n) {
+    return (std::dynamic_pointer_cast<ngraph::op::Constant>(n) != nullptr);
+  };
+  auto inverse_divisor = std::make_shared<pattern::op::Label>(
+      element::f32, Shape{}, constant_pred);
+  auto multiply =
+      std::make_shared<ngraph::op::Multiply>(input, inverse_divisor);
+
+  auto callback = [input, inverse_divisor](pattern::Matcher& m) {
+    NGRAPH_DEBUG << "In a callback for construct_scale_division against "
+                 << m.get_match_root()->get_name();
+
+    auto pattern_map = m.get_pattern_map();
+    auto constant = std::static_pointer_cast<ngraph::op::Constant>(
+        pattern_map[inverse_divisor]);
+    if (constant->get_element_type() != element::f32) {
+      NGRAPH_DEBUG << "Constant type is not float";
+      return false;
+    }
+    const std::vector<float> values = constant->get_vector<float>();
+    if (values.empty() || values[0] <= 0 ||
+        !std::all_of(values.begin(), values.end(),
+                     [&values](float f) { return f == values[0]; })) {
+      NGRAPH_DEBUG << "Constant is not uniform and positive";
+      return false;
+    }
+    const double divisor = 1.0 / values[0];
+    const double rounded_divisor = std::round(divisor);
+    if (rounded_divisor < 2 ||
+        std::abs(divisor - rounded_divisor) > 1e-4 * rounded_divisor) {
+      NGRAPH_DEBUG << "Constant " << values[0]
+                   << " is not the inverse of an integer";
+      return false;
+    }
+
+    auto scale_division = std::make_shared<ngraph::op::ScaleDivision>(
+        pattern_map[input], static_cast<size_t>(rounded_divisor));
+    ngraph::replace_node(m.get_match_root(), scale_division);
+    return true;
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(multiply, "ScaleDivision");
+  this->add_matcher(m, callback);
+}
+
+void ngraph::he::pass::HEBiasFusion::construct_biased_linear() {
+  auto linear = std::make_shared<pattern::op::Label>(element::f32, Shape{});
+  auto bias = std::make_shared<pattern::op::Label>(element::f32, Shape{});
+  auto add = std::make_shared<ngraph::op::Add>(linear, bias);
+
+  // Returns true if node is a Constant or a Broadcast of a Constant, which
+  // are plaintexts unless the model is encrypted
+  auto is_plaintext_bias = [](const std::shared_ptr<Node>& node) {
+    if (node->is_constant()) {
+      return true;
+    }
+    return std::dynamic_pointer_cast<ngraph::op::Broadcast>(node) != nullptr &&
+           node->get_argument(0)->is_constant();
+  };
+
+  auto callback = [is_plaintext_bias](pattern::Matcher& m) {
+    NGRAPH_DEBUG << "In a callback for construct_biased_linear against "
+                 << m.get_match_root()->get_name();
+
+    auto add_node = m.get_match_root();
+    if (add_node->get_element_type() != element::f32) {
+      NGRAPH_DEBUG << "Add type is not float";
+      return false;
+    }
+    // Add is commutative, so the bias may be either argument
+    for (size_t bias_idx = 0; bias_idx < 2; ++bias_idx) {
+      std::shared_ptr<Node> bias_node = add_node->get_argument(bias_idx);
+      std::shared_ptr<Node> linear_node = add_node->get_argument(1 - bias_idx);
+      if (!is_plaintext_bias(bias_node) ||
+          linear_node->get_users().size() != 1) {
+        continue;
+      }
+      std::shared_ptr<Node> biased_linear;
+      if (auto convolution =
+              std::dynamic_pointer_cast<ngraph::op::Convolution>(
+                  linear_node)) {
+        biased_linear = std::make_shared<ngraph::op::BiasedConvolution>(
+            convolution, bias_node);
+      } else if (auto dot = std::dynamic_pointer_cast<ngraph::op::Dot>(
+                     linear_node)) {
+        biased_linear = std::make_shared<ngraph::op::BiasedDot>(dot, bias_node);
+      } else {
+        continue;
+      }
+      ngraph::replace_node(add_node, biased_linear);
+      return true;
+    }
+    NGRAPH_DEBUG << "Add is not of a Convolution or Dot and a plaintext bias";
+    return false;
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(add, "BiasedLinear");
+  this->add_matcher(m, callback);
+}
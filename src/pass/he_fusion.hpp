@@ -24,9 +24,31 @@ namespace pass {
 
 class HEFusion : public ngraph::pass::GraphRewrite {
  public:
-  HEFusion() : GraphRewrite() { construct_bounded_relu(); }
+  HEFusion() : GraphRewrite() {
+    construct_bounded_relu();
+    construct_scale_division();
+  }
 
   void construct_bounded_relu();
+
+  /// \brief Replaces multiplication by a uniform constant 1 / k, for an
+  /// integer k >= 2, by ScaleDivision by k
+  void construct_scale_division();
+};
+
+/// \brief Fuses Convolution and Dot ops into a following Add of a plaintext
+/// bias, i.e. a Constant or a Broadcast of a Constant, so their kernels add
+/// the bias to each output in their epilogue. Runs after the passes which
+/// fold ops into Convolution and Dot followed by a bias Add, e.g.
+/// HEBatchNormFolding and HELinearComposition.
+class HEBiasFusion : public ngraph::pass::GraphRewrite {
+ public:
+  HEBiasFusion() : GraphRewrite() { construct_biased_linear(); }
+
+  /// \brief Replaces Add(Convolution, bias) by BiasedConvolution and
+  /// Add(Dot, bias) by BiasedDot, if the bias is a plaintext and the
+  /// Convolution or Dot has no other users
+  void construct_biased_linear();
 };
 }  // namespace pass
 }  // namespace he
@@ -0,0 +1,418 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "ngraph/coordinate_transform.hpp"
+#include "ngraph/function.hpp"
+#include "ngraph/graph_util.hpp"
+#include "ngraph/log.hpp"
+#include "ngraph/op/add.hpp"
+#include "ngraph/op/avg_pool.hpp"
+#include "ngraph/op/broadcast.hpp"
+#include "ngraph/op/constant.hpp"
+#include "ngraph/op/convolution.hpp"
+#include "ngraph/op/dot.hpp"
+#include "ngraph/op/reshape.hpp"
+#include "pass/he_linear_composition.hpp"
+
+namespace {
+std::shared_ptr<ngraph::op::Constant> as_f32_constant(
+    const std::shared_ptr<ngraph::Node>& node) {
+  auto constant = std::dynamic_pointer_cast<ngraph::op::Constant>(node);
+  if (constant == nullptr ||
+      constant->get_element_type() != ngraph::element::f32) {
+    return nullptr;
+  }
+  return constant;
+}
+
+bool is_single_user(const std::shared_ptr<ngraph::Node>& node) {
+  return node->get_users().size() == 1;
+}
+
+template <typename T>
+bool all_equal(const T& values, size_t value) {
+  return std::all_of(values.begin(), values.end(),
+                     [value](size_t v) { return v == value; });
+}
+
+ngraph::AxisSet all_axes_but(size_t rank, size_t axis) {
+  ngraph::AxisSet axes;
+  for (size_t i = 0; i < rank; ++i) {
+    if (i != axis) {
+      axes.insert(i);
+    }
+  }
+  return axes;
+}
+
+// Returns the op of type T which node is, or which node adds a bias to. In
+// the latter case, sets bias to the other argument of the Add
+template <typename T>
+std::shared_ptr<T> match_biased(const std::shared_ptr<ngraph::Node>& node,
+                                std::shared_ptr<ngraph::Node>& bias) {
+  bias = nullptr;
+  if (std::dynamic_pointer_cast<ngraph::op::Add>(node) == nullptr) {
+    return std::dynamic_pointer_cast<T>(node);
+  }
+  if (!is_single_user(node)) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < 2; ++i) {
+    auto op = std::dynamic_pointer_cast<T>(node->get_argument(i));
+    if (op != nullptr) {
+      bias = node->get_argument(1 - i);
+      return op;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the values of bias if it is a Broadcast of a constant along axis of
+// shape, or an empty vector otherwise
+std::vector<float> broadcast_bias(const std::shared_ptr<ngraph::Node>& bias,
+                                  const ngraph::Shape& shape, size_t axis) {
+  auto broadcast = std::dynamic_pointer_cast<ngraph::op::Broadcast>(bias);
+  if (broadcast == nullptr ||
+      broadcast->get_broadcast_axes() != all_axes_but(shape.size(), axis)) {
+    return {};
+  }
+  auto constant = as_f32_constant(broadcast->get_argument(0));
+  if (constant == nullptr) {
+    return {};
+  }
+  return constant->get_vector<float>();
+}
+
+// Returns the constant matrix of weights of dot, or nullptr
+std::shared_ptr<ngraph::op::Constant> dot_weights(
+    const std::shared_ptr<ngraph::op::Dot>& dot) {
+  if (dot->get_reduction_axes_count() != 1) {
+    return nullptr;
+  }
+  auto weights = as_f32_constant(dot->get_argument(1));
+  if (weights == nullptr || weights->get_shape().size() != 2) {
+    return nullptr;
+  }
+  return weights;
+}
+
+// Returns the product of the row-major matrices lhs and rhs, where rhs has
+// inner rows and cols columns
+std::vector<float> matrix_product(const std::vector<float>& lhs,
+                                  const std::vector<float>& rhs, size_t inner,
+                                  size_t cols) {
+  const size_t rows = lhs.size() / inner;
+  std::vector<double> out(rows * cols, 0);
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t k = 0; k < inner; ++k) {
+      const double lhs_val = lhs[r * inner + k];
+      if (lhs_val == 0) {
+        continue;
+      }
+      for (size_t c = 0; c < cols; ++c) {
+        out[r * cols + c] += lhs_val * rhs[k * cols + c];
+      }
+    }
+  }
+  return std::vector<float>(out.begin(), out.end());
+}
+
+// Dot(Dot(x, W1) [+ bias], W2) => Dot(x, W1 W2) [+ bias W2]
+bool compose_dot_dot(const std::shared_ptr<ngraph::Node>& node) {
+  auto dot = std::dynamic_pointer_cast<ngraph::op::Dot>(node);
+  if (dot == nullptr) {
+    return false;
+  }
+  auto weights = dot_weights(dot);
+  std::shared_ptr<ngraph::Node> bias;
+  auto inner_dot = match_biased<ngraph::op::Dot>(dot->get_argument(0), bias);
+  if (weights == nullptr || inner_dot == nullptr ||
+      !is_single_user(inner_dot)) {
+    return false;
+  }
+  auto inner_weights = dot_weights(inner_dot);
+  if (inner_weights == nullptr) {
+    return false;
+  }
+
+  const size_t in_size = inner_weights->get_shape()[0];
+  const size_t mid_size = inner_weights->get_shape()[1];
+  const size_t out_size = weights->get_shape()[1];
+  // Multiplications per row of x
+  if (in_size * out_size > in_size * mid_size + mid_size * out_size) {
+    return false;
+  }
+
+  const std::vector<float> weight_vals = weights->get_vector<float>();
+  const ngraph::Shape& inner_shape = inner_dot->get_shape();
+  const ngraph::Shape& out_shape = dot->get_shape();
+  std::shared_ptr<ngraph::Node> composed_bias;
+  if (bias != nullptr) {
+    auto bias_constant = as_f32_constant(bias);
+    std::vector<float> bias_vals =
+        broadcast_bias(bias, inner_shape, inner_shape.size() - 1);
+    if (bias_constant != nullptr && bias_constant->get_shape() == inner_shape) {
+      composed_bias = ngraph::op::Constant::create(
+          ngraph::element::f32, out_shape,
+          matrix_product(bias_constant->get_vector<float>(), weight_vals,
+                         mid_size, out_size));
+    } else if (!bias_vals.empty()) {
+      auto bias_product = ngraph::op::Constant::create(
+          ngraph::element::f32, ngraph::Shape{out_size},
+          matrix_product(bias_vals, weight_vals, mid_size, out_size));
+      composed_bias = std::make_shared<ngraph::op::Broadcast>(
+          bias_product, out_shape,
+          all_axes_but(out_shape.size(), out_shape.size() - 1));
+    } else {
+      return false;
+    }
+  }
+
+  auto composed_weights = ngraph::op::Constant::create(
+      ngraph::element::f32, ngraph::Shape{in_size, out_size},
+      matrix_product(inner_weights->get_vector<float>(), weight_vals,
+                     mid_size, out_size));
+  std::shared_ptr<ngraph::Node> composed = std::make_shared<ngraph::op::Dot>(
+      inner_dot->get_argument(0), composed_weights);
+  if (composed_bias != nullptr) {
+    composed = std::make_shared<ngraph::op::Add>(composed, composed_bias);
+  }
+  NGRAPH_DEBUG << "Composing " << inner_dot->get_name() << " and "
+               << dot->get_name();
+  ngraph::replace_node(dot, composed);
+  return true;
+}
+
+// AvgPool(Convolution(x, F) [+ bias]) => Convolution(x, F') [+ bias], where
+// F' averages F over the pooling window, shifted by the convolution stride
+bool compose_avg_pool_conv(const std::shared_ptr<ngraph::Node>& node) {
+  auto avg_pool = std::dynamic_pointer_cast<ngraph::op::AvgPool>(node);
+  if (avg_pool == nullptr || !all_equal(avg_pool->get_padding_below(), 0) ||
+      !all_equal(avg_pool->get_padding_above(), 0)) {
+    return false;
+  }
+  std::shared_ptr<ngraph::Node> bias;
+  auto conv =
+      match_biased<ngraph::op::Convolution>(avg_pool->get_argument(0), bias);
+  if (conv == nullptr || !is_single_user(conv) ||
+      !all_equal(conv->get_window_dilation_strides(), 1) ||
+      !all_equal(conv->get_data_dilation_strides(), 1)) {
+    return false;
+  }
+  auto filters = as_f32_constant(conv->get_argument(1));
+  if (filters == nullptr) {
+    return false;
+  }
+  std::vector<float> bias_vals;
+  if (bias != nullptr) {
+    bias_vals = broadcast_bias(bias, conv->get_shape(), 1);
+    if (bias_vals.empty()) {
+      return false;
+    }
+  }
+
+  const ngraph::Shape& filter_shape = filters->get_shape();
+  const ngraph::Shape& window_shape = avg_pool->get_window_shape();
+  const ngraph::Strides& conv_strides = conv->get_window_movement_strides();
+  const ngraph::Strides& pool_strides =
+      avg_pool->get_window_movement_strides();
+  ngraph::Shape composed_filter_shape{filter_shape[0], filter_shape[1]};
+  ngraph::Strides composed_strides;
+  for (size_t d = 0; d < window_shape.size(); ++d) {
+    composed_filter_shape.emplace_back(filter_shape[2 + d] +
+                                       (window_shape[d] - 1) * conv_strides[d]);
+    composed_strides.emplace_back(conv_strides[d] * pool_strides[d]);
+  }
+
+  // Multiplications per pair of input and output channels, including the
+  // division by the window size
+  auto spatial_size = [](const ngraph::Shape& shape) {
+    return ngraph::shape_size(shape) / (shape[0] * shape[1]);
+  };
+  const size_t conv_mults =
+      spatial_size(conv->get_shape()) * spatial_size(filter_shape);
+  const size_t pool_size = spatial_size(avg_pool->get_shape());
+  const size_t composed_mults = pool_size * spatial_size(composed_filter_shape);
+  if (composed_mults > conv_mults + pool_size) {
+    return false;
+  }
+
+  const std::vector<float> filter_vals = filters->get_vector<float>();
+  const double window_size = ngraph::shape_size(window_shape);
+  std::vector<double> composed_vals(ngraph::shape_size(composed_filter_shape),
+                                    0);
+  ngraph::CoordinateTransform filter_transform(filter_shape);
+  ngraph::CoordinateTransform window_transform(window_shape);
+  ngraph::CoordinateTransform composed_transform(composed_filter_shape);
+  for (const ngraph::Coordinate& filter_coord : filter_transform) {
+    const double value = filter_vals[filter_transform.index(filter_coord)];
+    if (value == 0) {
+      continue;
+    }
+    for (const ngraph::Coordinate& window_coord : window_transform) {
+      ngraph::Coordinate composed_coord = filter_coord;
+      for (size_t d = 0; d < window_coord.size(); ++d) {
+        composed_coord[2 + d] += window_coord[d] * conv_strides[d];
+      }
+      composed_vals[composed_transform.index(composed_coord)] +=
+          value / window_size;
+    }
+  }
+
+  auto composed_filters = ngraph::op::Constant::create(
+      ngraph::element::f32, composed_filter_shape,
+      std::vector<float>(composed_vals.begin(), composed_vals.end()));
+  std::shared_ptr<ngraph::Node> composed =
+      std::make_shared<ngraph::op::Convolution>(
+          conv->get_argument(0), composed_filters, composed_strides,
+          conv->get_window_dilation_strides(), conv->get_padding_below(),
+          conv->get_padding_above(), conv->get_data_dilation_strides());
+  if (composed->get_shape() != avg_pool->get_shape()) {
+    return false;
+  }
+  if (!bias_vals.empty()) {
+    // Averaging a per-channel bias leaves it unchanged
+    auto bias_constant = ngraph::op::Constant::create(
+        ngraph::element::f32, ngraph::Shape{bias_vals.size()}, bias_vals);
+    composed = std::make_shared<ngraph::op::Add>(
+        composed, std::make_shared<ngraph::op::Broadcast>(
+                      bias_constant, avg_pool->get_shape(),
+                      all_axes_but(avg_pool->get_shape().size(), 1)));
+  }
+  NGRAPH_DEBUG << "Composing " << conv->get_name() << " and "
+               << avg_pool->get_name();
+  ngraph::replace_node(avg_pool, composed);
+  return true;
+}
+
+// Dot(Reshape(Convolution(x, F)), W) => Dot(Reshape(x), W'), where W' is the
+// matrix of the composed map
+bool compose_conv_reshape_dot(const std::shared_ptr<ngraph::Node>& node) {
+  auto dot = std::dynamic_pointer_cast<ngraph::op::Dot>(node);
+  if (dot == nullptr) {
+    return false;
+  }
+  auto weights = dot_weights(dot);
+  auto reshape =
+      std::dynamic_pointer_cast<ngraph::op::Reshape>(dot->get_argument(0));
+  if (weights == nullptr || reshape == nullptr || !is_single_user(reshape) ||
+      reshape->get_is_transpose()) {
+    return false;
+  }
+  auto conv = std::dynamic_pointer_cast<ngraph::op::Convolution>(
+      reshape->get_argument(0));
+  if (conv == nullptr || !is_single_user(conv) ||
+      !all_equal(conv->get_window_dilation_strides(), 1) ||
+      !all_equal(conv->get_data_dilation_strides(), 1)) {
+    return false;
+  }
+  auto filters = as_f32_constant(conv->get_argument(1));
+  if (filters == nullptr) {
+    return false;
+  }
+
+  const std::shared_ptr<ngraph::Node> input = conv->get_argument(0);
+  const ngraph::Shape& in_shape = input->get_shape();
+  const ngraph::Shape& conv_shape = conv->get_shape();
+  const size_t batch_size = conv_shape[0];
+  const size_t in_size = ngraph::shape_size(in_shape) / batch_size;
+  const size_t mid_size = ngraph::shape_size(conv_shape) / batch_size;
+  const size_t out_size = weights->get_shape()[1];
+  if (reshape->get_shape() != ngraph::Shape{batch_size, mid_size}) {
+    return false;
+  }
+  const ngraph::Shape& filter_shape = filters->get_shape();
+  const size_t filter_size = ngraph::shape_size(filter_shape) / filter_shape[0];
+  // Multiplications per batch
+  if (in_size * out_size > mid_size * filter_size + mid_size * out_size) {
+    return false;
+  }
+
+  // Each item of the batch is mapped independently
+  const ngraph::Shape in_item_shape(in_shape.begin() + 1, in_shape.end());
+  const ngraph::Shape conv_item_shape(conv_shape.begin() + 1, conv_shape.end());
+  const ngraph::Shape tap_shape(filter_shape.begin() + 1, filter_shape.end());
+  ngraph::CoordinateTransform in_transform(in_item_shape);
+  ngraph::CoordinateTransform conv_transform(conv_item_shape);
+  ngraph::CoordinateTransform tap_transform(tap_shape);
+  const ngraph::Strides& strides = conv->get_window_movement_strides();
+  const ngraph::CoordinateDiff& padding_below = conv->get_padding_below();
+
+  const std::vector<float> filter_vals = filters->get_vector<float>();
+  const std::vector<float> weight_vals = weights->get_vector<float>();
+  std::vector<double> composed_vals(in_size * out_size, 0);
+  for (const ngraph::Coordinate& conv_coord : conv_transform) {
+    const size_t mid_index = conv_transform.index(conv_coord);
+    const size_t out_channel = conv_coord[0];
+    for (const ngraph::Coordinate& tap : tap_transform) {
+      const double filter_val =
+          filter_vals[out_channel * filter_size + tap_transform.index(tap)];
+      if (filter_val == 0) {
+        continue;
+      }
+      // Taps in the padding contribute zero
+      ngraph::Coordinate in_coord{tap[0]};
+      bool in_bounds = true;
+      for (size_t d = 1; d < tap.size() && in_bounds; ++d) {
+        std::ptrdiff_t pos = static_cast<std::ptrdiff_t>(
+                                 conv_coord[d] * strides[d - 1] + tap[d]) -
+                             padding_below[d - 1];
+        in_bounds = pos >= 0 && static_cast<size_t>(pos) < in_item_shape[d];
+        in_coord.emplace_back(pos);
+      }
+      if (!in_bounds) {
+        continue;
+      }
+      const size_t in_index = in_transform.index(in_coord);
+      for (size_t m = 0; m < out_size; ++m) {
+        composed_vals[in_index * out_size + m] +=
+            filter_val * weight_vals[mid_index * out_size + m];
+      }
+    }
+  }
+
+  ngraph::AxisVector input_order(in_shape.size());
+  std::iota(input_order.begin(), input_order.end(), 0);
+  auto flat_input = std::make_shared<ngraph::op::Reshape>(
+      input, input_order, ngraph::Shape{batch_size, in_size});
+  auto composed_weights = ngraph::op::Constant::create(
+      ngraph::element::f32, ngraph::Shape{in_size, out_size},
+      std::vector<float>(composed_vals.begin(), composed_vals.end()));
+  NGRAPH_DEBUG << "Composing " << conv->get_name() << " and "
+               << dot->get_name();
+  ngraph::replace_node(
+      dot, std::make_shared<ngraph::op::Dot>(flat_input, composed_weights));
+  return true;
+}
+}  // namespace
+
+bool ngraph::he::pass::HELinearComposition::run_on_function(
+    std::shared_ptr<ngraph::Function> function) {
+  bool modified = false;
+  // Ops are visited in topological order, so chains of more than two linear
+  // ops are composed pairwise from the input
+  for (const std::shared_ptr<Node>& node : function->get_ordered_ops()) {
+    modified |= compose_dot_dot(node) || compose_avg_pool_conv(node) ||
+                compose_conv_reshape_dot(node);
+  }
+  return modified;
+}
@@ -0,0 +1,44 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include "ngraph/pass/pass.hpp"
+
+namespace ngraph {
+namespace he {
+namespace pass {
+
+/// \brief Composes adjacent linear ops with constant weights into a single
+/// linear op, which consumes one level and one pass over the ciphertexts
+/// instead of two:
+/// - Dot(Dot(x, W1) [+ bias], W2) becomes Dot(x, W1 W2) [+ bias W2]
+/// - AvgPool(Convolution(x, F) [+ bias]) becomes a Convolution of x whose
+///   filter averages F over the pooling window, with the pooling stride
+///   folded into the convolution stride
+/// - Dot(Reshape(Convolution(x, F)), W) becomes Dot(Reshape(x), W'), where W'
+///   is the matrix of the composed map
+/// Biases must be constants, or broadcasts of constants along the channel
+/// axis. Intermediate ops must have no other users. The ops are only composed
+/// if the composed op needs no more ciphertext-plaintext multiplications
+/// than the ops it replaces.
+class HELinearComposition : public ngraph::pass::FunctionPass {
+ public:
+  bool run_on_function(std::shared_ptr<ngraph::Function> function) override;
+};
+}  // namespace pass
+}  // namespace he
+}  // namespace ngraph
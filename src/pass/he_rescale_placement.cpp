@@ -0,0 +1,119 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <list>
+#include <unordered_map>
+
+#include "ngraph/function.hpp"
+#include "ngraph/node.hpp"
+#include "node_wrapper.hpp"
+#include "pass/he_rescale_placement.hpp"
+
+namespace {
+// Ops which rescale the sum of their unrescaled arguments in their epilogue
+bool combines_unrescaled(ngraph::he::OP_TYPEID op_typeid) {
+  return op_typeid == ngraph::he::OP_TYPEID::Add ||
+         op_typeid == ngraph::he::OP_TYPEID::Subtract;
+}
+
+// Ops which pass unrescaled arguments through, without a rescaling epilogue
+bool forwards_unrescaled(ngraph::he::OP_TYPEID op_typeid) {
+  return op_typeid == ngraph::he::OP_TYPEID::Negate ||
+         op_typeid == ngraph::he::OP_TYPEID::Reshape ||
+         op_typeid == ngraph::he::OP_TYPEID::Slice;
+}
+}  // namespace
+
+bool ngraph::he::pass::HERescalePlacement::run_on_function(
+    std::shared_ptr<ngraph::Function> function) {
+  m_rescaled_nodes.clear();
+  const std::list<std::shared_ptr<Node>> ops = function->get_ordered_ops();
+
+  // Start by deferring every rescale, then undefer the ops whose users need
+  // rescaled ciphertexts until the deferred ops are consistent
+  std::unordered_map<const Node*, OP_TYPEID> op_typeids;
+  std::unordered_set<const Node*> deferred;
+  for (const std::shared_ptr<Node>& node : ops) {
+    const OP_TYPEID op_typeid = NodeWrapper(node).get_typeid();
+    op_typeids[node.get()] = op_typeid;
+    if (m_depth_analysis->rescales(node.get()) ||
+        (m_depth_analysis->is_cipher(node.get()) &&
+         (combines_unrescaled(op_typeid) || forwards_unrescaled(op_typeid)))) {
+      deferred.insert(node.get());
+    }
+  }
+  auto is_deferred = [&deferred](const Node* node) {
+    return deferred.find(node) != deferred.end();
+  };
+
+  // Returns true if all ciphertext arguments of node are unrescaled
+  auto unrescaled_arguments = [this, &is_deferred](const Node* node) {
+    bool cipher_argument = false;
+    for (const auto& input : node->inputs()) {
+      const Node* arg = input.get_source_output().get_node();
+      if (!m_depth_analysis->is_cipher(arg)) {
+        continue;
+      }
+      if (!is_deferred(arg)) {
+        return false;
+      }
+      cipher_argument = true;
+    }
+    return cipher_argument;
+  };
+
+  auto accepts_unrescaled = [&](const Node* user) {
+    auto it = op_typeids.find(user);
+    if (it == op_typeids.end()) {
+      return false;
+    }
+    if (combines_unrescaled(it->second)) {
+      return unrescaled_arguments(user);
+    }
+    return forwards_unrescaled(it->second) && is_deferred(user);
+  };
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = ops.rbegin(); it != ops.rend(); ++it) {
+      const Node* node = it->get();
+      if (!is_deferred(node)) {
+        continue;
+      }
+      const NodeVector users = (*it)->get_users();
+      bool defer =
+          m_depth_analysis->rescales(node) || unrescaled_arguments(node);
+      defer = defer && users.size() == 1 && accepts_unrescaled(users[0].get());
+      if (!defer) {
+        deferred.erase(node);
+        changed = true;
+      }
+    }
+  }
+
+  for (const std::shared_ptr<Node>& node : ops) {
+    if (is_deferred(node.get())) {
+      continue;
+    }
+    if (m_depth_analysis->rescales(node.get()) ||
+        (combines_unrescaled(op_typeids[node.get()]) &&
+         unrescaled_arguments(node.get()))) {
+      m_rescaled_nodes.insert(node.get());
+    }
+  }
+  return false;
+}
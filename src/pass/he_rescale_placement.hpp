@@ -0,0 +1,66 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <unordered_set>
+
+#include "ngraph/pass/pass.hpp"
+#include "pass/he_depth_analysis.hpp"
+
+namespace ngraph {
+namespace he {
+namespace pass {
+
+/// \brief Decides statically after which ops ciphertexts are rescaled, without
+/// modifying the function. Kernels of the marked ops rescale each output
+/// ciphertext in their epilogue.
+///
+/// Products which consume a chain index (see HEDepthAnalysis::rescales) are
+/// not rescaled immediately if their only user can take the unrescaled
+/// ciphertexts instead:
+/// - Add and Subtract, if all their ciphertext arguments are unrescaled
+///   products, so their scales and chain indices match. They rescale the sum
+///   once instead of each argument.
+/// - Reshape, Negate and Slice, if their own output is deferred in turn.
+/// Any other user, e.g. a product, a client round trip or a Result, needs the
+/// rescaled ciphertexts. Deferring past an op with several users would repeat
+/// the rescale in each of them.
+class HERescalePlacement : public ngraph::pass::FunctionPass {
+ public:
+  HERescalePlacement(std::shared_ptr<const HEDepthAnalysis> depth_analysis)
+      : m_depth_analysis(std::move(depth_analysis)) {}
+
+  bool run_on_function(std::shared_ptr<ngraph::Function> function) override;
+
+  /// \brief Returns true if the kernel of node rescales its output
+  bool rescales(const Node* node) const {
+    return m_rescaled_nodes.find(node) != m_rescaled_nodes.end();
+  }
+
+  /// \brief Returns the ops whose kernels rescale their outputs
+  const std::unordered_set<const Node*>& rescaled_nodes() const {
+    return m_rescaled_nodes;
+  }
+
+ private:
+  std::shared_ptr<const HEDepthAnalysis> m_depth_analysis;
+  std::unordered_set<const Node*> m_rescaled_nodes;
+};
+}  // namespace pass
+}  // namespace he
+}  // namespace ngraph
@@ -0,0 +1,84 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ngraph/function.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/op/constant.hpp"
+#include "node_wrapper.hpp"
+#include "pass/he_scale_planning.hpp"
+
+namespace {
+bool multiplies_ciphertexts(const ngraph::Node& node) {
+  for (const std::shared_ptr<ngraph::Node>& user : node.get_users()) {
+    switch (ngraph::he::NodeWrapper(user).get_typeid()) {
+      case ngraph::he::OP_TYPEID::Convolution:
+      case ngraph::he::OP_TYPEID::Dot:
+      case ngraph::he::OP_TYPEID::Multiply:
+        return true;
+      case ngraph::he::OP_TYPEID::BiasedConvolution:
+      case ngraph::he::OP_TYPEID::BiasedDot:
+        // The bias is added, not multiplied
+        for (size_t i = 0; i < 2; ++i) {
+          if (user->input(i).get_source_output().get_node() == &node) {
+            return true;
+          }
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+bool ngraph::he::pass::HEScalePlanning::run_on_function(
+    std::shared_ptr<ngraph::Function> function) {
+  m_encoding_bits.clear();
+  for (const std::shared_ptr<Node>& node : function->get_ordered_ops()) {
+    auto constant = std::dynamic_pointer_cast<op::Constant>(node);
+    if (constant == nullptr || constant->get_element_type() != element::f32 ||
+        !multiplies_ciphertexts(*constant)) {
+      continue;
+    }
+    float max_abs = 0;
+    for (float f : constant->get_vector<float>()) {
+      max_abs = std::max(max_abs, std::abs(f));
+    }
+    if (max_abs == 0) {
+      // Products with zero are known values
+      continue;
+    }
+    const int bits = m_precision_bits - std::ilogb(max_abs);
+    m_encoding_bits[node.get()] = std::min(std::max(bits, 0), m_scale_bits);
+  }
+  return false;
+}
+
+int ngraph::he::pass::HEScalePlanning::encoding_bits(const Node* node) const {
+  auto it = m_encoding_bits.find(node);
+  return it == m_encoding_bits.end() ? -1 : it->second;
+}
+
+double ngraph::he::pass::HEScalePlanning::encoding_scale(
+    const Node* node) const {
+  const int bits = encoding_bits(node);
+  return bits < 0 ? 0 : std::ldexp(1., bits);
+}
@@ -0,0 +1,65 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <unordered_map>
+
+#include "ngraph/pass/pass.hpp"
+
+namespace ngraph {
+namespace he {
+namespace pass {
+
+/// \brief Plans the scale at which each constant weight tensor is encoded
+/// when it multiplies a ciphertext, without modifying the function.
+///
+/// By default plaintexts are encoded at the scale of the ciphertext, so each
+/// product is rescaled by a full coefficient modulus. Instead, a tensor whose
+/// largest absolute value is in [2^e, 2^(e + 1)) is encoded at the power of
+/// two 2^(precision_bits - e), clamped to [1, 2^scale_bits], which keeps
+/// precision_bits bits of its largest weight. Products then grow the scale by
+/// fewer bits than a modulus, and HEDepthAnalysis only rescales them once the
+/// rescaled scale is still at least 2^scale_bits. Several layers share a
+/// modulus, so the function needs a shorter modulus chain. Powers of two keep
+/// the scales of different products in exact ratio, so they can be lifted to
+/// a common scale.
+/// Encrypted constants (encrypt_model) are not planned.
+class HEScalePlanning : public ngraph::pass::FunctionPass {
+ public:
+  HEScalePlanning(int precision_bits, int scale_bits)
+      : m_precision_bits(precision_bits), m_scale_bits(scale_bits) {}
+
+  bool run_on_function(std::shared_ptr<ngraph::Function> function) override;
+
+  /// \brief Returns the number of bits by which the planned encoding scale
+  /// of node grows the scale of a product, or -1 if node is not planned
+  int encoding_bits(const Node* node) const;
+
+  /// \brief Returns the planned encoding scale of node, or 0 if node is not
+  /// planned
+  double encoding_scale(const Node* node) const;
+
+  int scale_bits() const { return m_scale_bits; }
+
+ private:
+  int m_precision_bits;
+  int m_scale_bits;
+  std::unordered_map<const Node*, int> m_encoding_bits;
+};
+}  // namespace pass
+}  // namespace he
+}  // namespace ngraph
@@ -0,0 +1,162 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ngraph/axis_set.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/coordinate_transform.hpp"
+#include "ngraph/except.hpp"
+#include "ngraph/shape.hpp"
+#include "seal/round_trip_parameter_sets.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Describes the activation the client applies to the ciphertexts of an
+/// activation_request message after decrypting them. Sent as the message
+/// prefix, so chunks of a request can be striped over the data streams.
+struct ActivationRequest {
+  enum class Type : std::uint64_t {
+    relu,
+    bounded_relu,  // min(max(x, 0), alpha)
+    sigmoid,
+    tanh,
+    exp,
+    softmax  // Over each group of group_size consecutive ciphertexts
+  };
+
+  Type type{Type::relu};
+  double alpha{0};
+  // Number of ciphertexts the activation is jointly applied to. Chunks of a
+  // request hold whole groups
+  std::uint64_t group_size{1};
+  // Parameter sets of the request ciphertexts and of the results
+  RoundTripParameterSets parameter_sets;
+
+  enum {
+    serialized_size = sizeof(Type) + sizeof(double) + sizeof(std::uint64_t) +
+                      RoundTripParameterSets::serialized_size
+  };
+
+  bool elementwise() const { return type != Type::softmax; }
+
+  std::string save() const {
+    std::string data(serialized_size, '\0');
+    std::memcpy(&data[0], &type, sizeof(type));
+    std::memcpy(&data[sizeof(type)], &alpha, sizeof(alpha));
+    std::memcpy(&data[sizeof(type) + sizeof(alpha)], &group_size,
+                sizeof(group_size));
+    std::string parameter_sets_data = parameter_sets.save();
+    std::memcpy(&data[sizeof(type) + sizeof(alpha) + sizeof(group_size)],
+                parameter_sets_data.data(), parameter_sets_data.size());
+    return data;
+  }
+
+  void load(const std::string& data) {
+    NGRAPH_CHECK(data.size() == serialized_size,
+                 "Error loading activation request of size ", data.size());
+    std::memcpy(&type, &data[0], sizeof(type));
+    std::memcpy(&alpha, &data[sizeof(type)], sizeof(alpha));
+    std::memcpy(&group_size, &data[sizeof(type) + sizeof(alpha)],
+                sizeof(group_size));
+    parameter_sets.load(data,
+                        sizeof(type) + sizeof(alpha) + sizeof(group_size));
+    NGRAPH_CHECK(type <= Type::softmax, "Unknown activation type ",
+                 static_cast<std::uint64_t>(type));
+    NGRAPH_CHECK(group_size > 0 && (elementwise() ? group_size == 1 : true),
+                 "Invalid activation group size ", group_size);
+  }
+
+  /// \brief Applies an elementwise activation to value
+  template <typename T>
+  T apply(T value) const {
+    switch (type) {
+      case Type::relu:
+        return value > 0 ? value : 0;
+      case Type::bounded_relu:
+        return std::min(std::max(value, T(0)), T(alpha));
+      case Type::sigmoid:
+        return 1 / (1 + std::exp(-value));
+      case Type::tanh:
+        return std::tanh(value);
+      case Type::exp:
+        return std::exp(value);
+      case Type::softmax:
+      default:
+        throw ngraph_error("Activation is not elementwise");
+    }
+  }
+
+  /// \brief Applies the activation in place to values, which are one group
+  template <typename T>
+  void apply(std::vector<T>& values) const {
+    if (elementwise()) {
+      for (auto& value : values) {
+        value = apply(value);
+      }
+      return;
+    }
+    // Softmax, shifted by the maximum for numerical stability
+    T max_value = *std::max_element(values.begin(), values.end());
+    T sum = 0;
+    for (auto& value : values) {
+      value = std::exp(value - max_value);
+      sum += value;
+    }
+    for (auto& value : values) {
+      value /= sum;
+    }
+  }
+};
+
+/// \brief Returns the indices of the elements of a tensor of shape, ordered so
+/// the elements of each group reduced over axes (e.g. by a softmax) are
+/// consecutive
+inline std::vector<size_t> grouped_element_order(const Shape& shape,
+                                                 const AxisSet& axes) {
+  size_t group_size = 1;
+  for (const auto axis : axes) {
+    group_size *= shape[axis];
+  }
+  const size_t element_count = shape_size(shape);
+  std::vector<size_t> element_order(element_count);
+  std::vector<size_t> group_fill(group_size == 0 ? 0
+                                                 : element_count / group_size);
+
+  CoordinateTransform transform(shape);
+  size_t element_idx = 0;
+  for (const Coordinate& coordinate : transform) {
+    // Row-major index of the coordinate over the remaining axes
+    size_t group_idx = 0;
+    for (size_t axis = 0; axis < shape.size(); ++axis) {
+      if (axes.find(axis) == axes.end()) {
+        group_idx = group_idx * shape[axis] + coordinate[axis];
+      }
+    }
+    element_order[group_idx * group_size + group_fill[group_idx]++] =
+        element_idx++;
+  }
+  return element_order;
+}
+}  // namespace he
+}  // namespace ngraph
@@ -0,0 +1,236 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "ngraph/coordinate_transform.hpp"
+#include "seal/linear_plan.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Returns the transform over the (padded and dilated) input
+/// coordinates of one batch item read by the convolution output at out_coord.
+/// Data and results are (N, C, spatial...)
+inline CoordinateTransform convolution_input_transform(
+    const Coordinate& out_coord, const Shape& arg0_shape,
+    const Shape& arg1_shape, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides) {
+  size_t batch_index = out_coord[0];
+  size_t n_spatial_dimensions = arg0_shape.size() - 2;
+  size_t n_input_channels = arg0_shape[1];
+
+  Coordinate input_batch_transform_start(2 + n_spatial_dimensions);
+  Coordinate input_batch_transform_end(2 + n_spatial_dimensions);
+  Strides input_batch_transform_movement_strides(2 + n_spatial_dimensions, 1);
+  CoordinateDiff input_batch_transform_padding_below(2 + n_spatial_dimensions,
+                                                     0);
+  CoordinateDiff input_batch_transform_padding_above(2 + n_spatial_dimensions,
+                                                     0);
+  Strides input_batch_transform_dilation_strides(2 + n_spatial_dimensions, 1);
+
+  input_batch_transform_start[0] = batch_index;
+  input_batch_transform_end[0] = batch_index + 1;
+  input_batch_transform_start[1] = 0;
+  input_batch_transform_end[1] = n_input_channels;
+
+  for (size_t i = 2; i < n_spatial_dimensions + 2; i++) {
+    size_t window_dilation_stride = window_dilation_strides[i - 2];
+    size_t window_movement_stride = window_movement_strides[i - 2];
+    std::ptrdiff_t below_pad = padding_below[i - 2];
+    std::ptrdiff_t above_pad = padding_above[i - 2];
+    size_t data_dilation_stride = data_dilation_strides[i - 2];
+
+    input_batch_transform_start[i] = window_movement_stride * out_coord[i];
+    input_batch_transform_end[i] =
+        input_batch_transform_start[i] +
+        (arg1_shape[i] - 1) * window_dilation_stride + 1;
+    input_batch_transform_movement_strides[i] = window_dilation_stride;
+    input_batch_transform_padding_below[i] = below_pad;
+    input_batch_transform_padding_above[i] = above_pad;
+    input_batch_transform_dilation_strides[i] = data_dilation_stride;
+  }
+
+  AxisVector input_batch_transform_axis_order(2 + n_spatial_dimensions);
+  for (size_t i = 0; i < input_batch_transform_axis_order.size(); i++) {
+    input_batch_transform_axis_order[i] = i;
+  }
+
+  return CoordinateTransform(
+      arg0_shape, input_batch_transform_start, input_batch_transform_end,
+      input_batch_transform_movement_strides, input_batch_transform_axis_order,
+      input_batch_transform_padding_below, input_batch_transform_padding_above,
+      input_batch_transform_dilation_strides);
+}
+
+/// \brief Gather-index tables of a convolution, which depend on the shapes
+/// only, so they are computed once per op. Data and results are
+/// (N, C, spatial...) and filters are (C_out, C_in, spatial...).
+///
+/// The output at (n, c_out, o) multiplies the inputs in the window of its
+/// spatial position o, in each input channel, with the filter of c_out, so
+/// the windows are stored once per spatial output position, as 32-bit
+/// offsets into one channel of the input and of the filter
+class ConvolutionTaps {
+ public:
+  /// \brief Offsets of a tap into one channel of the input and the filter
+  struct WindowTap {
+    std::uint32_t input;
+    std::uint32_t filter;
+  };
+
+  /// \param rotate_filter Whether to reverse the spatial axes of the filter
+  ConvolutionTaps(const Shape& arg0_shape, const Shape& arg1_shape,
+                  const Shape& out_shape,
+                  const Strides& window_movement_strides,
+                  const Strides& window_dilation_strides,
+                  const CoordinateDiff& padding_below,
+                  const CoordinateDiff& padding_above,
+                  const Strides& data_dilation_strides,
+                  bool rotate_filter = false)
+      : m_output_count(shape_size(out_shape)),
+        m_out_channels(out_shape[1]),
+        m_in_channels(arg0_shape[1]),
+        m_input_channel_size(
+            shape_size(Shape(arg0_shape.begin() + 2, arg0_shape.end()))),
+        m_filter_channel_size(
+            shape_size(Shape(arg1_shape.begin() + 2, arg1_shape.end()))) {
+    NGRAPH_CHECK(
+        m_input_channel_size <= std::numeric_limits<std::uint32_t>::max() &&
+            m_filter_channel_size <= std::numeric_limits<std::uint32_t>::max(),
+        "Convolution channels of ", m_input_channel_size, " inputs or ",
+        m_filter_channel_size, " filter weights do not fit 32-bit offsets");
+
+    // The windows of a single batch item, input channel and output channel
+    Shape arg0_channel_shape{1, 1};
+    Shape arg1_channel_shape{1, 1};
+    Shape out_channel_shape{1, 1};
+    arg0_channel_shape.insert(arg0_channel_shape.end(), arg0_shape.begin() + 2,
+                              arg0_shape.end());
+    arg1_channel_shape.insert(arg1_channel_shape.end(), arg1_shape.begin() + 2,
+                              arg1_shape.end());
+    out_channel_shape.insert(out_channel_shape.end(), out_shape.begin() + 2,
+                             out_shape.end());
+
+    CoordinateTransform out_transform(out_channel_shape);
+    std::vector<Coordinate> out_coords;
+    for (const Coordinate& out_coord : out_transform) {
+      out_coords.emplace_back(out_coord);
+    }
+    m_windows.resize(out_coords.size());
+    CoordinateTransform filter_transform(arg1_channel_shape);
+
+#pragma omp parallel for
+    for (size_t position = 0; position < out_coords.size(); ++position) {
+      // The input coordinate I runs over the *padded* and *dilated* channel,
+      // so coordinates in the padding or dilation gaps are skipped, while
+      // the filter coordinate F runs over the filter window
+      CoordinateTransform input_transform = convolution_input_transform(
+          out_coords[position], arg0_channel_shape, arg1_channel_shape,
+          window_movement_strides, window_dilation_strides, padding_below,
+          padding_above, data_dilation_strides);
+      CoordinateTransform::Iterator input_it = input_transform.begin();
+      CoordinateTransform::Iterator filter_it = filter_transform.begin();
+      CoordinateTransform::Iterator input_end = input_transform.end();
+      CoordinateTransform::Iterator filter_end = filter_transform.end();
+      while (input_it != input_end && filter_it != filter_end) {
+        const Coordinate& input_coord = *input_it;
+        if (input_transform.has_source_coordinate(input_coord)) {
+          Coordinate filter_coord = *filter_it;
+          if (rotate_filter) {
+            // Note that we only reverse the spatial dimensions here (loop
+            // starts at 2)
+            for (size_t i = 2; i < filter_coord.size(); i++) {
+              filter_coord[i] = arg1_channel_shape[i] - filter_coord[i] - 1;
+            }
+          }
+          m_windows[position].push_back(WindowTap{
+              static_cast<std::uint32_t>(input_transform.index(input_coord)),
+              static_cast<std::uint32_t>(
+                  filter_transform.index(filter_coord))});
+        }
+        ++input_it;
+        ++filter_it;
+      }
+    }
+    for (const std::vector<WindowTap>& window : m_windows) {
+      m_window_tap_count += window.size();
+    }
+  }
+
+  size_t output_count() const { return m_output_count; }
+
+  /// \brief Returns the number of multiplications of the convolution
+  size_t tap_count() const {
+    return m_output_count / std::max<size_t>(m_windows.size(), 1) *
+           m_in_channels * m_window_tap_count;
+  }
+
+  /// \brief Calls f(arg0_index, arg1_index) for each pair of indices which
+  /// the convolution multiplies for the output at out_index, by input channel
+  template <typename F>
+  void for_each_tap(size_t out_index, F&& f) const {
+    const size_t position = out_index % m_windows.size();
+    const size_t out_channel = out_index / m_windows.size() % m_out_channels;
+    const size_t batch_index = out_index / m_windows.size() / m_out_channels;
+    for (size_t in_channel = 0; in_channel < m_in_channels; ++in_channel) {
+      const size_t input_base =
+          (batch_index * m_in_channels + in_channel) * m_input_channel_size;
+      const size_t filter_base =
+          (out_channel * m_in_channels + in_channel) * m_filter_channel_size;
+      for (const WindowTap& tap : m_windows[position]) {
+        f(input_base + tap.input, filter_base + tap.filter);
+      }
+    }
+  }
+
+  /// \brief Returns the taps of the output at out_index
+  LinearPlan::Taps taps(size_t out_index) const {
+    LinearPlan::Taps out_taps;
+    for_each_tap(out_index, [&out_taps](size_t arg0_index, size_t arg1_index) {
+      out_taps.emplace_back(arg0_index, arg1_index);
+    });
+    return out_taps;
+  }
+
+  /// \brief Returns one more than the largest index of arg0 read by the
+  /// output at out_index, or 0 if it reads no input
+  size_t input_bound(size_t out_index) const {
+    size_t bound = 0;
+    for_each_tap(out_index, [&bound](size_t arg0_index, size_t) {
+      bound = std::max(bound, arg0_index + 1);
+    });
+    return bound;
+  }
+
+ private:
+  size_t m_output_count;
+  size_t m_out_channels;
+  size_t m_in_channels;
+  size_t m_input_channel_size;
+  size_t m_filter_channel_size;
+  // Taps of each spatial output position
+  std::vector<std::vector<WindowTap>> m_windows;
+  size_t m_window_tap_count{0};
+};
+}  // namespace he
+}  // namespace ngraph
@@ -0,0 +1,67 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Describes which evaluation keys the server needs from the client to
+/// evaluate a compiled function. Sent in the eval_key_request message.
+struct EvalKeyRequest {
+  // Relinearization keys are needed for ciphertext-ciphertext multiplication
+  bool relin_keys{false};
+  // Galois elements for which rotation keys are needed
+  std::vector<std::uint64_t> galois_elements;
+
+  bool empty() const { return !relin_keys && galois_elements.empty(); }
+
+  /// \brief Number of key messages the client will send in response
+  size_t num_key_messages() const {
+    return (relin_keys ? 1 : 0) + (galois_elements.empty() ? 0 : 1);
+  }
+
+  void save(std::ostream& stream) const {
+    std::uint8_t relin = relin_keys ? 1 : 0;
+    std::uint64_t galois_count = galois_elements.size();
+    stream.write(reinterpret_cast<const char*>(&relin), sizeof(relin));
+    stream.write(reinterpret_cast<const char*>(&galois_count),
+                 sizeof(galois_count));
+    stream.write(reinterpret_cast<const char*>(galois_elements.data()),
+                 galois_count * sizeof(std::uint64_t));
+  }
+
+  void load(std::istream& stream) {
+    std::uint8_t relin;
+    std::uint64_t galois_count;
+    stream.read(reinterpret_cast<char*>(&relin), sizeof(relin));
+    stream.read(reinterpret_cast<char*>(&galois_count), sizeof(galois_count));
+    NGRAPH_CHECK(stream.good(), "Error loading eval key request");
+    relin_keys = relin != 0;
+    galois_elements.resize(galois_count);
+    stream.read(reinterpret_cast<char*>(galois_elements.data()),
+                galois_count * sizeof(std::uint64_t));
+    NGRAPH_CHECK(stream.good(), "Error loading eval key request");
+  }
+};
+}  // namespace he
+}  // namespace ngraph
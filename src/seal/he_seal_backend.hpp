@@ -42,6 +42,7 @@
 #include "seal/he_seal_encryption_parameters.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_key_store.hpp"
 #include "seal/seal_plaintext_wrapper.hpp"
 
 namespace ngraph {
@@ -168,11 +169,22 @@ class HESealBackend : public ngraph::runtime::Backend {
     m_relin_keys = std::make_shared<seal::RelinKeys>(keys);
   }
 
+  const inline std::shared_ptr<seal::GaloisKeys> get_galois_keys() const {
+    return m_galois_keys;
+  }
+
+  void set_galois_keys(const seal::GaloisKeys& keys) {
+    m_galois_keys = std::make_shared<seal::GaloisKeys>(keys);
+  }
+
   void set_public_key(const seal::PublicKey& key) {
     m_public_key = std::make_shared<seal::PublicKey>(key);
     m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
   }
 
+  // Client keys cached for session resumption
+  ngraph::he::ServerKeyCache& client_key_cache() { return m_client_key_cache; }
+
   const inline std::shared_ptr<seal::Evaluator> get_evaluator() const {
     return m_evaluator;
   }
@@ -196,6 +208,9 @@ class HESealBackend : public ngraph::runtime::Backend {
   bool pack_data() const { return m_pack_data; };
   bool encrypt_model() const { return m_encrypt_model; };
 
+  /// \brief Returns the scale at which fresh ciphertexts are encoded
+  double get_scale() const { return m_scale; }
+
   // TODO: remove once performance impact is understood
   bool naive_rescaling() const { return m_naive_rescaling; }
   bool& naive_rescaling() { return m_naive_rescaling; }
@@ -229,6 +244,7 @@ class HESealBackend : public ngraph::runtime::Backend {
   std::shared_ptr<seal::SecretKey> m_secret_key;
   std::shared_ptr<seal::PublicKey> m_public_key;
   std::shared_ptr<seal::RelinKeys> m_relin_keys;
+  std::shared_ptr<seal::GaloisKeys> m_galois_keys;
   std::shared_ptr<seal::Encryptor> m_encryptor;
   std::shared_ptr<seal::Decryptor> m_decryptor;
   std::shared_ptr<seal::SEALContext> m_context;
@@ -239,6 +255,12 @@ class HESealBackend : public ngraph::runtime::Backend {
   // Scale with which to encode new ciphertexts
   double m_scale;
 
+  // Persisted to NGRAPH_HE_SERVER_KEY_STORE, if set
+  ngraph::he::ServerKeyCache m_client_key_cache{
+      std::getenv("NGRAPH_HE_SERVER_KEY_STORE") == nullptr
+          ? ""
+          : std::getenv("NGRAPH_HE_SERVER_KEY_STORE")};
+
   // Stores Barrett64 ratios for moduli under 30 bits
   std::unordered_map<std::uint64_t, std::uint64_t> m_barrett64_ratio_map;
 };
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <boost/asio.hpp>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -24,29 +25,145 @@
 #include <vector>
 
 #include "ngraph/log.hpp"
+#include "seal/activation_request.hpp"
+#include "seal/eval_key_request.hpp"
 #include "seal/he_seal_client.hpp"
+#include "seal/round_trip_parameter_sets.hpp"
 #include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_key_store.hpp"
 #include "seal/seal_util.hpp"
 #include "tcp/tcp_client.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/transport_uri.hpp"
 
 ngraph::he::HESealClient::HESealClient(const std::string& hostname,
                                        const size_t port,
                                        const size_t batch_size,
                                        const std::vector<float>& inputs)
-    : m_batch_size{batch_size}, m_is_done(false), m_inputs{inputs} {
-  boost::asio::io_context io_context;
-  tcp::resolver resolver(io_context);
-  auto endpoints = resolver.resolve(hostname, std::to_string(port));
+    : HESealClient(TransportURI::from_host_port(hostname, port).to_string(),
+                   batch_size, inputs) {}
+
+ngraph::he::HESealClient::HESealClient(const std::string& server_uri,
+                                       const size_t batch_size,
+                                       const std::vector<float>& inputs)
+    : HESealClient(server_uri, batch_size, inputs.data(), inputs.size()) {}
+
+ngraph::he::HESealClient::HESealClient(const std::string& server_uri,
+                                       const size_t batch_size,
+                                       const float* inputs,
+                                       const size_t input_size)
+    : HESealClient(server_uri, batch_size, size_t(1)) {
+  m_results = submit(inputs, input_size).get();
+  close_connection();
+}
+
+ngraph::he::HESealClient::HESealClient(const std::string& server_uri,
+                                       const size_t batch_size,
+                                       const size_t num_threads)
+    : m_batch_size{batch_size},
+      m_is_done(false),
+      m_nonlinearity_pool(std::make_unique<boost::asio::thread_pool>(
+          std::max(num_threads, size_t(1)))) {
+  TransportURI uri(server_uri);
 
   auto client_callback = [this](const ngraph::he::TCPMessage& message) {
     return handle_message(message);
   };
 
-  m_tcp_client = std::make_shared<ngraph::he::TCPClient>(io_context, endpoints,
+  m_tcp_client = std::make_shared<ngraph::he::TCPClient>(m_io_context, uri,
                                                          client_callback);
+  m_io_thread = std::thread([this]() { m_io_context.run(); });
+}
+
+ngraph::he::HESealClient::~HESealClient() {
+  if (!m_is_done) {
+    close_connection();
+  }
+  if (m_io_thread.joinable()) {
+    m_io_thread.join();
+  }
+  m_nonlinearity_pool->join();
+  // Joins the message handler thread while the members it uses still exist
+  m_tcp_client = nullptr;
+}
+
+std::future<std::vector<float>> ngraph::he::HESealClient::submit(
+    const std::vector<float>& inputs) {
+  return submit(inputs.data(), inputs.size());
+}
+
+std::future<std::vector<float>> ngraph::he::HESealClient::submit(
+    const float* inputs, const size_t input_size) {
+  std::future<std::vector<float>> results;
+  size_t query_id;
+  {
+    std::unique_lock<std::mutex> mlock(m_query_mutex);
+    query_id = m_next_query_id++;
+    results = m_queries[query_id].results_promise.get_future();
+
+    // Wait until the keys are set up and the server sent the parameter size
+    m_query_cond.wait(mlock,
+                      [this]() { return m_parameter_size > 0 || m_is_done; });
+    if (m_is_done) {
+      // Queries pending when the connection closed have already failed
+      auto query_it = m_queries.find(query_id);
+      if (query_it != m_queries.end()) {
+        query_it->second.results_promise.set_exception(
+            std::make_exception_ptr(ngraph_error("Client connection closed")));
+        m_queries.erase(query_it);
+      }
+      return results;
+    }
+  }
+  send_inputs(query_id, inputs, input_size);
+  return results;
+}
+
+void ngraph::he::HESealClient::send_inputs(size_t query_id,
+                                           const float* inputs,
+                                           size_t input_size) {
+  const size_t parameter_size = m_parameter_size;
+  const size_t complex_pack_factor = complex_packing() ? 2 : 1;
 
-  io_context.run();
+  // TODO: allow smaller sizes!
+  NGRAPH_CHECK(input_size ==
+                   parameter_size * m_batch_size * complex_pack_factor,
+               "inputs.size()", input_size, "parameter_size",
+               parameter_size, "m_batch_size", m_batch_size,
+               "complex_pack_factor", complex_pack_factor);
+
+  std::vector<seal::Ciphertext> ciphers(parameter_size);
+#pragma omp parallel for
+  for (size_t data_idx = 0; data_idx < parameter_size; ++data_idx) {
+    seal::Plaintext plain;
+
+    size_t batch_start_idx = data_idx * m_batch_size * complex_pack_factor;
+    size_t batch_end_idx = batch_start_idx + m_batch_size * complex_pack_factor;
+
+    std::vector<double> real_vals{inputs + batch_start_idx,
+                                  inputs + batch_end_idx};
+    if (complex_packing()) {
+      std::vector<std::complex<double>> complex_vals;
+      real_vec_to_complex_vec(complex_vals, real_vals);
+      m_ckks_encoder->encode(complex_vals, m_scale, plain);
+    } else {
+      m_ckks_encoder->encode(real_vals, m_scale, plain);
+    }
+    m_encryptor->encrypt(plain, ciphers[data_idx]);
+  }
+  // Send in chunks, so the server can load ciphertexts while receiving
+  size_t chunk_count =
+      TCPMessage::chunk_count(ciphertext_size(ciphers.front()));
+  NGRAPH_INFO << "Sending query " << query_id << " with " << parameter_size
+              << " ciphertexts in chunks of " << chunk_count;
+  for (size_t offset = 0; offset < parameter_size; offset += chunk_count) {
+    auto execute_message =
+        TCPMessage(ngraph::he::MessageType::execute, ciphers, offset,
+                   std::min(chunk_count, parameter_size - offset));
+    execute_message.set_query_id(query_id);
+    write_data_message(std::move(execute_message));
+  }
 }
 
 void ngraph::he::HESealClient::set_seal_context() {
@@ -55,8 +172,27 @@ void ngraph::he::HESealClient::set_seal_context() {
 
   print_seal_context(*m_context);
 
-  m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
-  m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
+  // Keys stored by an earlier run skip key generation and, if the server
+  // still caches them, key upload
+  const char* key_store = std::getenv("NGRAPH_HE_KEY_STORE");
+  if (key_store != nullptr) {
+    m_key_store_path = std::string(key_store) + "/" +
+                       ngraph::he::parms_id_to_string(*m_context) + ".keys";
+  }
+  ngraph::he::SealKeySet stored_keys;
+  if (!m_key_store_path.empty() &&
+      ngraph::he::load_key_set(m_key_store_path, m_context, stored_keys) &&
+      stored_keys.secret_key != nullptr && stored_keys.public_key != nullptr) {
+    NGRAPH_INFO << "Loaded keys from " << m_key_store_path;
+    m_keygen = std::make_shared<seal::KeyGenerator>(
+        m_context, *stored_keys.secret_key, *stored_keys.public_key);
+    m_relin_keys = stored_keys.relin_keys;
+    m_galois_keys = stored_keys.galois_keys;
+    m_session_token = stored_keys.session_token;
+  } else {
+    // Evaluation keys are only generated once requested by the server
+    m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
+  }
   m_public_key = std::make_shared<seal::PublicKey>(m_keygen->public_key());
   m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
   m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
@@ -71,6 +207,106 @@ void ngraph::he::HESealClient::set_seal_context() {
   // TODO: pick better scale?
   m_scale = ngraph::he::choose_scale(m_encryption_params.coeff_modulus());
   NGRAPH_INFO << "Client scale " << m_scale;
+
+  m_parameter_sets[0] = ParameterSet{m_context, m_encryptor, m_decryptor,
+                                     m_ckks_encoder, m_scale};
+}
+
+void ngraph::he::HESealClient::handle_parameter_set(
+    const ngraph::he::TCPMessage& message) {
+  std::uint64_t parameter_set;
+  ngraph::he::EvalKeyRequest request;
+  std::stringstream prefix_stream(message.prefix());
+  prefix_stream.read(reinterpret_cast<char*>(&parameter_set),
+                     sizeof(parameter_set));
+  request.load(prefix_stream);
+  NGRAPH_CHECK(parameter_set != 0, "Parameter set 0 is set up by the "
+                                   "encryption_parameters message");
+
+  std::stringstream param_stream;
+  param_stream.write(message.data_ptr(), message.element_size());
+  seal::EncryptionParameters parms =
+      seal::EncryptionParameters::Load(param_stream);
+  auto context =
+      seal::SEALContext::Create(parms, true, seal::sec_level_type::none);
+  NGRAPH_INFO << "Loaded encryption parameters of parameter set "
+              << parameter_set;
+  print_seal_context(*context);
+
+  // Keys of additional parameter sets are not kept in the key store, so they
+  // are generated and sent in every session
+  seal::KeyGenerator keygen(context);
+  ngraph::he::SealKeySet keys;
+  keys.public_key = std::make_shared<seal::PublicKey>(keygen.public_key());
+  if (request.relin_keys) {
+    keys.relin_keys = std::make_shared<seal::RelinKeys>(keygen.relin_keys());
+  }
+  if (!request.galois_elements.empty()) {
+    keys.galois_keys = std::make_shared<seal::GaloisKeys>(
+        keygen.galois_keys(request.galois_elements));
+  }
+
+  ParameterSet& set = m_parameter_sets[parameter_set];
+  set.context = context;
+  set.encryptor = std::make_shared<seal::Encryptor>(context, *keys.public_key);
+  set.decryptor =
+      std::make_shared<seal::Decryptor>(context, keygen.secret_key());
+  set.ckks_encoder = std::make_shared<seal::CKKSEncoder>(context);
+  set.scale = ngraph::he::choose_scale(parms.coeff_modulus());
+
+  std::stringstream key_stream;
+  keys.save(key_stream);
+  std::string key_prefix(reinterpret_cast<const char*>(&parameter_set),
+                         sizeof(parameter_set));
+  NGRAPH_INFO << "Sending keys of parameter set " << parameter_set;
+  write_message(TCPMessage(ngraph::he::MessageType::parameter_set_keys, 1,
+                           std::move(key_stream), key_prefix));
+}
+
+const ngraph::he::HESealClient::ParameterSet&
+ngraph::he::HESealClient::get_parameter_set(size_t parameter_set) const {
+  auto it = m_parameter_sets.find(parameter_set);
+  NGRAPH_CHECK(it != m_parameter_sets.end(), "Unknown parameter set ",
+               parameter_set);
+  return it->second;
+}
+
+void ngraph::he::HESealClient::encrypt_values(const std::vector<double>& values,
+                                              seal::Ciphertext& cipher,
+                                              size_t parameter_set) {
+  const ParameterSet& set = get_parameter_set(parameter_set);
+  seal::Plaintext plain;
+  if (complex_packing()) {
+    std::vector<std::complex<double>> complex_vals;
+    real_vec_to_complex_vec(complex_vals, values);
+    set.ckks_encoder->encode(complex_vals, set.scale, plain);
+  } else {
+    set.ckks_encoder->encode(values, set.scale, plain);
+  }
+  set.encryptor->encrypt(plain, cipher);
+}
+
+void ngraph::he::HESealClient::send_public_key() {
+  std::stringstream pk_stream;
+  m_public_key->save(pk_stream);
+  auto pk_message = TCPMessage(ngraph::he::MessageType::public_key, 1,
+                               std::move(pk_stream));
+  NGRAPH_INFO << "Sending public key";
+  write_message(std::move(pk_message));
+}
+
+void ngraph::he::HESealClient::save_keys() {
+  if (m_key_store_path.empty()) {
+    return;
+  }
+  ngraph::he::SealKeySet keys;
+  keys.session_token = m_session_token;
+  keys.secret_key = m_secret_key;
+  keys.public_key = m_public_key;
+  keys.relin_keys = m_relin_keys;
+  keys.galois_keys = m_galois_keys;
+  ngraph::he::save_key_set(m_key_store_path, keys);
+  NGRAPH_INFO << "Saved keys to " << m_key_store_path;
 }
 
 void ngraph::he::HESealClient::handle_message(
@@ -86,8 +322,6 @@ void ngraph::he::HESealClient::handle_message(
       size_t parameter_size;
       std::memcpy(&parameter_size, message.data_ptr(), message.data_size());
 
-      const size_t complex_pack_factor = complex_packing() ? 2 : 1;
-
       NGRAPH_INFO << "Parameter size " << parameter_size;
       NGRAPH_INFO << "Client batch size " << m_batch_size;
       if (complex_packing()) {
@@ -96,75 +330,86 @@ void ngraph::he::HESealClient::handle_message(
         assert(m_batch_size % 2 == 0);
       }
 
-      // TODO: allow smaller sizes!
-      if (m_inputs.size() !=
-          parameter_size * m_batch_size * complex_pack_factor) {
-        NGRAPH_INFO << "m_inputs.size() " << m_inputs.size()
-                    << " != paramter_size ( " << parameter_size
-                    << ") * m_batch_size (" << m_batch_size
-                    << ") * complex_pack_factor (" << complex_pack_factor
-                    << ")";
-      }
-      NGRAPH_CHECK(m_inputs.size() ==
-                       parameter_size * m_batch_size * complex_pack_factor,
-                   "m_inputs.size()", m_inputs.size(), "parameter_size",
-                   parameter_size, "m_batch_size", m_batch_size,
-                   "complex_pack_factor", complex_pack_factor);
-
-      std::vector<seal::Ciphertext> ciphers(parameter_size);
-#pragma omp parallel for
-      for (size_t data_idx = 0; data_idx < parameter_size; ++data_idx) {
-        seal::Plaintext plain;
-
-        size_t batch_start_idx = data_idx * m_batch_size * complex_pack_factor;
-        size_t batch_end_idx =
-            batch_start_idx + m_batch_size * complex_pack_factor;
-
-        std::vector<double> real_vals{m_inputs.begin() + batch_start_idx,
-                                      m_inputs.begin() + batch_end_idx};
-        if (complex_packing()) {
-          std::vector<std::complex<double>> complex_vals;
-          real_vec_to_complex_vec(complex_vals, real_vals);
-          m_ckks_encoder->encode(complex_vals, m_scale, plain);
-        } else {
-          m_ckks_encoder->encode(real_vals, m_scale, plain);
-        }
-        m_encryptor->encrypt(plain, ciphers[data_idx]);
-      }
-      NGRAPH_INFO << "Creating execute message";
-      auto execute_message =
-          TCPMessage(ngraph::he::MessageType::execute, ciphers);
-      NGRAPH_INFO << "Sending execute message with " << parameter_size
-                  << " ciphertexts";
-      write_message(std::move(execute_message));
+      // Queries submitted so far are waiting for the parameter size
+      std::lock_guard<std::mutex> guard(m_query_mutex);
+      m_parameter_size = parameter_size;
+      m_query_cond.notify_all();
       break;
     }
     case ngraph::he::MessageType::result: {
       size_t result_count = message.count();
+      size_t result_offset = message.offset();
       size_t element_size = message.element_size();
+      size_t query_id = message.query_id();
 
-      NGRAPH_INFO << "Client got " << result_count << " results ";
+      NGRAPH_INFO << "Client got results [" << result_offset << ", "
+                  << result_offset + result_count << ") of "
+                  << message.total_count() << " of query " << query_id;
+
+      ngraph::he::RoundTripParameterSets parameter_sets;
+      parameter_sets.load(message.prefix());
+      const ParameterSet& set =
+          get_parameter_set(parameter_sets.parameter_set);
+
+      const size_t complex_pack_factor = complex_packing() ? 2 : 1;
+      const size_t values_per_result = m_batch_size * complex_pack_factor;
+      const size_t total_count = message.total_count();
+      std::shared_ptr<std::vector<float>> results;
+      {
+        std::lock_guard<std::mutex> guard(m_query_mutex);
+        auto query_it = m_queries.find(query_id);
+        NGRAPH_CHECK(query_it != m_queries.end(), "Results of unknown query ",
+                     query_id);
+        Query& query = query_it->second;
+        if (query.results == nullptr) {
+          query.results =
+              std::make_shared<std::vector<float>>(total_count *
+                                                   values_per_result);
+        }
+        results = query.results;
+      }
 
-      std::vector<seal::Ciphertext> result;
-      m_results.reserve(result_count * m_batch_size);
+      // Each chunk fills its own columns of the batch-major results, so
+      // chunks are decoded without holding the lock
+      float* results_ptr = results->data();
+#pragma omp parallel for
       for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
         seal::Ciphertext cipher;
-        std::stringstream cipher_stream;
-        cipher_stream.write(message.data_ptr() + result_idx * element_size,
-                            element_size);
-        cipher.load(m_context, cipher_stream);
+        ngraph::he::load_ciphertext(
+            cipher, set.context,
+            message.data_ptr() + result_idx * element_size, element_size);
 
-        result.push_back(cipher);
         seal::Plaintext plain;
-        m_decryptor->decrypt(cipher, plain);
+        set.decryptor->decrypt(cipher, plain);
 
         std::vector<double> outputs;
-        decode_to_real_vec(plain, outputs, complex_packing());
-        m_results.insert(m_results.end(), outputs.begin(), outputs.end());
+        decode_to_real_vec(plain, outputs, complex_packing(),
+                           parameter_sets.parameter_set);
+        NGRAPH_CHECK(outputs.size() == values_per_result, "Decoded ",
+                     outputs.size(), " values; expected ", values_per_result);
+        const size_t cipher_idx = result_offset + result_idx;
+        for (size_t batch_idx = 0; batch_idx < values_per_result;
+             ++batch_idx) {
+          results_ptr[batch_idx * total_count + cipher_idx] =
+              outputs[batch_idx];
+        }
       }
-      NGRAPH_INFO << "Results size " << m_results.size();
 
-      close_connection();
+      std::lock_guard<std::mutex> guard(m_query_mutex);
+      auto query_it = m_queries.find(query_id);
+      if (query_it == m_queries.end()) {
+        // Failed by close_connection while decoding
+        break;
+      }
+      Query& query = query_it->second;
+      query.results_received += result_count;
+
+      if (query.results_received == total_count) {
+        NGRAPH_INFO << "Query " << query_id << " results size "
+                    << results->size();
+        query.results_promise.set_value(std::move(*results));
+        m_queries.erase(query_it);
+      }
       break;
     }
 
@@ -173,6 +418,33 @@ void ngraph::he::HESealClient::handle_message(
       break;
     }
 
+    case ngraph::he::MessageType::data_streams: {
+      // Open at most as many data streams as the server offers
+      std::uint64_t offered_data_streams;
+      std::memcpy(&offered_data_streams, message.data_ptr(),
+                  sizeof(offered_data_streams));
+      std::uint64_t data_streams = offered_data_streams;
+      const char* max_data_streams = std::getenv("NGRAPH_HE_DATA_STREAMS");
+      if (max_data_streams != nullptr) {
+        data_streams = std::min(data_streams,
+                                std::uint64_t(std::stoul(max_data_streams)));
+      }
+      NGRAPH_INFO << "Server offered " << offered_data_streams
+                  << " data streams; using " << data_streams;
+
+      // Reply before connecting, so the server accepts exactly data_streams
+      // connections
+      std::stringstream stream;
+      stream.write(reinterpret_cast<const char*>(&data_streams),
+                   sizeof(data_streams));
+      write_message(TCPMessage(ngraph::he::MessageType::data_streams, 1,
+                               std::move(stream)));
+      if (data_streams > 0) {
+        m_tcp_client->open_data_streams(data_streams);
+      }
+      break;
+    }
+
     case ngraph::he::MessageType::encryption_parameters: {
       std::stringstream param_stream;
       param_stream.write(message.data_ptr(), message.element_size());
@@ -181,34 +453,100 @@ void ngraph::he::HESealClient::handle_message(
 
       set_seal_context();
 
-      // Send public key
-      std::stringstream pk_stream;
-      m_public_key->save(pk_stream);
-      auto pk_message = TCPMessage(ngraph::he::MessageType::public_key, 1,
-                                   std::move(pk_stream));
-      NGRAPH_INFO << "Sending public key";
-      write_message(std::move(pk_message));
-
-      // Send evaluation key
-      std::stringstream evk_stream;
-      m_relin_keys->save(evk_stream);
-      auto evk_message = TCPMessage(ngraph::he::MessageType::eval_key, 1,
-                                    std::move(evk_stream));
-      NGRAPH_INFO << "Sending evaluation key";
-      write_message(std::move(evk_message));
-
+      if (m_session_token.empty()) {
+        send_public_key();
+      } else {
+        NGRAPH_INFO << "Resuming session";
+        write_message(TCPMessage(ngraph::he::MessageType::session_token, 1,
+                                 m_session_token.size(),
+                                 m_session_token.data()));
+      }
       break;
     }
-    case ngraph::he::MessageType::relu6_request: {
-      handle_relu_request(message);
+    case ngraph::he::MessageType::session_token: {
+      std::string token(message.data_ptr(), message.data_size());
+      if (token.empty()) {
+        // The server has no keys for the stored session
+        NGRAPH_INFO << "Server cannot resume session";
+        m_session_token.clear();
+        send_public_key();
+      } else if (token == m_session_token) {
+        NGRAPH_INFO << "Server resumed session";
+      } else {
+        m_session_token = token;
+        save_keys();
+      }
       break;
     }
-    case ngraph::he::MessageType::relu_request: {
-      handle_relu_request(message);
+    case ngraph::he::MessageType::eval_key_request: {
+      std::stringstream request_stream;
+      request_stream.write(message.data_ptr(), message.element_size());
+      ngraph::he::EvalKeyRequest request;
+      request.load(request_stream);
+
+      // Stored keys are reused if they cover the request
+      bool generated_keys = false;
+      if (request.relin_keys) {
+        if (m_relin_keys == nullptr) {
+          m_relin_keys =
+              std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
+          generated_keys = true;
+        }
+        std::stringstream evk_stream;
+        m_relin_keys->save(evk_stream);
+        auto evk_message = TCPMessage(ngraph::he::MessageType::eval_key, 1,
+                                      std::move(evk_stream));
+        NGRAPH_INFO << "Sending evaluation key";
+        write_message(std::move(evk_message));
+      }
+      if (!request.galois_elements.empty()) {
+        bool has_galois_keys = m_galois_keys != nullptr;
+        for (const auto galois_elt : request.galois_elements) {
+          has_galois_keys =
+              has_galois_keys && m_galois_keys->has_key(galois_elt);
+        }
+        if (!has_galois_keys) {
+          m_galois_keys = std::make_shared<seal::GaloisKeys>(
+              m_keygen->galois_keys(request.galois_elements));
+          generated_keys = true;
+        }
+        std::stringstream galois_stream;
+        m_galois_keys->save(galois_stream);
+        auto galois_message = TCPMessage(ngraph::he::MessageType::galois_key,
+                                         1, std::move(galois_stream));
+        NGRAPH_INFO << "Sending " << request.galois_elements.size()
+                    << " Galois keys";
+        write_message(std::move(galois_message));
+      }
+      if (generated_keys) {
+        save_keys();
+      }
+      break;
+    }
+    case ngraph::he::MessageType::parameter_set: {
+      handle_parameter_set(message);
+      break;
+    }
+    case ngraph::he::MessageType::activation_request: {
+      ngraph::he::ActivationRequest activation;
+      activation.load(message.prefix());
+
+      // The handler thread owns message, so copy it for the nonlinearity pool
+      auto request = std::make_shared<TCPMessage>(
+          msg_type, message.count(), message.data_size(), message.data_ptr());
+      request->set_chunk(message.offset(), message.total_count());
+      request->set_query_id(message.query_id());
+      boost::asio::post(*m_nonlinearity_pool, [this, request, activation]() {
+        handle_activation_request(*request, activation);
+      });
       break;
     }
 
     case ngraph::he::MessageType::max_request: {
+      ngraph::he::RoundTripParameterSets parameter_sets;
+      parameter_sets.load(message.prefix());
+      const ParameterSet& set =
+          get_parameter_set(parameter_sets.parameter_set);
       size_t complex_pack_factor = complex_packing() ? 2 : 1;
       size_t cipher_count = message.count();
       size_t element_size = message.element_size();
@@ -225,16 +563,16 @@ void ngraph::he::HESealClient::handle_message(
         seal::Ciphertext pre_sort_cipher;
         seal::Plaintext pre_sort_plain;
 
-        // Load cipher from stream
-        std::stringstream pre_sort_cipher_stream;
-        pre_sort_cipher_stream.write(
+        // Load cipher from message
+        ngraph::he::load_ciphertext(
+            pre_sort_cipher, set.context,
             message.data_ptr() + cipher_idx * element_size, element_size);
-        pre_sort_cipher.load(m_context, pre_sort_cipher_stream);
 
         // Decrypt cipher
-        m_decryptor->decrypt(pre_sort_cipher, pre_sort_plain);
+        set.decryptor->decrypt(pre_sort_cipher, pre_sort_plain);
         std::vector<double> pre_max_value;
-        decode_to_real_vec(pre_sort_plain, pre_max_value, complex_packing());
+        decode_to_real_vec(pre_sort_plain, pre_max_value, complex_packing(),
+                           parameter_sets.parameter_set);
 
         for (size_t batch_idx = 0;
              batch_idx < m_batch_size * complex_pack_factor; ++batch_idx) {
@@ -250,20 +588,12 @@ void ngraph::he::HESealClient::handle_message(
                               input_cipher_values[batch_idx].end());
       }
 
-      // Encrypt maximum values
+      // Encrypt maximum values in the parameter set of the next segment
       seal::Ciphertext cipher_max;
-      seal::Plaintext plain_max;
       std::stringstream max_stream;
-
-      if (complex_packing()) {
-        assert(max_values.size() % 2 == 0);
-        std::vector<std::complex<double>> max_complex_vals;
-        real_vec_to_complex_vec(max_complex_vals, max_values);
-        m_ckks_encoder->encode(max_complex_vals, m_scale, plain_max);
-      } else {
-        m_ckks_encoder->encode(max_values, m_scale, plain_max);
-      }
-      m_encryptor->encrypt(plain_max, cipher_max);
+      assert(!complex_packing() || max_values.size() % 2 == 0);
+      encrypt_values(max_values, cipher_max,
+                     parameter_sets.result_parameter_set);
       cipher_max.save(max_stream);
 
       auto max_result_msg = TCPMessage(ngraph::he::MessageType::max_result, 1,
@@ -272,13 +602,15 @@ void ngraph::he::HESealClient::handle_message(
 
       break;
     }
+    case ngraph::he::MessageType::activation_result:
+    case ngraph::he::MessageType::eval_key:
     case ngraph::he::MessageType::execute:
+    case ngraph::he::MessageType::galois_key:
     case ngraph::he::MessageType::max_result:
     case ngraph::he::MessageType::minimum_request:
     case ngraph::he::MessageType::minimum_result:
     case ngraph::he::MessageType::parameter_shape_request:
     case ngraph::he::MessageType::public_key:
-    case ngraph::he::MessageType::relu_result:
     case ngraph::he::MessageType::result_request:
     default:
       NGRAPH_INFO << "Unsupported message type: "
@@ -289,81 +621,88 @@ void ngraph::he::HESealClient::handle_message(
 void ngraph::he::HESealClient::close_connection() {
   NGRAPH_INFO << "Closing connection";
   m_tcp_client->close();
+
+  std::lock_guard<std::mutex> guard(m_query_mutex);
   m_is_done = true;
+  for (auto& query : m_queries) {
+    query.second.results_promise.set_exception(
+        std::make_exception_ptr(ngraph_error("Client connection closed")));
+  }
+  m_queries.clear();
+  m_query_cond.notify_all();
 }
 
-void ngraph::he::HESealClient::handle_relu_request(
-    const ngraph::he::TCPMessage& message) {
-  auto relu = [=](double d) { return d > 0 ? d : 0; };
-  auto relu6 = [=](double d) { return d > 6.0 ? 6.0 : (d > 0) ? d : 0.; };
+void ngraph::he::HESealClient::handle_activation_request(
+    const ngraph::he::TCPMessage& message,
+    const ngraph::he::ActivationRequest& activation) {
+  const size_t cipher_count = message.count();
+  const size_t element_size = message.element_size();
+  const size_t group_size = activation.group_size;
+  NGRAPH_CHECK(cipher_count % group_size == 0, "Activation request with ",
+               cipher_count, " ciphertexts is not made of groups of size ",
+               group_size);
 
-  std::function<double(double)> activation;
+  const size_t parameter_set = activation.parameter_sets.parameter_set;
+  const ParameterSet& set = get_parameter_set(parameter_set);
 
-  if (message.message_type() == ngraph::he::MessageType::relu6_request) {
-    activation = relu6;
-  } else if (message.message_type() == ngraph::he::MessageType::relu_request) {
-    activation = relu;
-  } else {
-    throw ngraph_error("Non-relu message type in handle_relu_request");
+  std::vector<std::vector<double>> values(cipher_count);
+#pragma omp parallel for
+  for (size_t cipher_idx = 0; cipher_idx < cipher_count; ++cipher_idx) {
+    seal::Ciphertext cipher;
+    ngraph::he::load_ciphertext(cipher, set.context,
+                                message.data_ptr() + cipher_idx * element_size,
+                                element_size);
+    seal::Plaintext plain;
+    set.decryptor->decrypt(cipher, plain);
+    decode_to_real_vec(plain, values[cipher_idx], complex_packing(),
+                       parameter_set);
   }
 
-  size_t result_count = message.count();
-  size_t element_size = message.element_size();
-  // NGRAPH_INFO << "Received Relu request with " << result_count << " elements"
-  //            << " of size " << element_size;
-
-  std::vector<seal::Ciphertext> post_relu_ciphers(result_count);
+  // Each batch slot of a group is activated separately
+  const size_t value_count = values.front().size();
+  const size_t group_count = cipher_count / group_size;
 #pragma omp parallel for
-  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-    seal::Ciphertext pre_relu_cipher;
-    seal::Plaintext relu_plain;
-
-    // Load cipher from stream
-    std::stringstream pre_relu_cipher_stream;
-    pre_relu_cipher_stream.write(message.data_ptr() + result_idx * element_size,
-                                 element_size);
-    pre_relu_cipher.load(m_context, pre_relu_cipher_stream);
-
-    // Decrypt cipher
-    m_decryptor->decrypt(pre_relu_cipher, relu_plain);
-
-    std::vector<double> relu_vals;
-    decode_to_real_vec(relu_plain, relu_vals, complex_packing());
-
-    std::vector<double> post_relu_vals(relu_vals.size());
-    std::transform(relu_vals.begin(), relu_vals.end(), post_relu_vals.begin(),
-                   activation);
-
-    if (complex_packing()) {
-      std::vector<std::complex<double>> complex_relu_vals;
-      real_vec_to_complex_vec(complex_relu_vals, post_relu_vals);
-      m_ckks_encoder->encode(complex_relu_vals, m_scale, relu_plain);
-    } else {
-      m_ckks_encoder->encode(post_relu_vals, m_scale, relu_plain);
+  for (size_t group_idx = 0; group_idx < group_count; ++group_idx) {
+    std::vector<double> group_values(group_size);
+    for (size_t value_idx = 0; value_idx < value_count; ++value_idx) {
+      for (size_t i = 0; i < group_size; ++i) {
+        group_values[i] = values[group_idx * group_size + i][value_idx];
+      }
+      activation.apply(group_values);
+      for (size_t i = 0; i < group_size; ++i) {
+        values[group_idx * group_size + i][value_idx] = group_values[i];
+      }
     }
-    m_encryptor->encrypt(relu_plain, post_relu_ciphers[result_idx]);
   }
-  auto relu_result_msg =
-      TCPMessage(ngraph::he::MessageType::relu_result, post_relu_ciphers);
-  // NGRAPH_INFO << "Writing relu_result message with " << result_count
-  //            << " ciphertexts";
 
-  write_message(std::move(relu_result_msg));
-  return;
+  // Results are encrypted in the parameter set of the next segment
+  std::vector<seal::Ciphertext> post_activation_ciphers(cipher_count);
+#pragma omp parallel for
+  for (size_t cipher_idx = 0; cipher_idx < cipher_count; ++cipher_idx) {
+    encrypt_values(values[cipher_idx], post_activation_ciphers[cipher_idx],
+                   activation.parameter_sets.result_parameter_set);
+  }
+  auto result_msg = TCPMessage(ngraph::he::MessageType::activation_result,
+                               post_activation_ciphers);
+  // Reply at the position of the request chunk
+  result_msg.set_chunk(message.offset(), message.total_count());
+  write_data_message(std::move(result_msg));
 }
 
 void ngraph::he::HESealClient::decode_to_real_vec(const seal::Plaintext& plain,
                                                   std::vector<double>& output,
-                                                  bool complex) {
+                                                  bool complex,
+                                                  size_t parameter_set) {
   assert(output.size() == 0);
+  const auto& ckks_encoder = get_parameter_set(parameter_set).ckks_encoder;
   if (complex) {
     std::vector<std::complex<double>> complex_outputs;
-    m_ckks_encoder->decode(plain, complex_outputs);
+    ckks_encoder->decode(plain, complex_outputs);
     assert(complex_outputs.size() >= m_batch_size);
     complex_outputs.resize(m_batch_size);
     complex_vec_to_real_vec(output, complex_outputs);
   } else {
-    m_ckks_encoder->decode(plain, output);
+    ckks_encoder->decode(plain, output);
     assert(m_batch_size <= output.size());
     output.resize(m_batch_size);
   }
@@ -16,13 +16,20 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/asio.hpp>
+#include <condition_variable>
+#include <future>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "client_util.hpp"
+#include "seal/activation_request.hpp"
 #include "seal/seal.h"
 #include "tcp/tcp_client.hpp"
 #include "tcp/tcp_message.hpp"
@@ -34,31 +41,110 @@ class HESealClient {
   HESealClient(const std::string& hostname, const size_t port,
                const size_t batch_size, const std::vector<float>& inputs);
 
-  ~HESealClient() = default;
+  // Connects to the server at server_uri, given as tcp://<host>:<port> or
+  // unix://<socket path>, performs one inference on inputs and closes the
+  // connection
+  HESealClient(const std::string& server_uri, const size_t batch_size,
+               const std::vector<float>& inputs);
+
+  // As above, with input_size inputs read from inputs, so callers owning the
+  // inputs in other containers need not copy them
+  HESealClient(const std::string& server_uri, const size_t batch_size,
+               const float* inputs, const size_t input_size);
+
+  // Connects to the server at server_uri and keeps the connection and keys
+  // for any number of queries passed to submit(). Nonlinearity requests are
+  // handled on num_threads threads
+  HESealClient(const std::string& server_uri, const size_t batch_size,
+               const size_t num_threads);
+
+  ~HESealClient();
+
+  // Encrypts inputs and sends them to the server as the next query. Several
+  // queries may be in flight; the server computes them in submission order.
+  // Blocks until the server sent the parameter size. Results are batch-major,
+  // i.e. the outputs of each batch element are contiguous
+  std::future<std::vector<float>> submit(const std::vector<float>& inputs);
+
+  // As above, with input_size inputs read from inputs. inputs is only read
+  // before submit returns
+  std::future<std::vector<float>> submit(const float* inputs,
+                                         const size_t input_size);
 
   void set_seal_context();
 
   void handle_message(const ngraph::he::TCPMessage& message);
 
-  void handle_relu_request(const ngraph::he::TCPMessage& message);
+  // Decrypts the ciphertexts of message, applies activation and sends the
+  // re-encrypted results
+  void handle_activation_request(
+      const ngraph::he::TCPMessage& message,
+      const ngraph::he::ActivationRequest& activation);
 
   inline void write_message(ngraph::he::TCPMessage&& message) {
     m_tcp_client->write_message(std::move(message));
   }
 
+  // Writes a chunk of a bulk message, striped over the data streams
+  inline void write_data_message(ngraph::he::TCPMessage&& message) {
+    m_tcp_client->write_data_message(std::move(message));
+  }
+
   inline bool is_done() { return m_is_done; }
 
-  inline std::vector<float> get_results() { return m_results; }
+  // Results of the inference performed by the blocking constructor
+
+  inline const std::vector<float>& get_results() const { return m_results; }
 
   void close_connection();
 
   bool complex_packing() const { return m_complex_packing; }
 
+  // Decodes plain, encoded in the given parameter set
   void decode_to_real_vec(const seal::Plaintext& plain,
-                          std::vector<double>& output, bool complex);
+                          std::vector<double>& output, bool complex,
+                          size_t parameter_set = 0);
 
  private:
+  // Encrypts inputs and sends them in chunks tagged with query_id
+  void send_inputs(size_t query_id, const float* inputs, size_t input_size);
+
+  void send_public_key();
+
+  // Creates the context and keys of an additional parameter set announced by
+  // the server, and sends the server its keys
+  void handle_parameter_set(const ngraph::he::TCPMessage& message);
+
+  // Context and keys of a parameter set, used by the function segments after
+  // a client round trip. Parameter set 0 holds the members below
+  struct ParameterSet {
+    std::shared_ptr<seal::SEALContext> context;
+    std::shared_ptr<seal::Encryptor> encryptor;
+    std::shared_ptr<seal::Decryptor> decryptor;
+    std::shared_ptr<seal::CKKSEncoder> ckks_encoder;
+    double scale;
+  };
+
+  const ParameterSet& get_parameter_set(size_t parameter_set) const;
+
+  // Encrypts values, one batch of an element, in parameter_set
+  void encrypt_values(const std::vector<double>& values,
+                      seal::Ciphertext& cipher, size_t parameter_set);
+
+  // Saves the keys and session token to the key store, if enabled
+  void save_keys();
+
+  struct Query {
+    std::promise<std::vector<float>> results_promise;
+    // Batch-major results, allocated when the first chunk arrives
+    std::shared_ptr<std::vector<float>> results;
+    size_t results_received{0};  // Number of result ciphertexts received
+  };
+
+  // Must outlive m_tcp_client
+  boost::asio::io_context m_io_context;
   std::shared_ptr<TCPClient> m_tcp_client;
+  std::thread m_io_thread;
   seal::EncryptionParameters m_encryption_params{seal::scheme_type::CKKS};
   std::shared_ptr<seal::PublicKey> m_public_key;
   std::shared_ptr<seal::SecretKey> m_secret_key;
@@ -69,11 +155,30 @@ class HESealClient {
   std::shared_ptr<seal::Evaluator> m_evaluator;
   std::shared_ptr<seal::KeyGenerator> m_keygen;
   std::shared_ptr<seal::RelinKeys> m_relin_keys;
+  std::shared_ptr<seal::GaloisKeys> m_galois_keys;
+  // File in the NGRAPH_HE_KEY_STORE directory holding the keys for the
+  // encryption parameters; empty if keys are not stored
+  std::string m_key_store_path;
+  // Lets the server resume the session with its cached keys
+  std::string m_session_token;
   double m_scale;
+  // Parameter sets by index, set before any ciphertexts are received
+  std::map<size_t, ParameterSet> m_parameter_sets;
   size_t m_batch_size;
-  bool m_is_done;
-  std::vector<float> m_inputs;   // Function inputs
-  std::vector<float> m_results;  // Function outputs
+  // Set by the message handler thread
+  std::atomic<bool> m_is_done;
+  std::vector<float> m_results;  // Function outputs of blocking inference
+
+  // Queries whose results have not been received, by query id
+  std::mutex m_query_mutex;
+  std::condition_variable m_query_cond;
+  std::map<size_t, Query> m_queries;
+  size_t m_next_query_id{0};
+  // Number of (packed) ciphertexts per query, set by the server
+  size_t m_parameter_size{0};
+
+  // Handles nonlinearity requests off the message handler thread
+  std::unique_ptr<boost::asio::thread_pool> m_nonlinearity_pool;
 
   bool m_complex_packing{std::getenv("NGRAPH_COMPLEX_PACK") != nullptr};
 };
@@ -20,9 +20,12 @@
 #include <fstream>
 #include <memory>
 #include <ostream>
+#include <sstream>
 #include <stdexcept>
 #include <unordered_set>
 
+#include "ngraph/check.hpp"
+#include "ngraph/except.hpp"
 #include "nlohmann/json.hpp"
 #include "seal/seal.h"
 
@@ -78,6 +81,12 @@ class HESealEncryptionParameters {
     return m_coeff_modulus;
   }
 
+  /// \brief Returns the chain index of fresh ciphertexts, i.e. the number of
+  /// rescalings they support. The last modulus is reserved for key switching
+  inline size_t max_chain_index() const {
+    return m_coeff_modulus.size() > 1 ? m_coeff_modulus.size() - 2 : 0;
+  }
+
  private:
   seal::EncryptionParameters m_seal_encryption_parameters{
       seal::scheme_type::CKKS};
@@ -98,18 +107,9 @@ inline ngraph::he::HESealEncryptionParameters default_ckks_parameters() {
   return params;
 }
 
-inline ngraph::he::HESealEncryptionParameters parse_config_or_use_default(
-    const std::string& scheme_name) {
-  std::unordered_set<std::string> valid_scheme_names{"HE_SEAL"};
-  if (valid_scheme_names.find(scheme_name) == valid_scheme_names.end()) {
-    throw ngraph_error("Invalid scheme name " + scheme_name);
-  }
-
-  const char* config_path = getenv("NGRAPH_HE_SEAL_CONFIG");
-  if (config_path == nullptr) {
-    return default_ckks_parameters();
-  }
-
+/// \brief Parses the encryption parameters in the JSON file config_path
+inline ngraph::he::HESealEncryptionParameters parse_config(
+    const std::string& config_path, const std::string& scheme_name) {
   try {
     // Read file to string
     std::ifstream f(config_path);
@@ -155,9 +155,79 @@ inline ngraph::he::HESealEncryptionParameters parse_config_or_use_default(
 
   } catch (const std::exception& e) {
     std::stringstream ss;
-    ss << "Error parsing NGRAPH_HE_SEAL_CONFIG: " << e.what();
+    ss << "Error parsing " << config_path << ": " << e.what();
     throw ngraph_error(ss.str());
   }
 }
+
+/// \brief Saves parms to the JSON file config_path, in the format read by
+/// parse_config
+inline void save_config(const HESealEncryptionParameters& parms,
+                        const std::string& config_path) {
+  nlohmann::json js;
+  js["scheme_name"] = parms.scheme_name();
+  js["poly_modulus_degree"] = parms.poly_modulus_degree();
+  js["security_level"] = parms.security_level();
+  js["coeff_modulus"] = parms.coeff_modulus_bits();
+
+  std::ofstream f(config_path);
+  f << js.dump(2) << std::endl;
+  if (!f.good()) {
+    throw ngraph_error("Error writing " + config_path);
+  }
+}
+
+/// \brief Returns the smallest parameters of security_level whose fresh
+/// ciphertexts support levels rescalings at a scale of scale_bits bits, with
+/// at least slot_count slots. The first and the key switching moduli carry
+/// 6 more bits than the scale, like the configs in configs/; choose_scale
+/// then picks the last of the levels moduli of scale_bits bits as scale
+inline HESealEncryptionParameters recommend_encryption_parameters(
+    size_t levels, size_t slot_count, int scale_bits,
+    std::uint64_t security_level = 128) {
+  const int outer_bits = scale_bits + 6;
+  NGRAPH_CHECK(outer_bits <= 60, "Scale of ", scale_bits, " bits is too large");
+  std::vector<int> coeff_modulus_bits(levels + 2, scale_bits);
+  coeff_modulus_bits.front() = outer_bits;
+  coeff_modulus_bits.back() = outer_bits;
+  const int total_bits = 2 * outer_bits + static_cast<int>(levels) * scale_bits;
+
+  seal::sec_level_type sec_level = seal::sec_level_type::tc128;
+  if (security_level == 192) {
+    sec_level = seal::sec_level_type::tc192;
+  } else if (security_level == 256) {
+    sec_level = seal::sec_level_type::tc256;
+  } else {
+    NGRAPH_CHECK(security_level == 128, "Invalid security level ",
+                 security_level);
+  }
+  for (std::uint64_t poly_modulus_degree = 1024; poly_modulus_degree <= 32768;
+       poly_modulus_degree *= 2) {
+    if (poly_modulus_degree / 2 >= slot_count &&
+        total_bits <=
+            seal::CoeffModulus::MaxBitCount(poly_modulus_degree, sec_level)) {
+      return HESealEncryptionParameters("HE_SEAL", poly_modulus_degree,
+                                        security_level, coeff_modulus_bits);
+    }
+  }
+  std::stringstream ss;
+  ss << "No parameters of security level " << security_level << " support "
+     << levels << " levels at a scale of " << scale_bits << " bits";
+  throw ngraph_error(ss.str());
+}
+
+inline ngraph::he::HESealEncryptionParameters parse_config_or_use_default(
+    const std::string& scheme_name) {
+  std::unordered_set<std::string> valid_scheme_names{"HE_SEAL"};
+  if (valid_scheme_names.find(scheme_name) == valid_scheme_names.end()) {
+    throw ngraph_error("Invalid scheme name " + scheme_name);
+  }
+
+  const char* config_path = getenv("NGRAPH_HE_SEAL_CONFIG");
+  if (config_path == nullptr) {
+    return default_ckks_parameters();
+  }
+  return parse_config(config_path, scheme_name);
+}
 }  // namespace he
 }  // namespace ngraph
@@ -14,14 +14,20 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <functional>
-#include <limits>
+#include <future>
+#include <iterator>
+#include <numeric>
 #include <unordered_set>
 
 #include "client_util.hpp"
 #include "he_plain_tensor.hpp"
 #include "he_seal_cipher_tensor.hpp"
 #include "he_tensor.hpp"
+#include "kernel/activation_seal.hpp"
 #include "kernel/add_seal.hpp"
 #include "kernel/avg_pool_seal.hpp"
 #include "kernel/batch_norm_inference_seal.hpp"
@@ -31,18 +37,22 @@
 #include "kernel/constant_seal.hpp"
 #include "kernel/convolution_seal.hpp"
 #include "kernel/dot_seal.hpp"
+#include "kernel/linear_plan_seal.hpp"
 #include "kernel/max_pool_seal.hpp"
 #include "kernel/minimum_seal.hpp"
 #include "kernel/multiply_seal.hpp"
 #include "kernel/negate_seal.hpp"
 #include "kernel/pad_seal.hpp"
+#include "kernel/polynomial_seal.hpp"
 #include "kernel/relu_seal.hpp"
 #include "kernel/reshape_seal.hpp"
 #include "kernel/result_seal.hpp"
 #include "kernel/reverse_seal.hpp"
+#include "kernel/scale_division_seal.hpp"
 #include "kernel/slice_seal.hpp"
 #include "kernel/subtract_seal.hpp"
 #include "kernel/sum_seal.hpp"
+#include "kernel/winograd_convolution_seal.hpp"
 #include "ngraph/assertion.hpp"
 #include "ngraph/descriptor/layout/dense_tensor_layout.hpp"
 #include "ngraph/op/avg_pool.hpp"
@@ -59,6 +69,7 @@
 #include "ngraph/op/result.hpp"
 #include "ngraph/op/reverse.hpp"
 #include "ngraph/op/slice.hpp"
+#include "ngraph/op/softmax.hpp"
 #include "ngraph/op/sum.hpp"
 #include "ngraph/pass/assign_layout.hpp"
 #include "ngraph/pass/constant_folding.hpp"
@@ -70,11 +81,21 @@
 #include "ngraph/pass/visualize_tree.hpp"
 #include "ngraph/runtime/backend.hpp"
 #include "ngraph/util.hpp"
+#include "op/biased_convolution.hpp"
+#include "op/biased_dot.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/scale_division.hpp"
+#include "pass/he_batch_norm_folding.hpp"
+#include "pass/he_depth_analysis.hpp"
 #include "pass/he_fusion.hpp"
+#include "pass/he_linear_composition.hpp"
 #include "pass/he_liveness.hpp"
+#include "pass/he_rescale_placement.hpp"
+#include "pass/he_scale_planning.hpp"
+#include "seal/activation_request.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/he_seal_executable.hpp"
+#include "seal/round_trip_parameter_sets.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 
@@ -94,13 +115,21 @@ ngraph::he::HESealExecutable::HESealExecutable(
       m_enable_client(enable_client),
       m_batch_size(1),
       m_port(34000),
-      m_relu_done(false),
+      m_server_uri("tcp://*:" + std::to_string(m_port)),
+      m_activation_done(false),
       m_max_done(false),
       m_result_done(false),
       m_session_started(false),
       m_client_inputs_received(false) {
   m_context = he_seal_backend.get_context();
 
+  if (std::getenv("NGRAPH_HE_SERVER_URI") != nullptr) {
+    set_server_uri(std::getenv("NGRAPH_HE_SERVER_URI"));
+  }
+  if (std::getenv("NGRAPH_HE_DATA_STREAMS") != nullptr) {
+    m_max_data_streams = std::stoul(std::getenv("NGRAPH_HE_DATA_STREAMS"));
+  }
+
   if (std::getenv("NGRAPH_VOPS") != nullptr) {
     std::string verbose_ops_str(std::getenv("NGRAPH_VOPS"));
     verbose_ops_str = ngraph::to_lower(verbose_ops_str);
@@ -117,6 +146,27 @@ ngraph::he::HESealExecutable::HESealExecutable(
     }
   }
 
+  if (std::getenv("NGRAPH_HE_POLY_ACTIVATION") != nullptr) {
+    m_polynomial_activation = PolynomialActivation::parse(
+        ngraph::to_lower(std::getenv("NGRAPH_HE_POLY_ACTIVATION")));
+    NGRAPH_INFO << "Replacing Relu and BoundedRelu by a polynomial of degree "
+                << m_polynomial_activation.degree() << " and depth "
+                << m_polynomial_activation.depth();
+  }
+
+  if (const char* precision_bits = std::getenv("NGRAPH_HE_PRECISION_BITS")) {
+    // The scale adds 10 bits to the precision, and SEAL primes have at most
+    // 60 bits
+    char* end = nullptr;
+    const long bits = std::strtol(precision_bits, &end, 10);
+    NGRAPH_CHECK(end != precision_bits && *end == '\0' && bits >= 1 &&
+                     bits <= 50,
+                 "NGRAPH_HE_PRECISION_BITS must be an integer in [1, 50], got ",
+                 precision_bits);
+    m_precision_bits = static_cast<int>(bits);
+  }
+  m_winograd = HESealBackend::flag_to_bool(std::getenv("NGRAPH_HE_WINOGRAD"));
+
   m_is_compiled = true;
   ngraph::pass::Manager pass_manager;
   pass_manager.register_pass<ngraph::pass::LikeReplacement>();
@@ -129,6 +179,31 @@ ngraph::he::HESealExecutable::HESealExecutable(
 
   ngraph::pass::Manager pass_manager_he;
   pass_manager_he.register_pass<ngraph::he::pass::HEFusion>();
+  pass_manager_he.register_pass<ngraph::he::pass::HEBatchNormFolding>();
+  pass_manager_he.register_pass<ngraph::he::pass::HELinearComposition>();
+  // Encrypted biases are not plaintexts
+  if (!m_encrypt_model) {
+    pass_manager_he.register_pass<ngraph::he::pass::HEBiasFusion>();
+  }
+  // Naive rescaling rescales every product, so planned scales would only
+  // lose precision
+  if (HESealBackend::flag_to_bool(std::getenv("NGRAPH_HE_SCALE_PLANNING")) &&
+      !m_encrypt_model && !he_seal_backend.naive_rescaling()) {
+    // The scale adds bits for the rescaling noise
+    m_scale_planning =
+        pass_manager_he.register_pass<ngraph::he::pass::HEScalePlanning>(
+            m_precision_bits, m_precision_bits + 10);
+  }
+  m_depth_analysis =
+      pass_manager_he.register_pass<ngraph::he::pass::HEDepthAnalysis>(
+          m_encrypt_model, he_seal_backend.naive_rescaling(),
+          m_polynomial_activation, m_scale_planning);
+  // Naive rescaling rescales each product in its kernel
+  if (!he_seal_backend.naive_rescaling()) {
+    m_rescale_placement =
+        pass_manager_he.register_pass<ngraph::he::pass::HERescalePlacement>(
+            m_depth_analysis);
+  }
   // Run liveness pass after all other passes (otherwise BoundedRelu nodes won't
   // have liveness_free_list set)
   pass_manager_he.register_pass<ngraph::he::pass::HELiveness>();
@@ -139,6 +214,11 @@ ngraph::he::HESealExecutable::HESealExecutable(
     m_wrapped_nodes.emplace_back(node);
   }
   set_parameters_and_results(*function);
+  set_eval_key_request();
+  set_stream_input_op();
+  set_linear_plans();
+  set_winograd_convolutions();
+  set_convolution_taps();
 
   // Constant, for example, cannot be packed
   if (get_parameters().size() > 0) {
@@ -148,12 +228,455 @@ ngraph::he::HESealExecutable::HESealExecutable(
     }
   }
 
+  check_encryption_parameters();
+
   if (m_enable_client) {
     NGRAPH_INFO << "Setting up client in constructor";
     client_setup();
   }
 }
 
+void ngraph::he::HESealExecutable::set_eval_key_request() {
+  const std::unordered_set<const Node*>& cipher_nodes =
+      m_depth_analysis->cipher_nodes();
+  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+    const Node* node = wrapped.get_node().get();
+    if (cipher_nodes.find(node) == cipher_nodes.end()) {
+      continue;
+    }
+    size_t cipher_input_count = 0;
+    for (const auto& input : node->inputs()) {
+      if (cipher_nodes.find(input.get_source_output().get_node()) !=
+          cipher_nodes.end()) {
+        cipher_input_count++;
+      }
+    }
+
+    switch (wrapped.get_typeid()) {
+      case OP_TYPEID::BiasedConvolution:
+      case OP_TYPEID::BiasedDot:
+      case OP_TYPEID::Convolution:
+      case OP_TYPEID::Dot:
+      case OP_TYPEID::Multiply:
+        if (cipher_input_count > 1) {
+          m_eval_key_request.relin_keys = true;
+        }
+        break;
+      case OP_TYPEID::BoundedRelu:
+      case OP_TYPEID::Relu:
+        // Powers of the input are products of ciphertexts
+        if (m_polynomial_activation.degree() > 1) {
+          m_eval_key_request.relin_keys = true;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  // No kernel rotates ciphertexts yet, so Galois keys are never requested.
+  NGRAPH_INFO << "Client relinearization keys "
+              << (m_eval_key_request.relin_keys ? "required" : "not required");
+}
+
+void ngraph::he::HESealExecutable::set_stream_input_op() {
+  // Stream the client parameter into a Convolution with plaintext filter, if
+  // the Convolution is the parameter's only user
+  if (get_parameters().size() != 1 || m_encrypt_model) {
+    return;
+  }
+  const auto& param = get_parameters()[0];
+  const auto users = param->get_users();
+  if (users.size() != 1 || (users[0]->description() != "Convolution" &&
+                            users[0]->description() != "BiasedConvolution")) {
+    return;
+  }
+  const auto& convolution = users[0];
+  if (convolution->input(0).get_source_output().get_node() != param.get() ||
+      !convolution->input(1).get_source_output().get_node()->is_constant()) {
+    return;
+  }
+  m_stream_input_op = convolution.get();
+  NGRAPH_INFO << "Streaming client inputs into " << convolution->get_name();
+}
+
+ngraph::he::ConvolutionTaps ngraph::he::HESealExecutable::make_convolution_taps(
+    const ngraph::Node& node) const {
+  auto make_taps = [this, &node](const auto& c) {
+    // The shapes of the kernel arguments
+    Shape arg0_shape = node.get_input_shape(0);
+    Shape out_shape = node.get_output_shape(0);
+    if (m_batch_data) {
+      arg0_shape = ngraph::he::HETensor::pack_shape(arg0_shape);
+      out_shape = ngraph::he::HETensor::pack_shape(out_shape);
+    }
+    return ngraph::he::ConvolutionTaps(
+        arg0_shape, node.get_input_shape(1), out_shape,
+        c.get_window_movement_strides(), c.get_window_dilation_strides(),
+        c.get_padding_below(), c.get_padding_above(),
+        c.get_data_dilation_strides());
+  };
+  if (node.description() == "BiasedConvolution") {
+    return make_taps(static_cast<const op::BiasedConvolution&>(node));
+  }
+  NGRAPH_CHECK(node.description() == "Convolution", "Node ", node.get_name(),
+               " is no convolution");
+  return make_taps(static_cast<const op::Convolution&>(node));
+}
+
+void ngraph::he::HESealExecutable::set_convolution_taps() {
+  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+    const Node& node = *wrapped.get_node();
+    if (wrapped.get_typeid() != OP_TYPEID::Convolution &&
+        wrapped.get_typeid() != OP_TYPEID::BiasedConvolution) {
+      continue;
+    }
+    // Convolutions computed with an index plan or the Winograd kernel need no
+    // tables, unless their inputs stream from the client
+    if (&node != m_stream_input_op &&
+        (linear_plan(node) != nullptr ||
+         m_winograd_convolutions.find(&node) !=
+             m_winograd_convolutions.end())) {
+      continue;
+    }
+    m_convolution_taps.emplace(&node, make_convolution_taps(node));
+  }
+}
+
+const ngraph::he::ConvolutionTaps&
+ngraph::he::HESealExecutable::convolution_taps(const ngraph::Node& node) {
+  auto it = m_convolution_taps.find(&node);
+  if (it == m_convolution_taps.end()) {
+    it = m_convolution_taps.emplace(&node, make_convolution_taps(node)).first;
+  }
+  return it->second;
+}
+
+void ngraph::he::HESealExecutable::set_linear_plans() {
+  // Encrypted weights are no plaintexts
+  if (m_encrypt_model) {
+    return;
+  }
+  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+    const Node& node = *wrapped.get_node();
+    const OP_TYPEID op_typeid = wrapped.get_typeid();
+    const bool convolution = op_typeid == OP_TYPEID::Convolution ||
+                             op_typeid == OP_TYPEID::BiasedConvolution;
+    const bool dot =
+        op_typeid == OP_TYPEID::Dot || op_typeid == OP_TYPEID::BiasedDot;
+    if ((!convolution && !dot) || node.get_element_type() != element::f32 ||
+        !m_depth_analysis->is_cipher(&node)) {
+      continue;
+    }
+    // The Convolution filter is the second argument, Dot weights may be
+    // either argument
+    size_t weight_arg = 2;
+    for (size_t arg = 0; arg < 2; ++arg) {
+      const Node* arg_node = node.input(arg).get_source_output().get_node();
+      if (arg_node->is_constant() && (dot || arg == 1) &&
+          m_depth_analysis->is_cipher(
+              node.input(1 - arg).get_source_output().get_node())) {
+        weight_arg = arg;
+      }
+    }
+    // Packing applies to the first argument, which must not be the weights
+    if (weight_arg == 2 || (weight_arg == 0 && m_batch_data)) {
+      continue;
+    }
+
+    // The shapes of the kernel arguments
+    Shape arg0_shape = node.get_input_shape(0);
+    Shape out_shape = node.get_output_shape(0);
+    if (m_batch_data) {
+      arg0_shape = ngraph::he::HETensor::pack_shape(arg0_shape);
+      out_shape = ngraph::he::HETensor::pack_shape(out_shape);
+    }
+    const Shape& arg1_shape = node.get_input_shape(1);
+
+    const Node* weights = node.input(weight_arg).get_source_output().get_node();
+    const std::vector<float> weight_vals =
+        static_cast<const op::Constant*>(weights)->get_vector<float>();
+    const double encoding_scale =
+        m_scale_planning == nullptr ? 0
+                                    : m_scale_planning->encoding_scale(weights);
+    std::unique_ptr<LinearPlan> plan;
+    if (dot) {
+      const size_t reduction_axes_count =
+          op_typeid == OP_TYPEID::Dot
+              ? static_cast<const op::Dot&>(node).get_reduction_axes_count()
+              : static_cast<const op::BiasedDot&>(node)
+                    .get_reduction_axes_count();
+      plan = std::make_unique<LinearPlan>(
+          ngraph::he::dot_taps(arg0_shape, arg1_shape, out_shape,
+                               reduction_axes_count),
+          weight_vals, weight_arg, encoding_scale);
+    } else {
+      // The taps of one output at a time are expanded from the windows
+      const ConvolutionTaps taps = make_convolution_taps(node);
+      plan = std::make_unique<LinearPlan>(
+          taps.output_count(),
+          [&taps](size_t out_index) { return taps.taps(out_index); },
+          weight_vals, weight_arg, encoding_scale);
+    }
+    if (plan->multiply_count() >= plan->tap_count()) {
+      continue;
+    }
+    NGRAPH_INFO << "Index plan of " << node.get_name() << " needs "
+                << plan->multiply_count() << " instead of "
+                << plan->tap_count() << " multiplications";
+    m_linear_plans[&node] = std::move(plan);
+  }
+}
+
+void ngraph::he::HESealExecutable::set_winograd_convolutions() {
+  // Encrypted filters are no plaintexts
+  if (!m_winograd || m_encrypt_model) {
+    return;
+  }
+  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+    const Node& node = *wrapped.get_node();
+    auto set_winograd = [this, &node](const auto& c) {
+      const Shape& arg1_shape = node.get_input_shape(1);
+      auto filter = std::dynamic_pointer_cast<op::Constant>(
+          node.input(1).get_source_output().get_node_shared_ptr());
+      if (filter == nullptr || filter->get_element_type() != element::f32 ||
+          !ngraph::he::winograd_applicable(
+              arg1_shape, c.get_window_movement_strides(),
+              c.get_window_dilation_strides(),
+              c.get_data_dilation_strides())) {
+        return;
+      }
+      Shape out_shape = node.get_output_shape(0);
+      if (m_batch_data) {
+        out_shape = ngraph::he::HETensor::pack_shape(out_shape);
+      }
+      const size_t multiply_count =
+          ngraph::he::winograd_multiply_count(arg1_shape, out_shape);
+      const LinearPlan* plan = linear_plan(node);
+      const size_t tap_count = plan != nullptr
+                                   ? plan->multiply_count()
+                                   : make_convolution_taps(node).tap_count();
+      if (multiply_count >= tap_count) {
+        return;
+      }
+      NGRAPH_INFO << "Winograd convolution of " << node.get_name() << " needs "
+                  << multiply_count << " instead of " << tap_count
+                  << " multiplications";
+      std::vector<HEPlaintext> filter_plaintexts;
+      const double encoding_scale =
+          m_scale_planning == nullptr
+              ? 0
+              : m_scale_planning->encoding_scale(filter.get());
+      for (float value : filter->get_vector<float>()) {
+        filter_plaintexts.emplace_back(value);
+        filter_plaintexts.back().encoding_scale() = encoding_scale;
+      }
+      m_winograd_convolutions[&node] = WinogradConvolution{
+          c.get_padding_below(), ngraph::he::winograd_filter_transform(
+                                     filter_plaintexts, arg1_shape)};
+    };
+    if (wrapped.get_typeid() == OP_TYPEID::Convolution) {
+      set_winograd(static_cast<const op::Convolution&>(node));
+    } else if (wrapped.get_typeid() == OP_TYPEID::BiasedConvolution) {
+      set_winograd(static_cast<const op::BiasedConvolution&>(node));
+    }
+  }
+}
+
+void ngraph::he::HESealExecutable::set_parameter_sets() {
+  const char* segment_configs = std::getenv("NGRAPH_HE_SEAL_SEGMENT_CONFIGS");
+  if (segment_configs == nullptr) {
+    return;
+  }
+  if (m_encrypt_model) {
+    // Encrypted constants may be used in several segments
+    NGRAPH_WARN << "NGRAPH_HE_SEAL_SEGMENT_CONFIGS is not supported with "
+                   "NGRAPH_ENCRYPT_MODEL";
+    return;
+  }
+
+  // Parameter set 0 holds the backend parameters, with which the client
+  // encrypts its inputs
+  std::vector<HESealEncryptionParameters> candidates{
+      m_he_seal_backend.get_encryption_parameters()};
+  for (const std::string& config_path : split(segment_configs, ',', true)) {
+    candidates.emplace_back(parse_config(config_path, "HE_SEAL"));
+  }
+
+  if (m_depth_analysis->combines_segments()) {
+    NGRAPH_INFO << "Using one parameter set, since the function combines "
+                   "ciphertexts of different segments";
+    return;
+  }
+  const std::vector<size_t>& segment_levels =
+      m_depth_analysis->segment_levels();
+  if (segment_levels.size() == 1) {
+    NGRAPH_INFO << "Using one parameter set, since the function has no client "
+                   "round trips";
+    return;
+  }
+
+  // Each segment after a round trip uses the cheapest candidate with enough
+  // slots and levels, or the deepest candidate if none suffices
+  const size_t slot_count =
+      m_complex_packing ? (m_batch_size + 1) / 2 : m_batch_size;
+  auto cost = [](const HESealEncryptionParameters& parms) {
+    return parms.poly_modulus_degree() * parms.coeff_modulus().size();
+  };
+  std::vector<size_t> segment_parameter_sets(segment_levels.size(), 0);
+  for (size_t segment = 1; segment < segment_levels.size(); ++segment) {
+    const size_t levels = segment_levels[segment];
+    size_t best = 0;
+    bool best_fits = false;
+    for (size_t idx = 0; idx < candidates.size(); ++idx) {
+      const auto& candidate = candidates[idx];
+      if (candidate.poly_modulus_degree() / 2 < slot_count) {
+        continue;
+      }
+      const bool fits = candidate.max_chain_index() >= levels;
+      const auto& current = candidates[best];
+      if (fits && (!best_fits || cost(candidate) < cost(current))) {
+        best = idx;
+        best_fits = true;
+      } else if (!fits && !best_fits &&
+                 candidate.max_chain_index() > current.max_chain_index()) {
+        best = idx;
+      }
+    }
+    segment_parameter_sets[segment] = best;
+    NGRAPH_INFO << "Segment " << segment << " of " << levels
+                << " levels uses parameter set " << best << " (N = "
+                << candidates[best].poly_modulus_degree() << ", "
+                << candidates[best].coeff_modulus().size() << " moduli)";
+
+    if (best != 0 && m_parameter_set_backends.find(best) ==
+                         m_parameter_set_backends.end()) {
+      auto backend = std::make_shared<HESealBackend>(candidates[best]);
+      backend->complex_packing() = m_he_seal_backend.complex_packing();
+      backend->naive_rescaling() = m_he_seal_backend.naive_rescaling();
+      backend->set_pack_data(m_he_seal_backend.pack_data());
+      m_parameter_set_backends[best] = backend;
+    }
+  }
+  for (const Node* node : m_depth_analysis->cipher_nodes()) {
+    size_t parameter_set =
+        segment_parameter_sets[m_depth_analysis->segment(node)];
+    if (parameter_set != 0) {
+      m_node_parameter_sets[node] = parameter_set;
+    }
+  }
+}
+
+void ngraph::he::HESealExecutable::check_encryption_parameters() {
+  // Segments after a client round trip may use other parameters
+  const char* segment_configs = std::getenv("NGRAPH_HE_SEAL_SEGMENT_CONFIGS");
+  const size_t levels = m_enable_client && segment_configs != nullptr
+                            ? m_depth_analysis->segment_levels()[0]
+                            : m_depth_analysis->max_levels();
+  NGRAPH_INFO << "Ciphertexts consume up to " << levels
+              << " levels between client round trips";
+
+  // The scale adds bits for the rescaling noise
+  const int scale_bits = m_precision_bits + 10;
+
+  const auto& parms = m_he_seal_backend.get_encryption_parameters();
+  const size_t slot_count =
+      m_complex_packing ? (m_batch_size + 1) / 2 : m_batch_size;
+  auto cost = [](const HESealEncryptionParameters& p) {
+    return p.poly_modulus_degree() * p.coeff_modulus().size();
+  };
+  try {
+    HESealEncryptionParameters recommended = recommend_encryption_parameters(
+        levels, slot_count, scale_bits,
+        std::max<std::uint64_t>(parms.security_level(), 128));
+    std::stringstream ss;
+    ss << "N = " << recommended.poly_modulus_degree() << ", coeff_modulus = {";
+    for (size_t i = 0; i < recommended.coeff_modulus_bits().size(); ++i) {
+      ss << (i == 0 ? "" : ", ") << recommended.coeff_modulus_bits()[i];
+    }
+    ss << "}, scale = 2^" << scale_bits;
+
+    if (parms.max_chain_index() < levels) {
+      NGRAPH_WARN << "Encryption parameters support only "
+                  << parms.max_chain_index()
+                  << " levels; the smallest sufficient parameters are "
+                  << ss.str();
+    } else if (cost(recommended) < cost(parms)) {
+      NGRAPH_INFO << "Smaller encryption parameters suffice: " << ss.str();
+    }
+    const char* config_out = std::getenv("NGRAPH_HE_SEAL_CONFIG_OUT");
+    if (config_out != nullptr) {
+      save_config(recommended, config_out);
+      NGRAPH_INFO << "Wrote encryption parameters " << ss.str() << " to "
+                  << config_out;
+    }
+  } catch (const std::exception& e) {
+    NGRAPH_WARN << "Cannot recommend encryption parameters: " << e.what();
+  }
+}
+
+void ngraph::he::HESealExecutable::send_parameter_sets() {
+  for (const auto& parameter_set_backend : m_parameter_set_backends) {
+    std::uint64_t parameter_set = parameter_set_backend.first;
+    std::stringstream param_stream;
+    parameter_set_backend.second->get_encryption_parameters().save(
+        param_stream);
+
+    // The client generates the same evaluation keys as for parameter set 0
+    std::stringstream prefix_stream;
+    prefix_stream.write(reinterpret_cast<const char*>(&parameter_set),
+                        sizeof(parameter_set));
+    m_eval_key_request.save(prefix_stream);
+
+    NGRAPH_INFO << "Sending encryption parameters of parameter set "
+                << parameter_set;
+    m_session->do_write(TCPMessage(MessageType::parameter_set, 1,
+                                   std::move(param_stream),
+                                   prefix_stream.str()));
+  }
+}
+
+ngraph::he::HESealBackend& ngraph::he::HESealExecutable::parameter_set_backend(
+    size_t parameter_set) {
+  if (parameter_set == 0) {
+    return m_he_seal_backend;
+  }
+  auto it = m_parameter_set_backends.find(parameter_set);
+  NGRAPH_CHECK(it != m_parameter_set_backends.end(), "Unknown parameter set ",
+               parameter_set);
+  return *it->second;
+}
+
+size_t ngraph::he::HESealExecutable::get_parameter_set(
+    const Node& node) const {
+  auto it = m_node_parameter_sets.find(&node);
+  return it == m_node_parameter_sets.end() ? 0 : it->second;
+}
+
+size_t ngraph::he::HESealExecutable::input_parameter_set(
+    const Node& node) const {
+  // Plaintext arguments are in parameter set 0, and all ciphertext arguments
+  // are in the same parameter set
+  size_t parameter_set = 0;
+  for (const auto& input : node.inputs()) {
+    parameter_set = std::max(
+        parameter_set,
+        get_parameter_set(*input.get_source_output().get_node()));
+  }
+  return parameter_set;
+}
+
+void ngraph::he::HESealExecutable::wait_for_parameter_set_keys(
+    size_t parameter_set) {
+  if (parameter_set == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> mlock(m_parameter_set_mutex);
+  m_parameter_set_cond.wait(mlock, [this, parameter_set]() {
+    return m_parameter_set_keys_received.find(parameter_set) !=
+           m_parameter_set_keys_received.end();
+  });
+}
+
 void ngraph::he::HESealExecutable::check_client_supports_function() {
   NGRAPH_CHECK(get_parameters().size() == 1,
                "HESealExecutable only supports parameter size 1 (got ",
@@ -170,6 +693,7 @@ void ngraph::he::HESealExecutable::client_setup() {
   if (first_setup) {
     NGRAPH_INFO << "Enable client";
     check_client_supports_function();
+    set_parameter_sets();
 
     // Start server
     NGRAPH_INFO << "Starting server";
@@ -187,6 +711,17 @@ void ngraph::he::HESealExecutable::client_setup() {
                         std::bind(&HESealExecutable::session_started, this));
     m_session->do_write(std::move(parms_message));
 
+    if (m_max_data_streams > 0) {
+      // Offer data streams; the client replies with how many it opens
+      std::uint64_t data_streams = m_max_data_streams;
+      std::stringstream data_streams_stream;
+      data_streams_stream.write(reinterpret_cast<const char*>(&data_streams),
+                                sizeof(data_streams));
+      m_session->do_write(TCPMessage(MessageType::data_streams, 1,
+                                     std::move(data_streams_stream)));
+    }
+    send_parameter_sets();
+
     first_setup = false;
 
   } else {
@@ -198,13 +733,14 @@ void ngraph::he::HESealExecutable::accept_connection() {
   NGRAPH_INFO << "Server accepting connections";
   auto server_callback = bind(&ngraph::he::HESealExecutable::handle_message,
                               this, std::placeholders::_1);
+  m_message_queue = std::make_shared<TCPMessageQueue>(server_callback);
 
-  m_acceptor->async_accept([this, server_callback](boost::system::error_code ec,
-                                                   tcp::socket socket) {
+  m_acceptor->async_accept([this](boost::system::error_code ec,
+                                  stream_protocol::socket socket) {
     if (!ec) {
       NGRAPH_INFO << "Connection accepted";
       m_session =
-          std::make_shared<TCPSession>(std::move(socket), server_callback);
+          std::make_shared<TCPSession>(std::move(socket), m_message_queue);
       m_session->start();
       NGRAPH_INFO << "Session started";
 
@@ -218,12 +754,83 @@ void ngraph::he::HESealExecutable::accept_connection() {
   });
 }
 
+void ngraph::he::HESealExecutable::accept_data_streams() {
+  m_acceptor->async_accept([this](boost::system::error_code ec,
+                                  stream_protocol::socket socket) {
+    if (ec) {
+      NGRAPH_INFO << "error accepting data stream " << ec.message();
+      return;
+    }
+    // Data sessions share the message queue, so all messages are handled by
+    // the same thread
+    auto data_session =
+        std::make_shared<TCPSession>(std::move(socket), m_message_queue);
+    data_session->start();
+
+    std::lock_guard<std::mutex> guard(m_session_mutex);
+    m_data_sessions.emplace_back(data_session);
+    NGRAPH_INFO << "Data stream " << m_data_sessions.size() << " of "
+                << m_num_data_streams << " accepted";
+    m_session_cond.notify_all();
+    if (m_data_sessions.size() < m_num_data_streams) {
+      accept_data_streams();
+    }
+  });
+}
+
+std::vector<std::future<void>> ngraph::he::HESealExecutable::write_chunks(
+    size_t count, size_t max_chunk_count,
+    const std::function<TCPMessage(size_t, size_t)>& make_chunk,
+    size_t granularity) {
+  std::vector<std::shared_ptr<TCPSession>> sessions;
+  {
+    std::unique_lock<std::mutex> mlock(m_session_mutex);
+    m_session_cond.wait(mlock, [this]() {
+      return m_data_sessions.size() >= m_num_data_streams;
+    });
+    sessions = m_data_sessions;
+  }
+  if (sessions.empty()) {
+    sessions.emplace_back(m_session);
+  }
+
+  // Use at least one chunk per stream, so small messages are striped too.
+  // Chunks hold whole multiples of granularity, except possibly the last
+  size_t stripe_count = (count + sessions.size() - 1) / sessions.size();
+  size_t chunk_count = std::min(max_chunk_count, stripe_count);
+  chunk_count = std::max(granularity, chunk_count / granularity * granularity);
+  std::vector<std::future<void>> writes;
+  for (size_t offset = 0; offset < count; offset += chunk_count) {
+    auto& session = sessions[m_next_data_session++ % sessions.size()];
+    writes.emplace_back(session->do_write(
+        make_chunk(offset, std::min(chunk_count, count - offset))));
+  }
+  return writes;
+}
+
+void ngraph::he::HESealExecutable::set_server_uri(const std::string& uri) {
+  TransportURI transport_uri(uri);
+  if (transport_uri.scheme() == TransportURI::Scheme::tcp) {
+    m_port = transport_uri.port();
+  }
+  m_server_uri = uri;
+}
+
 void ngraph::he::HESealExecutable::start_server() {
-  tcp::resolver resolver(m_io_context);
-  tcp::endpoint server_endpoints(tcp::v4(), m_port);
-  m_acceptor = std::make_unique<tcp::acceptor>(m_io_context, server_endpoints);
-  boost::asio::socket_base::reuse_address option(true);
-  m_acceptor->set_option(option);
+  TransportURI uri(m_server_uri);
+  NGRAPH_INFO << "Server listening at " << uri.to_string();
+  if (uri.scheme() == TransportURI::Scheme::unix_socket) {
+    // Remove the socket file left by a previous server
+    std::remove(uri.path().c_str());
+  }
+  stream_protocol::endpoint server_endpoint = uri.listen_endpoint();
+  m_acceptor = std::make_unique<stream_acceptor>(m_io_context);
+  m_acceptor->open(server_endpoint.protocol());
+  if (uri.scheme() == TransportURI::Scheme::tcp) {
+    m_acceptor->set_option(boost::asio::socket_base::reuse_address(true));
+  }
+  m_acceptor->bind(server_endpoint);
+  m_acceptor->listen();
 
   accept_connection();
   // Create thread-local variable to prevent passing "this"
@@ -241,31 +848,12 @@ void ngraph::he::HESealExecutable::handle_message(
 
   if (msg_type == MessageType::execute) {
     size_t count = message.count();
+    size_t offset = message.offset();
+    size_t total_count = message.total_count();
     size_t ciphertext_size = message.element_size();
 
     NGRAPH_CHECK(m_context != nullptr);
 
-    NGRAPH_INFO << "Loading " << count << " ciphertexts";
-    std::vector<seal::Ciphertext> ciphertexts(count);
-#pragma omp parallel for
-    for (size_t i = 0; i < count; ++i) {
-      seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
-      std::stringstream stream;
-      stream.write(message.data_ptr() + i * ciphertext_size, ciphertext_size);
-      seal::Ciphertext c(pool);
-      c.load(m_context, stream);
-      ciphertexts[i] = c;
-    }
-    NGRAPH_INFO << "Done loading " << count << " ciphertexts";
-    std::vector<std::shared_ptr<ngraph::he::SealCiphertextWrapper>>
-        he_cipher_inputs(ciphertexts.size());
-#pragma omp parallel for
-    for (size_t cipher_idx = 0; cipher_idx < ciphertexts.size(); ++cipher_idx) {
-      auto wrapper = std::make_shared<ngraph::he::SealCiphertextWrapper>(
-          ciphertexts[cipher_idx]);
-      he_cipher_inputs[cipher_idx] = wrapper;
-    }
-
     // only support parameter size 1 for now
     NGRAPH_CHECK(get_parameters().size() == 1,
                  "HESealExecutable only supports parameter size 1 (got ",
@@ -276,53 +864,37 @@ void ngraph::he::HESealExecutable::handle_message(
                  "HESealExecutable only supports output size 1 (got ",
                  get_results().size(), "");
 
-    // Load function with parameters
     size_t num_param_elements = 0;
     const ParameterVector& input_parameters = get_parameters();
     for (auto input_param : input_parameters) {
       num_param_elements += shape_size(input_param->get_shape());
     }
     num_param_elements /= m_batch_size;
-    NGRAPH_CHECK(count == num_param_elements, "Count ", count,
+    NGRAPH_CHECK(total_count == num_param_elements, "Count ", total_count,
                  " does not match number of parameter elements ( ",
                  num_param_elements, ")");
 
-    NGRAPH_INFO << "Setting m_client_inputs";
-    size_t parameter_size_index = 0;
-    for (auto input_param : input_parameters) {
-      const auto& shape = input_param->get_shape();
-      size_t param_size = shape_size(shape) / m_batch_size;
-      auto element_type = input_param->get_element_type();
-      auto input_tensor =
-          std::dynamic_pointer_cast<ngraph::he::HESealCipherTensor>(
-              m_he_seal_backend.create_cipher_tensor(
-                  element_type, input_param->get_shape(), m_batch_data,
-                  "client_parameter"));
-
-      std::vector<std::shared_ptr<ngraph::he::SealCiphertextWrapper>>
-          cipher_elements{
-              he_cipher_inputs.begin() + parameter_size_index,
-              he_cipher_inputs.begin() + parameter_size_index + param_size};
-
-      NGRAPH_CHECK(cipher_elements.size() == param_size,
-                   "Incorrect number of elements for parameter");
-
-      input_tensor->set_elements(cipher_elements);
-      for (auto& cipher_elem : cipher_elements) {
-        cipher_elem->complex_packing() = m_complex_packing;
+    {
+      std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+      NGRAPH_CHECK(message.query_id() >= m_client_query_id, "Inputs of query ",
+                   message.query_id(), " received after query ",
+                   m_client_query_id);
+      if (message.query_id() > m_client_query_id) {
+        // Inputs of a later query; load them once the current query is done
+        m_pending_input_chunks[message.query_id()].emplace_back(
+            PendingInputChunk{offset, count, total_count, ciphertext_size,
+                              std::vector<char>(message.data_ptr(),
+                                                message.data_ptr() +
+                                                    message.data_size())});
+        return;
       }
-      m_client_inputs.emplace_back(input_tensor);
-      parameter_size_index += param_size;
+      create_client_inputs();
     }
 
-    NGRAPH_CHECK(m_client_inputs.size() == get_parameters().size(),
-                 "Client inputs size ", m_client_inputs.size(), "; expected ",
-                 get_parameters().size());
-
-    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
-    m_client_inputs_received = true;
-    m_client_inputs_cond.notify_all();
-
+    // Messages are handled off the I/O thread, so the next chunk is received
+    // while this one is loaded
+    load_client_inputs(message.data_ptr(), offset, count, total_count,
+                       ciphertext_size);
   } else if (msg_type == MessageType::public_key) {
     seal::PublicKey key;
     std::stringstream key_stream;
@@ -333,65 +905,150 @@ void ngraph::he::HESealExecutable::handle_message(
 
     NGRAPH_INFO << "Server set public key";
 
-  } else if (msg_type == MessageType::eval_key) {
-    seal::RelinKeys keys;
+    // New session, which the client can resume with a fresh token
+    m_session_keys = SealKeySet();
+    m_session_keys.session_token = generate_session_token();
+    m_session_keys.public_key = m_he_seal_backend.get_public_key();
+    cache_session_keys();
+    const std::string& token = m_session_keys.session_token;
+    m_session->do_write(TCPMessage(MessageType::session_token, 1,
+                                   token.size(), token.data()));
+
+    // Only request the evaluation keys the function needs
+    request_eval_keys(m_eval_key_request);
+  } else if (msg_type == MessageType::session_token) {
+    std::string token(message.data_ptr(), message.data_size());
+    auto cached_keys =
+        m_he_seal_backend.client_key_cache().find(token, m_context);
+    if (cached_keys == nullptr) {
+      // The client uploads its public key after an empty reply
+      NGRAPH_INFO << "Server has no keys for session token; starting new "
+                     "session";
+      m_session->do_write(TCPMessage(MessageType::session_token, 1, 0, ""));
+      return;
+    }
+    NGRAPH_INFO << "Server resuming session with cached keys";
+    m_session_keys = *cached_keys;
+    m_he_seal_backend.set_public_key(*cached_keys->public_key);
+    if (cached_keys->relin_keys != nullptr) {
+      m_he_seal_backend.set_relin_keys(*cached_keys->relin_keys);
+    }
+    if (cached_keys->galois_keys != nullptr) {
+      m_he_seal_backend.set_galois_keys(*cached_keys->galois_keys);
+    }
+    m_session->do_write(TCPMessage(MessageType::session_token, 1,
+                                   token.size(), token.data()));
+
+    // Request only the evaluation keys missing from the cache
+    EvalKeyRequest missing_keys;
+    missing_keys.relin_keys =
+        m_eval_key_request.relin_keys && cached_keys->relin_keys == nullptr;
+    for (const auto galois_elt : m_eval_key_request.galois_elements) {
+      if (cached_keys->galois_keys == nullptr ||
+          !cached_keys->galois_keys->has_key(galois_elt)) {
+        missing_keys.galois_elements = m_eval_key_request.galois_elements;
+        break;
+      }
+    }
+    request_eval_keys(missing_keys);
+  } else if (msg_type == MessageType::eval_key ||
+             msg_type == MessageType::galois_key) {
     std::stringstream key_stream;
     key_stream.write(message.data_ptr(), message.element_size());
-    keys.load(m_context, key_stream);
-
-    m_he_seal_backend.set_relin_keys(keys);
-
-    // Send inference parameter shape
-    const ParameterVector& input_parameters = get_parameters();
-    size_t num_param_elements = 0;
-    for (const auto& param : input_parameters) {
-      auto& shape = param->get_shape();
-      num_param_elements += shape_size(shape);
-      NGRAPH_INFO << "Parameter shape " << join(shape, "x");
+    if (msg_type == MessageType::eval_key) {
+      seal::RelinKeys keys;
+      keys.load(m_context, key_stream);
+      m_he_seal_backend.set_relin_keys(keys);
+      m_session_keys.relin_keys = m_he_seal_backend.get_relin_keys();
+    } else {
+      seal::GaloisKeys keys;
+      keys.load(m_context, key_stream);
+      m_he_seal_backend.set_galois_keys(keys);
+      m_session_keys.galois_keys = m_he_seal_backend.get_galois_keys();
+    }
+
+    NGRAPH_CHECK(m_pending_eval_keys > 0, "Received unrequested ",
+                 message_type_to_string(msg_type), " message");
+    if (--m_pending_eval_keys == 0) {
+      cache_session_keys();
+      send_parameter_size();
+    }
+  } else if (msg_type == MessageType::parameter_set_keys) {
+    std::uint64_t parameter_set;
+    const std::string prefix = message.prefix();
+    NGRAPH_CHECK(prefix.size() == sizeof(parameter_set),
+                 "Invalid parameter_set_keys message");
+    std::memcpy(&parameter_set, prefix.data(), sizeof(parameter_set));
+    NGRAPH_CHECK(parameter_set != 0,
+                 "Keys of parameter set 0 are sent in public_key messages");
+    HESealBackend& backend = parameter_set_backend(parameter_set);
+
+    SealKeySet keys;
+    std::stringstream key_stream;
+    key_stream.write(message.data_ptr(), message.data_size());
+    keys.load(backend.get_context(), key_stream);
+    NGRAPH_CHECK(keys.public_key != nullptr, "No public key for parameter set ",
+                 parameter_set);
+    backend.set_public_key(*keys.public_key);
+    if (keys.relin_keys != nullptr) {
+      backend.set_relin_keys(*keys.relin_keys);
+    }
+    if (keys.galois_keys != nullptr) {
+      backend.set_galois_keys(*keys.galois_keys);
+    }
+    NGRAPH_INFO << "Server set keys of parameter set " << parameter_set;
+
+    std::lock_guard<std::mutex> guard(m_parameter_set_mutex);
+    m_parameter_set_keys_received.insert(parameter_set);
+    m_parameter_set_cond.notify_all();
+  } else if (msg_type == MessageType::data_streams) {
+    std::uint64_t data_streams;
+    std::memcpy(&data_streams, message.data_ptr(), sizeof(data_streams));
+    NGRAPH_CHECK(data_streams <= m_max_data_streams, "Client opened ",
+                 data_streams, " data streams; at most ", m_max_data_streams,
+                 " were offered");
+    {
+      std::lock_guard<std::mutex> guard(m_session_mutex);
+      m_num_data_streams = data_streams;
     }
-
-    if (m_batch_data) {
-      NGRAPH_DEBUG << "num_param_elements before batch size divide "
-                   << num_param_elements;
-      num_param_elements /= m_batch_size;
-      NGRAPH_DEBUG << "num_param_elements after batch size divide "
-                   << num_param_elements;
+    NGRAPH_INFO << "Client opening " << data_streams << " data streams";
+    if (data_streams > 0) {
+      boost::asio::post(m_io_context, [this]() { accept_data_streams(); });
     }
+  } else if (msg_type == MessageType::activation_result) {
+    std::lock_guard<std::mutex> guard(m_activation_mutex);
 
-    NGRAPH_DEBUG << "Requesting total of " << num_param_elements
-                 << " parameter elements";
-    ngraph::he::TCPMessage parameter_message{MessageType::parameter_size, 1,
-                                             sizeof(num_param_elements),
-                                             (char*)&num_param_elements};
-
-    NGRAPH_DEBUG << "Server sending message of type: parameter_size";
-    m_session->do_write(std::move(parameter_message));
-  } else if (msg_type == MessageType::relu_result) {
-    std::lock_guard<std::mutex> guard(m_relu_mutex);
-
+    auto result_context =
+        parameter_set_backend(m_round_trip_result_parameter_set).get_context();
     size_t element_count = message.count();
     size_t element_size = message.element_size();
+    size_t offset = message.offset();
 
 #pragma omp parallel for
     for (size_t element_idx = 0; element_idx < element_count; ++element_idx) {
       seal::Ciphertext cipher;
-      std::stringstream cipher_stream;
-      cipher_stream.write(message.data_ptr() + element_idx * element_size,
-                          element_size);
-      cipher.load(m_context, cipher_stream);
+      ngraph::he::load_ciphertext(
+          cipher, result_context,
+          message.data_ptr() + element_idx * element_size, element_size);
 
       auto new_cipher = std::make_shared<ngraph::he::SealCiphertextWrapper>(
           cipher, m_complex_packing);
 
-      m_relu_ciphertexts[m_unknown_relu_idx[element_idx]] = new_cipher;
+      size_t activation_idx = m_unknown_activation_idx[offset + element_idx];
+      m_activation_ciphertexts[activation_idx] = new_cipher;
     }
+    m_activation_results_received += element_count;
 
-    // Notify condition variable
-    m_relu_done = true;
-    m_relu_cond.notify_all();
+    // Notify condition variable once all chunks are received
+    if (m_activation_results_received == message.total_count()) {
+      m_activation_done = true;
+      m_activation_cond.notify_all();
+    }
   } else if (msg_type == MessageType::max_result) {
     std::lock_guard<std::mutex> guard(m_max_mutex);
 
+    auto result_context =
+        parameter_set_backend(m_round_trip_result_parameter_set).get_context();
     size_t element_count = message.count();
     size_t element_size = message.element_size();
 
@@ -400,7 +1057,7 @@ void ngraph::he::HESealExecutable::handle_message(
       std::stringstream cipher_stream;
       cipher_stream.write(message.data_ptr() + element_idx * element_size,
                           element_size);
-      cipher.load(m_context, cipher_stream);
+      cipher.load(result_context, cipher_stream);
       auto new_cipher = std::make_shared<ngraph::he::SealCiphertextWrapper>(
           cipher, m_complex_packing);
 
@@ -437,6 +1094,119 @@ void ngraph::he::HESealExecutable::handle_message(
   }
 }
 
+void ngraph::he::HESealExecutable::load_client_inputs(
+    const char* data, size_t offset, size_t count, size_t total_count,
+    size_t ciphertext_size) {
+  NGRAPH_INFO << "Loading ciphertexts [" << offset << ", " << offset + count
+              << ") of " << total_count;
+  {
+    // The chunk range comes from the network
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    size_t input_count = 0;
+    for (const auto& client_input : m_client_inputs) {
+      input_count += std::static_pointer_cast<HESealCipherTensor>(client_input)
+                         ->num_ciphertexts();
+    }
+    NGRAPH_CHECK(count > 0 && total_count == input_count &&
+                     count <= input_count && offset <= input_count - count,
+                 "Client input chunk [", offset, ", ", offset + count, ") of ",
+                 total_count, " does not fit ", input_count,
+                 " client input ciphertexts");
+    auto next = m_client_input_ranges.lower_bound(offset);
+    const bool overlaps_next =
+        next != m_client_input_ranges.end() && next->first < offset + count;
+    const bool overlaps_previous =
+        next != m_client_input_ranges.begin() &&
+        std::prev(next)->first + std::prev(next)->second > offset;
+    NGRAPH_CHECK(!overlaps_next && !overlaps_previous, "Client input chunk [",
+                 offset, ", ", offset + count, ") was already received");
+    m_client_input_ranges.emplace(offset, count);
+  }
+
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    // Find the parameter tensor which stores input offset + i
+    size_t element_idx = offset + i;
+    std::shared_ptr<HESealCipherTensor> input_tensor;
+    for (const auto& client_input : m_client_inputs) {
+      input_tensor =
+          std::static_pointer_cast<HESealCipherTensor>(client_input);
+      if (element_idx < input_tensor->num_ciphertexts()) {
+        break;
+      }
+      element_idx -= input_tensor->num_ciphertexts();
+    }
+
+    std::stringstream stream;
+    stream.write(data + i * ciphertext_size, ciphertext_size);
+    auto& cipher = input_tensor->get_element(element_idx);
+    cipher->ciphertext().load(m_context, stream);
+    cipher->complex_packing() = m_complex_packing;
+  }
+
+  std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+  m_client_input_chunks[offset] = count;
+  for (auto it = m_client_input_chunks.find(m_client_inputs_prefix);
+       it != m_client_input_chunks.end();
+       it = m_client_input_chunks.find(m_client_inputs_prefix)) {
+    m_client_inputs_prefix += it->second;
+    m_client_input_chunks.erase(it);
+  }
+  if (m_client_inputs_prefix == total_count) {
+    NGRAPH_INFO << "Done loading " << total_count << " ciphertexts";
+    m_client_inputs_received = true;
+  }
+  // Notify on every chunk, so streamed ops can compute newly available outputs
+  m_client_inputs_cond.notify_all();
+}
+
+void ngraph::he::HESealExecutable::send_parameter_size() {
+  // Send inference parameter shape
+  const ParameterVector& input_parameters = get_parameters();
+  size_t num_param_elements = 0;
+  for (const auto& param : input_parameters) {
+    auto& shape = param->get_shape();
+    num_param_elements += shape_size(shape);
+    NGRAPH_INFO << "Parameter shape " << join(shape, "x");
+  }
+
+  if (m_batch_data) {
+    NGRAPH_DEBUG << "num_param_elements before batch size divide "
+                 << num_param_elements;
+    num_param_elements /= m_batch_size;
+    NGRAPH_DEBUG << "num_param_elements after batch size divide "
+                 << num_param_elements;
+  }
+
+  NGRAPH_DEBUG << "Requesting total of " << num_param_elements
+               << " parameter elements";
+  ngraph::he::TCPMessage parameter_message{MessageType::parameter_size, 1,
+                                           sizeof(num_param_elements),
+                                           (char*)&num_param_elements};
+
+  NGRAPH_DEBUG << "Server sending message of type: parameter_size";
+  m_session->do_write(std::move(parameter_message));
+}
+
+void ngraph::he::HESealExecutable::request_eval_keys(
+    const EvalKeyRequest& request) {
+  if (request.empty()) {
+    send_parameter_size();
+    return;
+  }
+  m_pending_eval_keys = request.num_key_messages();
+  std::stringstream request_stream;
+  request.save(request_stream);
+  auto request_message = TCPMessage(MessageType::eval_key_request, 1,
+                                    std::move(request_stream));
+  NGRAPH_INFO << "Server requesting evaluation keys";
+  m_session->do_write(std::move(request_message));
+}
+
+void ngraph::he::HESealExecutable::cache_session_keys() {
+  m_he_seal_backend.client_key_cache().insert(m_session_keys, m_context);
+}
+
 std::vector<ngraph::runtime::PerformanceCounter>
 ngraph::he::HESealExecutable::get_performance_data() const {
   std::vector<runtime::PerformanceCounter> rc;
@@ -458,9 +1228,17 @@ bool ngraph::he::HESealExecutable::call(
                 << server_inputs.size();
 
     std::unique_lock<std::mutex> mlock(m_client_inputs_mutex);
-    m_client_inputs_cond.wait(
-        mlock, std::bind(&HESealExecutable::client_inputs_received, this));
-    NGRAPH_INFO << "client_inputs_received";
+    if (m_stream_input_op != nullptr) {
+      // The streamed op waits for the inputs it reads, so only wait until the
+      // first chunk of client inputs, at offset 0, is loaded
+      m_client_inputs_cond.wait(
+          mlock, [this]() { return m_client_inputs_prefix > 0; });
+      NGRAPH_INFO << "Streaming client inputs";
+    } else {
+      m_client_inputs_cond.wait(
+          mlock, std::bind(&HESealExecutable::client_inputs_received, this));
+      NGRAPH_INFO << "client_inputs_received";
+    }
 
     NGRAPH_CHECK(m_client_inputs.size() == server_inputs.size(),
                  "Recieved incorrect number of inputs from client (got ",
@@ -551,6 +1329,7 @@ bool ngraph::he::HESealExecutable::call(
     tensor_map.insert({tv, he_outputs[output_count++]});
   }
 
+  size_t client_outputs_parameter_set = 0;
   // for each ordered op in the graph
   for (const NodeWrapper& wrapped : m_wrapped_nodes) {
     auto op = wrapped.get_node();
@@ -584,8 +1363,12 @@ bool ngraph::he::HESealExecutable::call(
       // Client outputs remain ciphertexts, so don't perform result op on them
       NGRAPH_INFO << "Setting client outputs";
       m_client_outputs = op_inputs;
+      client_outputs_parameter_set = input_parameter_set(*op);
     }
 
+    // Outputs are in the parameter set of the op's segment
+    HESealBackend& out_backend = parameter_set_backend(get_parameter_set(*op));
+
     // get op outputs from map or create
     std::vector<std::shared_ptr<ngraph::he::HETensor>> op_outputs;
     for (size_t i = 0; i < op->get_output_size(); ++i) {
@@ -622,11 +1405,11 @@ bool ngraph::he::HESealExecutable::call(
 
         if (plain_out) {
           auto out_tensor = std::make_shared<ngraph::he::HEPlainTensor>(
-              element_type, shape, m_he_seal_backend, packed_out, name);
+              element_type, shape, out_backend, packed_out, name);
           tensor_map.insert({tensor, out_tensor});
         } else {
           auto out_tensor = std::make_shared<ngraph::he::HESealCipherTensor>(
-              element_type, shape, m_he_seal_backend, packed_out, name);
+              element_type, shape, out_backend, packed_out, name);
           tensor_map.insert({tensor, out_tensor});
         }
       }
@@ -641,6 +1424,8 @@ bool ngraph::he::HESealExecutable::call(
       base_type = op->get_inputs().at(0).get_tensor().get_element_type();
     }
 
+    // Ops after a client round trip need the client's keys of their segment
+    wait_for_parameter_set_keys(input_parameter_set(*op));
     generate_calls(base_type, wrapped, op_outputs, op_inputs);
     m_timer_map[op].stop();
 
@@ -682,36 +1467,111 @@ bool ngraph::he::HESealExecutable::call(
                  "HESealExecutable only supports output size 1 (got ",
                  get_results().size(), "");
 
-    std::vector<seal::Ciphertext> seal_output;
-
-    const Shape& output_shape = get_results()[0]->get_shape();
-    size_t output_shape_size = shape_size(output_shape) / m_batch_size;
-
     auto output_cipher_tensor =
         std::dynamic_pointer_cast<HESealCipherTensor>(m_client_outputs[0]);
 
     NGRAPH_CHECK(output_cipher_tensor != nullptr,
                  "Client outputs are not HESealCipherTensor");
 
-    std::stringstream cipher_stream;
-    output_cipher_tensor->save_elements(cipher_stream);
-    auto result_message = TCPMessage(MessageType::result, output_shape_size,
-                                     std::move(cipher_stream));
+    const auto& output_ciphers = output_cipher_tensor->get_elements();
+    size_t output_size = output_ciphers.size();
+    size_t chunk_count = TCPMessage::chunk_count(
+        ciphertext_size(output_ciphers.front()->ciphertext()));
+
+    size_t query_id = m_client_query_id;
+    NGRAPH_INFO << "Writing result of query " << query_id << " with "
+                << output_size << " ciphertexts in chunks of at most "
+                << chunk_count;
+    // Tells the client which keys decrypt the results
+    RoundTripParameterSets result_parameter_sets;
+    result_parameter_sets.parameter_set = client_outputs_parameter_set;
+    result_parameter_sets.result_parameter_set = client_outputs_parameter_set;
+    const std::string result_prefix = result_parameter_sets.save();
+    std::vector<std::future<void>> result_writes = write_chunks(
+        output_size, chunk_count,
+        [&output_ciphers, &result_prefix, query_id](size_t offset,
+                                                    size_t count) {
+          TCPMessage result_message(MessageType::result, output_ciphers,
+                                    offset, count, result_prefix);
+          result_message.set_query_id(query_id);
+          return result_message;
+        });
+    for (auto& result_write : result_writes) {
+      result_write.get();
+    }
+    NGRAPH_INFO << "Results written to client";
+
+    next_client_query();
+  }
+  return true;
+}
 
-    // auto result_message =
-    //    TCPMessage(MessageType::result, output_cipher_tensor->get_elements());
+void ngraph::he::HESealExecutable::next_client_query() {
+  std::vector<PendingInputChunk> pending_chunks;
+  {
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    m_client_query_id++;
+    m_client_inputs.clear();
+    m_client_inputs_prefix = 0;
+    m_client_input_chunks.clear();
+    m_client_input_ranges.clear();
+    m_client_inputs_received = false;
+
+    auto it = m_pending_input_chunks.find(m_client_query_id);
+    if (it != m_pending_input_chunks.end()) {
+      pending_chunks = std::move(it->second);
+      m_pending_input_chunks.erase(it);
+      create_client_inputs();
+    }
+  }
+  // Load inputs of the next query which arrived during this query
+  for (const auto& chunk : pending_chunks) {
+    load_client_inputs(chunk.data.data(), chunk.offset, chunk.count,
+                       chunk.total_count, chunk.ciphertext_size);
+  }
+}
 
-    NGRAPH_INFO << "Writing Result message with " << output_shape_size
-                << " ciphertexts ";
-    m_session->do_write(std::move(result_message));
+void ngraph::he::HESealExecutable::create_client_inputs() {
+  if (!m_client_inputs.empty()) {
+    return;
+  }
+  NGRAPH_INFO << "Setting m_client_inputs for query " << m_client_query_id;
+  for (auto input_param : get_parameters()) {
+    m_client_inputs.emplace_back(m_he_seal_backend.create_cipher_tensor(
+        input_param->get_element_type(), input_param->get_shape(),
+        m_batch_data, "client_parameter"));
+  }
+  m_client_inputs_prefix = 0;
+  m_client_input_chunks.clear();
+  m_client_input_ranges.clear();
+}
 
-    // TODO: more sophisticated way of doing this
-    while (m_session->is_writing()) {
-      NGRAPH_INFO << "Waiting until results are written to client";
-      sleep(1);
-    }
+ngraph::he::KernelEpilogue ngraph::he::HESealExecutable::kernel_epilogue(
+    const ngraph::Node& node,
+    const std::vector<std::shared_ptr<HETensor>>& args) const {
+  KernelEpilogue epilogue;
+  epilogue.rescale = rescales(node);
+  if (args.size() > 2) {
+    auto bias_plain = std::dynamic_pointer_cast<HEPlainTensor>(args[2]);
+    NGRAPH_CHECK(bias_plain != nullptr, "Bias of ", node.get_name(),
+                 " is not a plaintext");
+    epilogue.bias = &bias_plain->get_elements();
   }
-  return true;
+  return epilogue;
+}
+
+void ngraph::he::HESealExecutable::add_plain_bias(
+    std::shared_ptr<HEPlainTensor>& out_plain,
+    const std::vector<std::shared_ptr<HETensor>>& args,
+    const element::Type& type, const HESealBackend& he_seal_backend) {
+  if (args.size() <= 2) {
+    return;
+  }
+  auto bias_plain = std::dynamic_pointer_cast<HEPlainTensor>(args[2]);
+  NGRAPH_CHECK(bias_plain != nullptr, "Bias is not a plaintext");
+  ngraph::he::add_seal(out_plain->get_elements(), bias_plain->get_elements(),
+                       out_plain->get_elements(), type, he_seal_backend,
+                       out_plain->get_batched_element_count());
 }
 
 void ngraph::he::HESealExecutable::generate_calls(
@@ -727,74 +1587,16 @@ void ngraph::he::HESealExecutable::generate_calls(
   std::shared_ptr<HEPlainTensor> arg1_plain = nullptr;
   auto out0_cipher = std::dynamic_pointer_cast<HESealCipherTensor>(out[0]);
   auto out0_plain = std::dynamic_pointer_cast<HEPlainTensor>(out[0]);
-
-  // TODO: move to static function
-  auto lazy_rescaling = [this](auto& cipher_tensor, bool verbose = true) {
-    if (m_he_seal_backend.naive_rescaling()) {
-      return;
-    }
-    if (verbose) {
-      NGRAPH_INFO << "Rescaling " << cipher_tensor->num_ciphertexts()
-                  << " ciphertexts";
-    }
-
-    typedef std::chrono::high_resolution_clock Clock;
-    auto t1 = Clock::now();
-    size_t new_chain_index = std::numeric_limits<size_t>::max();
-
-    bool all_known_values = true;
-    for (size_t cipher_idx = 0; cipher_idx < cipher_tensor->num_ciphertexts();
-         ++cipher_idx) {
-      auto& cipher = cipher_tensor->get_element(cipher_idx);
-      if (!cipher->known_value()) {
-        size_t curr_chain_index =
-            get_chain_index(cipher->ciphertext(), m_he_seal_backend);
-        if (curr_chain_index == 0) {
-          new_chain_index = 0;
-        } else {
-          new_chain_index = curr_chain_index - 1;
-        }
-        all_known_values = false;
-        break;
-      }
-    }
-
-    if (all_known_values) {
-      if (verbose) {
-        NGRAPH_INFO << "Skipping rescaling because all values are known";
-      }
-      return;
-    }
-
-    NGRAPH_CHECK(new_chain_index != std::numeric_limits<size_t>::max(),
-                 "Lazy rescaling called on cipher tensor of all known values");
-    if (new_chain_index == 0) {
-      if (verbose) {
-        NGRAPH_INFO << "Skipping rescaling to chain index 0";
-      }
-      return;
-    }
-    if (verbose) {
-      NGRAPH_INFO << "New chain index " << new_chain_index;
-    }
-
-#pragma omp parallel for
-    for (size_t i = 0; i < cipher_tensor->num_ciphertexts(); ++i) {
-      auto cipher = cipher_tensor->get_element(i);
-      if (!cipher->known_value()) {
-        m_he_seal_backend.get_evaluator()->rescale_to_next_inplace(
-            cipher->ciphertext());
-      }
-    }
-    if (verbose) {
-      auto t2 = Clock::now();
-      NGRAPH_INFO << "Rescale_xxx took "
-                  << std::chrono::duration_cast<std::chrono::milliseconds>(t2 -
-                                                                           t1)
-                         .count()
-                  << "ms";
-    }
-  };
+  // Ops compute in the encryption parameter set of their arguments
+  HESealBackend& he_seal_backend =
+      parameter_set_backend(input_parameter_set(node));
+
+  // Kernels rescale their outputs in their epilogue if HERescalePlacement
+  // placed a rescale at node
+  const bool rescale = rescales(node);
+  if (rescale && verbose) {
+    NGRAPH_INFO << "Rescaling the outputs of " << node.get_name();
+  }
 
   std::vector<Shape> packed_arg_shapes{};
   std::vector<Shape> unpacked_arg_shapes{};
@@ -883,25 +1685,25 @@ void ngraph::he::HESealExecutable::generate_calls(
           out0_cipher != nullptr) {
         ngraph::he::add_seal(
             arg0_cipher->get_elements(), arg1_cipher->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_cipher != nullptr && arg1_plain != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::add_seal(
             arg0_cipher->get_elements(), arg1_plain->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_plain != nullptr && arg1_cipher != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::add_seal(
             arg0_plain->get_elements(), arg1_cipher->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_plain != nullptr && arg1_plain != nullptr &&
                  out0_plain != nullptr) {
         ngraph::he::add_seal(
             arg0_plain->get_elements(), arg1_plain->get_elements(),
-            out0_plain->get_elements(), type, m_he_seal_backend,
+            out0_plain->get_elements(), type, he_seal_backend,
             out0_plain->get_batched_element_count());
       } else {
         throw ngraph_error("Add types not supported.");
@@ -925,8 +1727,7 @@ void ngraph::he::HESealExecutable::generate_calls(
             avg_pool->get_window_movement_strides(),
             avg_pool->get_padding_below(), avg_pool->get_padding_above(),
             avg_pool->get_include_padding_in_avg_computation(),
-            m_he_seal_backend);
-        lazy_rescaling(out0_cipher, verbose_op(node));
+            he_seal_backend, kernel_epilogue(node, args));
 
       } else if (arg0_plain != nullptr && out0_plain != nullptr) {
         ngraph::he::avg_pool_seal(
@@ -935,7 +1736,7 @@ void ngraph::he::HESealExecutable::generate_calls(
             avg_pool->get_window_movement_strides(),
             avg_pool->get_padding_below(), avg_pool->get_padding_above(),
             avg_pool->get_include_padding_in_avg_computation(),
-            m_he_seal_backend);
+            he_seal_backend);
 
       } else {
         throw ngraph_error("AvgPool types not supported.");
@@ -965,8 +1766,7 @@ void ngraph::he::HESealExecutable::generate_calls(
       ngraph::he::batch_norm_inference_seal(
           eps, gamma->get_elements(), beta->get_elements(),
           input->get_elements(), mean->get_elements(), variance->get_elements(),
-          out0_cipher->get_elements(), packed_arg_shapes[2], m_batch_size,
-          m_he_seal_backend);
+          out0_cipher->get_elements(), packed_arg_shapes[2], he_seal_backend);
       break;
     }
     case OP_TYPEID::BoundedRelu: {
@@ -974,6 +1774,12 @@ void ngraph::he::HESealExecutable::generate_calls(
           static_cast<const op::BoundedRelu*>(&node);
       float alpha = bounded_relu->get_alpha();
 
+      if (m_polynomial_activation.enabled()) {
+        handle_polynomial_activation_op(arg0_cipher, arg0_plain, out0_cipher,
+                                        out0_plain, node_wrapper,
+                                        he_seal_backend);
+        break;
+      }
       if (arg0_plain != nullptr && out0_plain != nullptr) {
         size_t output_size = arg0_plain->get_batched_element_count();
         NGRAPH_CHECK(output_size == arg0_plain->num_plaintexts(),
@@ -1000,13 +1806,14 @@ void ngraph::he::HESealExecutable::generate_calls(
                      out0_cipher->num_ciphertexts());
         ngraph::he::bounded_relu_seal(arg0_cipher->get_elements(),
                                       out0_cipher->get_elements(), output_size,
-                                      alpha, m_he_seal_backend);
+                                      alpha, he_seal_backend);
         break;
       }
-      NGRAPH_CHECK(alpha == 6.0f,
-                   "Client supports BoundeRelu(6) only; got BoundedRelu(",
-                   alpha, ")");
-      handle_server_relu_op(arg0_cipher, out0_cipher, node_wrapper);
+      ActivationRequest activation;
+      activation.type = ActivationRequest::Type::bounded_relu;
+      activation.alpha = alpha;
+      handle_server_activation_op(arg0_cipher, out0_cipher, node_wrapper,
+                                  activation);
       break;
     }
     case OP_TYPEID::Broadcast: {
@@ -1080,70 +1887,83 @@ void ngraph::he::HESealExecutable::generate_calls(
 
       if (out0_plain != nullptr) {
         ngraph::he::constant_seal(out0_plain->get_elements(), type,
-                                  constant->get_data_ptr(), m_he_seal_backend,
+                                  constant->get_data_ptr(), he_seal_backend,
                                   out0_plain->get_batched_element_count());
+        if (m_scale_planning != nullptr) {
+          const double scale = m_scale_planning->encoding_scale(&node);
+          for (HEPlaintext& plaintext : out0_plain->get_elements()) {
+            plaintext.encoding_scale() = scale;
+          }
+        }
       } else if (out0_cipher != nullptr) {
         ngraph::he::constant_seal(out0_cipher->get_elements(), type,
-                                  constant->get_data_ptr(), m_he_seal_backend,
+                                  constant->get_data_ptr(), he_seal_backend,
                                   out0_cipher->get_batched_element_count());
       } else {
         throw ngraph_error("Constant type not supported.");
       }
       break;
     }
+    case OP_TYPEID::BiasedConvolution:
     case OP_TYPEID::Convolution: {
-      const op::Convolution* c = static_cast<const op::Convolution*>(&node);
-      auto window_movement_strides = c->get_window_movement_strides();
-      auto window_dilation_strides = c->get_window_dilation_strides();
-      auto padding_below = c->get_padding_below();
-      auto padding_above = c->get_padding_above();
-      auto data_dilation_strides = c->get_data_dilation_strides();
-
-      Shape in_shape0 = packed_arg_shapes[0];
-      Shape in_shape1 = unpacked_arg_shapes[1];
-
+      // BiasedConvolution adds its bias in the kernel epilogue
+      const KernelEpilogue epilogue = kernel_epilogue(node, args);
+      auto winograd = m_winograd_convolutions.find(&node);
       if (arg0_cipher != nullptr && arg1_cipher != nullptr &&
           out0_cipher != nullptr) {
         ngraph::he::convolution_seal(
             arg0_cipher->get_elements(), arg1_cipher->get_elements(),
-            out0_cipher->get_elements(), in_shape0, in_shape1, packed_out_shape,
-            window_movement_strides, window_dilation_strides, padding_below,
-            padding_above, data_dilation_strides, 0, 1, 1, 0, 0, 1, false, type,
-            m_batch_size, m_he_seal_backend, verbose);
-        lazy_rescaling(out0_cipher, verbose);
+            out0_cipher->get_elements(), convolution_taps(node), type,
+            he_seal_backend, verbose, epilogue);
       } else if (arg0_cipher != nullptr && arg1_plain != nullptr &&
                  out0_cipher != nullptr) {
-        ngraph::he::convolution_seal(
-            arg0_cipher->get_elements(), arg1_plain->get_elements(),
-            out0_cipher->get_elements(), in_shape0, in_shape1, packed_out_shape,
-            window_movement_strides, window_dilation_strides, padding_below,
-            padding_above, data_dilation_strides, 0, 1, 1, 0, 0, 1, false, type,
-            m_batch_size, m_he_seal_backend, verbose);
-        lazy_rescaling(out0_cipher, verbose);
+        if (m_enable_client && &node == m_stream_input_op) {
+          stream_convolution(node, arg0_cipher, arg1_plain, out0_cipher, type,
+                             epilogue, verbose);
+        } else if (winograd != m_winograd_convolutions.end()) {
+          ngraph::he::winograd_convolution_seal(
+              arg0_cipher->get_elements(), winograd->second.transformed_filter,
+              out0_cipher->get_elements(), packed_arg_shapes[0],
+              unpacked_arg_shapes[1], packed_out_shape,
+              winograd->second.padding_below, type, he_seal_backend, verbose,
+              epilogue);
+        } else if (const LinearPlan* plan = linear_plan(node)) {
+          ngraph::he::linear_plan_seal(arg0_cipher->get_elements(),
+                                       out0_cipher->get_elements(), *plan,
+                                       type, he_seal_backend, epilogue);
+        } else {
+          ngraph::he::convolution_seal(
+              arg0_cipher->get_elements(), arg1_plain->get_elements(),
+              out0_cipher->get_elements(), convolution_taps(node), type,
+              he_seal_backend, verbose, epilogue);
+        }
       } else if (arg0_plain != nullptr && arg1_cipher != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::convolution_seal(
             arg0_plain->get_elements(), arg1_cipher->get_elements(),
-            out0_cipher->get_elements(), in_shape0, in_shape1, packed_out_shape,
-            window_movement_strides, window_dilation_strides, padding_below,
-            padding_above, data_dilation_strides, 0, 1, 1, 0, 0, 1, false, type,
-            m_batch_size, m_he_seal_backend, verbose);
-        lazy_rescaling(out0_cipher, verbose);
+            out0_cipher->get_elements(), convolution_taps(node), type,
+            he_seal_backend, verbose, epilogue);
       } else if (arg0_plain != nullptr && arg1_plain != nullptr &&
                  out0_plain != nullptr) {
         ngraph::he::convolution_seal(
             arg0_plain->get_elements(), arg1_plain->get_elements(),
-            out0_plain->get_elements(), in_shape0, in_shape1, packed_out_shape,
-            window_movement_strides, window_dilation_strides, padding_below,
-            padding_above, data_dilation_strides, 0, 1, 1, 0, 0, 1, false, type,
-            m_batch_size, m_he_seal_backend, verbose);
+            out0_plain->get_elements(), convolution_taps(node), type,
+            he_seal_backend, verbose);
+        add_plain_bias(out0_plain, args, type, he_seal_backend);
       } else {
         throw ngraph_error("Convolution types not supported.");
       }
       break;
     }
+    case OP_TYPEID::BiasedDot:
     case OP_TYPEID::Dot: {
-      const op::Dot* dot = static_cast<const op::Dot*>(&node);
+      // BiasedDot adds its bias in the kernel epilogue
+      const KernelEpilogue epilogue = kernel_epilogue(node, args);
+      const size_t reduction_axes_count =
+          node_wrapper.get_typeid() == OP_TYPEID::Dot
+              ? static_cast<const op::Dot&>(node).get_reduction_axes_count()
+              : static_cast<const op::BiasedDot&>(node)
+                    .get_reduction_axes_count();
       Shape in_shape0 = packed_arg_shapes[0];
       Shape in_shape1 = unpacked_arg_shapes[1];
 
@@ -1155,34 +1975,51 @@ void ngraph::he::HESealExecutable::generate_calls(
         ngraph::he::dot_seal(
             arg0_cipher->get_elements(), arg1_cipher->get_elements(),
             out0_cipher->get_elements(), in_shape0, in_shape1, packed_out_shape,
-            dot->get_reduction_axes_count(), type, m_he_seal_backend);
-        lazy_rescaling(out0_cipher, verbose);
+            reduction_axes_count, type, he_seal_backend, epilogue);
+      } else if (arg0_cipher != nullptr && arg1_plain != nullptr &&
+                 out0_cipher != nullptr && linear_plan(node) != nullptr) {
+        ngraph::he::linear_plan_seal(arg0_cipher->get_elements(),
+                                     out0_cipher->get_elements(),
+                                     *linear_plan(node), type, he_seal_backend,
+                                     epilogue);
       } else if (arg0_cipher != nullptr && arg1_plain != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::dot_seal(
             arg0_cipher->get_elements(), arg1_plain->get_elements(),
             out0_cipher->get_elements(), in_shape0, in_shape1, packed_out_shape,
-            dot->get_reduction_axes_count(), type, m_he_seal_backend);
-        lazy_rescaling(out0_cipher, verbose);
+            reduction_axes_count, type, he_seal_backend, epilogue);
+      } else if (arg0_plain != nullptr && arg1_cipher != nullptr &&
+                 out0_cipher != nullptr && linear_plan(node) != nullptr) {
+        ngraph::he::linear_plan_seal(arg1_cipher->get_elements(),
+                                     out0_cipher->get_elements(),
+                                     *linear_plan(node), type, he_seal_backend,
+                                     epilogue);
       } else if (arg0_plain != nullptr && arg1_cipher != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::dot_seal(
             arg0_plain->get_elements(), arg1_cipher->get_elements(),
             out0_cipher->get_elements(), in_shape0, in_shape1, packed_out_shape,
-            dot->get_reduction_axes_count(), type, m_he_seal_backend);
-        lazy_rescaling(out0_cipher, verbose);
+            reduction_axes_count, type, he_seal_backend, epilogue);
       } else if (arg0_plain != nullptr && arg1_plain != nullptr &&
                  out0_plain != nullptr) {
         ngraph::he::dot_seal(
             arg0_plain->get_elements(), arg1_plain->get_elements(),
             out0_plain->get_elements(), in_shape0, in_shape1,
-            out0_plain->get_packed_shape(), dot->get_reduction_axes_count(),
-            type, m_he_seal_backend);
+            out0_plain->get_packed_shape(), reduction_axes_count, type,
+            he_seal_backend);
+        add_plain_bias(out0_plain, args, type, he_seal_backend);
       } else {
         throw ngraph_error("Dot types not supported.");
       }
       break;
     }
+    case OP_TYPEID::Exp: {
+      ActivationRequest activation;
+      activation.type = ActivationRequest::Type::exp;
+      handle_activation_op(arg0_cipher, arg0_plain, out0_cipher, out0_plain,
+                           node_wrapper, activation);
+      break;
+    }
     case OP_TYPEID::MaxPool: {
       const op::MaxPool* max_pool = static_cast<const op::MaxPool*>(&node);
       if (arg0_plain != nullptr && out0_plain != nullptr) {
@@ -1212,7 +2049,7 @@ void ngraph::he::HESealExecutable::generate_calls(
             max_pool->get_window_shape(),
             max_pool->get_window_movement_strides(),
             max_pool->get_padding_below(), max_pool->get_padding_above(),
-            m_he_seal_backend);
+            he_seal_backend);
         break;
       }
 
@@ -1224,6 +2061,18 @@ void ngraph::he::HESealExecutable::generate_calls(
       m_max_ciphertexts.clear();
       m_max_done = false;
 
+      // The client encrypts the maxima in the parameter set of the next
+      // segment
+      RoundTripParameterSets max_parameter_sets;
+      max_parameter_sets.parameter_set = input_parameter_set(node);
+      max_parameter_sets.result_parameter_set = get_parameter_set(node);
+      {
+        std::lock_guard<std::mutex> guard(m_max_mutex);
+        m_round_trip_result_parameter_set =
+            max_parameter_sets.result_parameter_set;
+      }
+      const std::string max_prefix = max_parameter_sets.save();
+
       std::vector<std::vector<size_t>> maximize_list =
           ngraph::he::max_pool_seal(packed_arg_shapes[0], packed_out_shape,
                                     max_pool->get_window_shape(),
@@ -1254,7 +2103,8 @@ void ngraph::he::HESealExecutable::generate_calls(
                       << " Maxpool ciphertexts to client";
         }
         auto max_message =
-            TCPMessage(MessageType::max_request, maxpool_ciphers);
+            TCPMessage(MessageType::max_request, maxpool_ciphers, 0,
+                       maxpool_ciphers.size(), max_prefix);
 
         m_session->do_write(std::move(max_message));
 
@@ -1289,28 +2139,25 @@ void ngraph::he::HESealExecutable::generate_calls(
           out0_cipher != nullptr) {
         ngraph::he::multiply_seal(
             arg0_cipher->get_elements(), arg1_cipher->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
-        lazy_rescaling(out0_cipher, verbose);
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_cipher != nullptr && arg1_plain != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::multiply_seal(
             arg0_cipher->get_elements(), arg1_plain->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
-        lazy_rescaling(out0_cipher, verbose);
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_plain != nullptr && arg1_cipher != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::multiply_seal(
             arg0_plain->get_elements(), arg1_cipher->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
-        lazy_rescaling(out0_cipher, verbose);
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_plain != nullptr && arg1_plain != nullptr &&
                  out0_plain != nullptr) {
         ngraph::he::multiply_seal(
             arg0_plain->get_elements(), arg1_plain->get_elements(),
-            out0_plain->get_elements(), type, m_he_seal_backend,
+            out0_plain->get_elements(), type, he_seal_backend,
             out0_plain->get_batched_element_count());
       } else {
         throw ngraph_error("Multiply types not supported.");
@@ -1321,7 +2168,7 @@ void ngraph::he::HESealExecutable::generate_calls(
       if (arg0_cipher != nullptr && out0_cipher != nullptr) {
         ngraph::he::negate_seal(
             arg0_cipher->get_elements(), out0_cipher->get_elements(), type,
-            m_he_seal_backend, out0_cipher->get_batched_element_count());
+            he_seal_backend, out0_cipher->get_batched_element_count());
       } else if (arg0_plain != nullptr && out0_plain != nullptr) {
         ngraph::he::negate_seal(arg0_plain->get_elements(),
                                 out0_plain->get_elements(), type,
@@ -1344,21 +2191,21 @@ void ngraph::he::HESealExecutable::generate_calls(
             arg0_cipher->get_elements(), arg1_cipher->get_elements(),
             out0_cipher->get_elements(), arg0_shape, packed_out_shape,
             pad->get_padding_below(), pad->get_padding_above(),
-            pad->get_pad_mode(), m_batch_size, m_he_seal_backend);
+            pad->get_pad_mode(), m_batch_size, he_seal_backend);
       } else if (arg0_cipher != nullptr && arg1_plain != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::pad_seal(
             arg0_cipher->get_elements(), arg1_plain->get_elements(),
             out0_cipher->get_elements(), arg0_shape, packed_out_shape,
             pad->get_padding_below(), pad->get_padding_above(),
-            pad->get_pad_mode(), m_batch_size, m_he_seal_backend);
+            pad->get_pad_mode(), m_batch_size, he_seal_backend);
       } else if (arg0_plain != nullptr && arg1_plain != nullptr &&
                  out0_plain != nullptr) {
         ngraph::he::pad_seal(
             arg0_plain->get_elements(), arg1_plain->get_elements(),
             out0_plain->get_elements(), arg0_shape, packed_out_shape,
             pad->get_padding_below(), pad->get_padding_above(),
-            pad->get_pad_mode(), m_batch_size, m_he_seal_backend);
+            pad->get_pad_mode(), m_batch_size, he_seal_backend);
       } else {
         throw ngraph_error("Pad cipher vs. plain types not supported.");
       }
@@ -1371,6 +2218,12 @@ void ngraph::he::HESealExecutable::generate_calls(
                            passthrough->language()};
     }
     case OP_TYPEID::Relu: {
+      if (m_polynomial_activation.enabled()) {
+        handle_polynomial_activation_op(arg0_cipher, arg0_plain, out0_cipher,
+                                        out0_plain, node_wrapper,
+                                        he_seal_backend);
+        break;
+      }
       if (arg0_plain != nullptr && out0_plain != nullptr) {
         size_t output_size = arg0_plain->get_batched_element_count();
         NGRAPH_CHECK(output_size == arg0_plain->num_plaintexts(),
@@ -1396,11 +2249,14 @@ void ngraph::he::HESealExecutable::generate_calls(
                      out0_cipher->num_ciphertexts());
         ngraph::he::relu_seal(arg0_cipher->get_elements(),
                               out0_cipher->get_elements(), output_size,
-                              m_he_seal_backend);
+                              he_seal_backend);
         break;
       }
 
-      handle_server_relu_op(arg0_cipher, out0_cipher, node_wrapper);
+      ActivationRequest activation;
+      activation.type = ActivationRequest::Type::relu;
+      handle_server_activation_op(arg0_cipher, out0_cipher, node_wrapper,
+                                  activation);
       break;
     }
     case OP_TYPEID::Reshape: {
@@ -1452,11 +2308,11 @@ void ngraph::he::HESealExecutable::generate_calls(
       } else if (arg0_plain != nullptr && out0_cipher != nullptr) {
         ngraph::he::result_seal(arg0_plain->get_elements(),
                                 out0_cipher->get_elements(), output_size,
-                                m_he_seal_backend);
+                                he_seal_backend);
       } else if (arg0_cipher != nullptr && out0_plain != nullptr) {
         ngraph::he::result_seal(arg0_cipher->get_elements(),
                                 out0_plain->get_elements(), output_size,
-                                m_he_seal_backend);
+                                he_seal_backend);
       } else if (arg0_plain != nullptr && out0_plain != nullptr) {
         ngraph::he::result_seal(arg0_plain->get_elements(),
                                 out0_plain->get_elements(), output_size);
@@ -1486,6 +2342,30 @@ void ngraph::he::HESealExecutable::generate_calls(
     }
     case OP_TYPEID::ScalarConstantLike:
       break;
+    case OP_TYPEID::ScaleDivision: {
+      const op::ScaleDivision* scale_division =
+          static_cast<const op::ScaleDivision*>(&node);
+      size_t divisor = scale_division->get_divisor();
+      if (arg0_cipher != nullptr && out0_cipher != nullptr) {
+        ngraph::he::scale_division_seal(
+            arg0_cipher->get_elements(), out0_cipher->get_elements(), divisor,
+            he_seal_backend, out0_cipher->get_batched_element_count());
+      } else if (arg0_plain != nullptr && out0_plain != nullptr) {
+        ngraph::he::scale_division_seal(
+            arg0_plain->get_elements(), out0_plain->get_elements(), divisor,
+            out0_plain->get_batched_element_count());
+      } else {
+        throw ngraph_error("ScaleDivision types not supported.");
+      }
+      break;
+    }
+    case OP_TYPEID::Sigmoid: {
+      ActivationRequest activation;
+      activation.type = ActivationRequest::Type::sigmoid;
+      handle_activation_op(arg0_cipher, arg0_plain, out0_cipher, out0_plain,
+                           node_wrapper, activation);
+      break;
+    }
     case OP_TYPEID::Slice: {
       const op::Slice* slice = static_cast<const op::Slice*>(&node);
       Shape& in_shape = packed_arg_shapes[0];
@@ -1520,30 +2400,48 @@ void ngraph::he::HESealExecutable::generate_calls(
       }
       break;
     }
+    case OP_TYPEID::Softmax: {
+      const op::Softmax* softmax = static_cast<const op::Softmax*>(&node);
+      AxisSet axes = softmax->get_axes();
+      NGRAPH_CHECK(!m_batch_data || axes.find(0) == axes.end(),
+                   "Softmax over the batch axis is not supported");
+
+      // The client computes each softmax group from consecutive ciphertexts
+      const Shape& in_shape = packed_arg_shapes[0];
+      ActivationRequest activation;
+      activation.type = ActivationRequest::Type::softmax;
+      for (const auto axis : axes) {
+        activation.group_size *= in_shape[axis];
+      }
+      handle_activation_op(arg0_cipher, arg0_plain, out0_cipher, out0_plain,
+                           node_wrapper, activation,
+                           grouped_element_order(in_shape, axes));
+      break;
+    }
     case OP_TYPEID::Subtract: {
       if (arg0_cipher != nullptr && arg1_cipher != nullptr &&
           out0_cipher != nullptr) {
         ngraph::he::subtract_seal(
             arg0_cipher->get_elements(), arg1_cipher->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_cipher != nullptr && arg1_plain != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::subtract_seal(
             arg0_cipher->get_elements(), arg1_plain->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_plain != nullptr && arg1_cipher != nullptr &&
                  out0_cipher != nullptr) {
         ngraph::he::subtract_seal(
             arg0_plain->get_elements(), arg1_cipher->get_elements(),
-            out0_cipher->get_elements(), type, m_he_seal_backend,
-            out0_cipher->get_batched_element_count());
+            out0_cipher->get_elements(), type, he_seal_backend,
+            out0_cipher->get_batched_element_count(), rescale);
       } else if (arg0_plain != nullptr && arg1_plain != nullptr &&
                  out0_plain != nullptr) {
         ngraph::he::subtract_seal(
             arg0_plain->get_elements(), arg1_plain->get_elements(),
-            out0_plain->get_elements(), type, m_he_seal_backend,
+            out0_plain->get_elements(), type, he_seal_backend,
             out0_plain->get_batched_element_count());
       } else {
         throw ngraph_error("Subtract types not supported.");
@@ -1558,16 +2456,23 @@ void ngraph::he::HESealExecutable::generate_calls(
       if (arg0_cipher != nullptr && out0_cipher != nullptr) {
         ngraph::he::sum_seal(
             arg0_cipher->get_elements(), out0_cipher->get_elements(), in_shape,
-            out_shape, sum->get_reduction_axes(), type, m_he_seal_backend);
+            out_shape, sum->get_reduction_axes(), type, he_seal_backend);
       } else if (arg0_plain != nullptr && out0_plain != nullptr) {
         ngraph::he::sum_seal(
             arg0_plain->get_elements(), out0_plain->get_elements(), in_shape,
-            out_shape, sum->get_reduction_axes(), type, m_he_seal_backend);
+            out_shape, sum->get_reduction_axes(), type, he_seal_backend);
       } else {
         throw ngraph_error("Sum types not supported.");
       }
       break;
     }
+    case OP_TYPEID::Tanh: {
+      ActivationRequest activation;
+      activation.type = ActivationRequest::Type::tanh;
+      handle_activation_op(arg0_cipher, arg0_plain, out0_cipher, out0_plain,
+                           node_wrapper, activation);
+      break;
+    }
     // Unsupported ops
     case OP_TYPEID::Abs:
     case OP_TYPEID::Acos:
@@ -1599,7 +2504,6 @@ void ngraph::he::HESealExecutable::generate_calls(
     case OP_TYPEID::EmbeddingLookup:
     case OP_TYPEID::Equal:
     case OP_TYPEID::Erf:
-    case OP_TYPEID::Exp:
     case OP_TYPEID::Floor:
     case OP_TYPEID::Gather:
     case OP_TYPEID::GatherND:
@@ -1641,16 +2545,13 @@ void ngraph::he::HESealExecutable::generate_calls(
     case OP_TYPEID::ScatterNDAdd:
     case OP_TYPEID::Select:
     case OP_TYPEID::ShapeOf:
-    case OP_TYPEID::Sigmoid:
     case OP_TYPEID::SigmoidBackprop:
     case OP_TYPEID::Sign:
     case OP_TYPEID::Sin:
     case OP_TYPEID::Sinh:
-    case OP_TYPEID::Softmax:
     case OP_TYPEID::Sqrt:
     case OP_TYPEID::StopGradient:
     case OP_TYPEID::Tan:
-    case OP_TYPEID::Tanh:
     case OP_TYPEID::Tile:
     case OP_TYPEID::TopK:
     case OP_TYPEID::Transpose:
@@ -1660,107 +2561,247 @@ void ngraph::he::HESealExecutable::generate_calls(
   }
 }
 
-void ngraph::he::HESealExecutable::handle_server_relu_op(
+void ngraph::he::HESealExecutable::stream_convolution(
+    const ngraph::Node& convolution,
+    std::shared_ptr<HESealCipherTensor>& arg0_cipher,
+    std::shared_ptr<HEPlainTensor>& arg1_plain,
+    std::shared_ptr<HESealCipherTensor>& out0_cipher, const element::Type& type,
+    const KernelEpilogue& epilogue, bool verbose) {
+  const ConvolutionTaps& taps = convolution_taps(convolution);
+  std::vector<size_t> input_bounds(taps.output_count());
+  for (size_t out_index = 0; out_index < input_bounds.size(); ++out_index) {
+    input_bounds[out_index] = taps.input_bound(out_index);
+  }
+
+  // Compute outputs in the order in which their inputs arrive
+  std::vector<size_t> out_order(taps.output_count());
+  std::iota(out_order.begin(), out_order.end(), 0);
+  std::stable_sort(out_order.begin(), out_order.end(),
+                   [&input_bounds](size_t idx0, size_t idx1) {
+                     return input_bounds[idx0] < input_bounds[idx1];
+                   });
+
+  size_t num_computed = 0;
+  size_t num_tiles = 0;
+  while (num_computed < out_order.size()) {
+    size_t inputs_loaded;
+    {
+      size_t next_bound = input_bounds[out_order[num_computed]];
+      std::unique_lock<std::mutex> mlock(m_client_inputs_mutex);
+      m_client_inputs_cond.wait(mlock, [this, next_bound]() {
+        return m_client_inputs_prefix >= next_bound;
+      });
+      inputs_loaded = m_client_inputs_prefix;
+    }
+    auto tile_end = std::upper_bound(
+        out_order.begin() + num_computed, out_order.end(), inputs_loaded,
+        [&input_bounds](size_t loaded, size_t idx) {
+          return loaded < input_bounds[idx];
+        });
+    std::vector<size_t> tile{out_order.begin() + num_computed, tile_end};
+
+    ngraph::he::partial_convolution_seal(
+        arg0_cipher->get_elements(), arg1_plain->get_elements(),
+        out0_cipher->get_elements(), taps, tile, type, m_he_seal_backend,
+        false, epilogue);
+    num_computed += tile.size();
+    num_tiles++;
+  }
+  if (verbose) {
+    NGRAPH_INFO << "Computed " << taps.output_count() << " outputs in "
+                << num_tiles << " tiles while receiving inputs";
+  }
+
+  // Inputs outside every receptive field may still be arriving
+  std::unique_lock<std::mutex> mlock(m_client_inputs_mutex);
+  m_client_inputs_cond.wait(
+      mlock, std::bind(&HESealExecutable::client_inputs_received, this));
+}
+
+void ngraph::he::HESealExecutable::handle_activation_op(
+    std::shared_ptr<HESealCipherTensor>& arg_cipher,
+    std::shared_ptr<HEPlainTensor>& arg_plain,
+    std::shared_ptr<HESealCipherTensor>& out_cipher,
+    std::shared_ptr<HEPlainTensor>& out_plain, const NodeWrapper& node_wrapper,
+    const ActivationRequest& activation,
+    const std::vector<size_t>& element_order) {
+  const Node& node = *node_wrapper.get_node();
+  if (arg_plain != nullptr && out_plain != nullptr) {
+    ngraph::he::activation_seal(arg_plain->get_elements(),
+                                out_plain->get_elements(), activation,
+                                element_order);
+    return;
+  }
+  if (arg_cipher == nullptr || out_cipher == nullptr) {
+    throw ngraph_error(node.description() + " types not supported");
+  }
+  if (!m_enable_client) {
+    NGRAPH_WARN << "Performing " << node.description()
+                << " without client is not privacy-preserving";
+    ngraph::he::activation_seal(arg_cipher->get_elements(),
+                                out_cipher->get_elements(), activation,
+                                element_order, m_he_seal_backend);
+    return;
+  }
+  handle_server_activation_op(arg_cipher, out_cipher, node_wrapper, activation,
+                              element_order);
+}
+
+void ngraph::he::HESealExecutable::handle_polynomial_activation_op(
+    std::shared_ptr<HESealCipherTensor>& arg_cipher,
+    std::shared_ptr<HEPlainTensor>& arg_plain,
+    std::shared_ptr<HESealCipherTensor>& out_cipher,
+    std::shared_ptr<HEPlainTensor>& out_plain, const NodeWrapper& node_wrapper,
+    const HESealBackend& he_seal_backend) {
+  const Node& node = *node_wrapper.get_node();
+  if (arg_plain != nullptr && out_plain != nullptr) {
+    size_t output_size = arg_plain->get_batched_element_count();
+    ngraph::he::polynomial_seal(arg_plain->get_elements(),
+                                out_plain->get_elements(), output_size,
+                                m_polynomial_activation);
+    return;
+  }
+  if (arg_cipher == nullptr || out_cipher == nullptr) {
+    throw ngraph_error(node.description() + " types not supported");
+  }
+  size_t output_size = arg_cipher->get_batched_element_count();
+  NGRAPH_CHECK(output_size == arg_cipher->num_ciphertexts(), "output size ",
+               output_size, " doesn't match number of elements",
+               out_cipher->num_ciphertexts());
+  ngraph::he::polynomial_seal(arg_cipher->get_elements(),
+                              out_cipher->get_elements(), output_size,
+                              m_polynomial_activation, he_seal_backend);
+}
+
+void ngraph::he::HESealExecutable::handle_server_activation_op(
     std::shared_ptr<HESealCipherTensor>& arg_cipher,
     std::shared_ptr<HESealCipherTensor>& out_cipher,
-    const NodeWrapper& node_wrapper) {
+    const NodeWrapper& node_wrapper, const ActivationRequest& activation,
+    const std::vector<size_t>& element_order) {
   const Node& node = *node_wrapper.get_node();
   bool verbose = verbose_op(node);
   size_t element_count = shape_size(node.get_output_shape(0)) / m_batch_size;
+  const size_t group_size = activation.group_size;
 
   if (arg_cipher == nullptr || out_cipher == nullptr) {
-    NGRAPH_INFO << "Relu types not supported ";
-    throw ngraph_error("Relu types not supported.");
+    NGRAPH_INFO << "Activation types not supported ";
+    throw ngraph_error("Activation types not supported.");
+  }
+  NGRAPH_CHECK(element_count % group_size == 0, "Activation group size ",
+               group_size, " doesn't divide element count ", element_count);
+  NGRAPH_CHECK(element_order.empty() || element_order.size() == element_count,
+               "Element order size ", element_order.size(),
+               " doesn't match element count ", element_count);
+
+  // The client decrypts in the parameter set of the arguments and encrypts the
+  // results in the parameter set of the next segment
+  const size_t parameter_set = input_parameter_set(node);
+  const size_t result_parameter_set = get_parameter_set(node);
+  HESealBackend& he_seal_backend = parameter_set_backend(parameter_set);
+
+  std::vector<std::shared_ptr<SealCiphertextWrapper>> arg_elements =
+      arg_cipher->get_elements();
+  if (!activation.elementwise()) {
+    // The client applies the activation to whole groups, so known values are
+    // sent encrypted as well
+#pragma omp parallel for
+    for (size_t element_idx = 0; element_idx < element_count; ++element_idx) {
+      auto& cipher = arg_elements[element_idx];
+      if (cipher->known_value()) {
+        auto encrypted = he_seal_backend.create_empty_ciphertext();
+        he_seal_backend.encrypt(encrypted, HEPlaintext(cipher->value()),
+                                m_complex_packing);
+        cipher = encrypted;
+      }
+    }
   }
 
   size_t smallest_ind = ngraph::he::match_to_smallest_chain_index(
-      arg_cipher->get_elements(), m_he_seal_backend);
+      arg_elements, he_seal_backend);
 
   if (verbose) {
     NGRAPH_INFO << "Matched moduli to chain ind " << smallest_ind;
   }
-  m_relu_ciphertexts.clear();
-  m_relu_ciphertexts.resize(element_count);
+  m_activation_ciphertexts.clear();
+  m_activation_ciphertexts.resize(element_count);
 
   // TODO: tune
-  const size_t max_relu_message_cnt = 10000;
-
-  m_unknown_relu_idx.clear();
-  m_unknown_relu_idx.reserve(max_relu_message_cnt);
-
-  size_t num_relu_batches = element_count / max_relu_message_cnt;
-  if (element_count % max_relu_message_cnt != 0) {
-    num_relu_batches++;
-  }
-  std::vector<seal::Ciphertext> relu_ciphers;
-  relu_ciphers.reserve(max_relu_message_cnt);
-  for (size_t relu_batch = 0; relu_batch < num_relu_batches; ++relu_batch) {
-    relu_ciphers.clear();
-    m_unknown_relu_idx.clear();
-
-    size_t relu_start_idx = relu_batch * max_relu_message_cnt;
-    size_t relu_end_idx = (relu_batch + 1) * max_relu_message_cnt;
-    if (relu_end_idx > element_count) {
-      relu_end_idx = element_count;
-    }
-    //#pragma omp parallel for
-    for (size_t relu_idx = relu_start_idx; relu_idx < relu_end_idx;
-         ++relu_idx) {
-      auto& cipher = arg_cipher->get_element(relu_idx);
+  const size_t max_activation_message_cnt =
+      std::max(group_size, 10000 / group_size * group_size);
+
+  m_unknown_activation_idx.clear();
+  m_unknown_activation_idx.reserve(max_activation_message_cnt);
+
+  size_t num_activation_batches = element_count / max_activation_message_cnt;
+  if (element_count % max_activation_message_cnt != 0) {
+    num_activation_batches++;
+  }
+  ActivationRequest request = activation;
+  request.parameter_sets.parameter_set = parameter_set;
+  request.parameter_sets.result_parameter_set = result_parameter_set;
+  const std::string activation_prefix = request.save();
+  std::vector<seal::Ciphertext> activation_ciphers;
+  activation_ciphers.reserve(max_activation_message_cnt);
+  for (size_t activation_batch = 0; activation_batch < num_activation_batches;
+       ++activation_batch) {
+    activation_ciphers.clear();
+    m_unknown_activation_idx.clear();
+
+    size_t start_pos = activation_batch * max_activation_message_cnt;
+    size_t end_pos =
+        std::min((activation_batch + 1) * max_activation_message_cnt,
+                 element_count);
+    // Grouped activations visit the elements group by group
+    for (size_t pos = start_pos; pos < end_pos; ++pos) {
+      size_t element_idx = element_order.empty() ? pos : element_order[pos];
+      auto& cipher = arg_elements[element_idx];
       if (cipher->known_value()) {
-        auto value = cipher->value();
-        auto relu = [](float f) { return f > 0 ? f : 0.f; };
-        auto relu_val = relu(value);
-
-        auto cipher = std::make_shared<SealCiphertextWrapper>();
-        cipher->known_value() = true;
-        cipher->value() = relu_val;
-        m_relu_ciphertexts[relu_idx] = cipher;
+        auto known_cipher = std::make_shared<SealCiphertextWrapper>();
+        known_cipher->known_value() = true;
+        known_cipher->value() = activation.apply(cipher->value());
+        m_activation_ciphertexts[element_idx] = known_cipher;
       } else {
-        m_unknown_relu_idx.emplace_back(relu_idx);
-        relu_ciphers.emplace_back(cipher->ciphertext());
+        m_unknown_activation_idx.emplace_back(element_idx);
+        activation_ciphers.emplace_back(cipher->ciphertext());
       }
     }
-    // All relu values known
-    if (relu_ciphers.size() == 0) {
+    // All activation values known
+    if (activation_ciphers.size() == 0) {
       continue;
     }
 
-    auto message_type = MessageType::none;
-    switch (node_wrapper.get_typeid()) {
-      case OP_TYPEID::BoundedRelu: {
-        message_type = MessageType::relu6_request;
-
-        const op::BoundedRelu* bounded_relu =
-            static_cast<const op::BoundedRelu*>(&node);
-        float alpha = bounded_relu->get_alpha();
-        NGRAPH_CHECK(alpha == 6.0f, "BoundedRelu supports only value 6.0f, got",
-                     alpha);
-        break;
-      }
-      case OP_TYPEID::Relu: {
-        message_type = MessageType::relu_request;
-        break;
-      }
-      default:
-        break;
-    }
-
     if (verbose) {
-      NGRAPH_INFO << "Sending relu request size " << relu_ciphers.size();
-    }
-
-    auto relu_message = TCPMessage(message_type, relu_ciphers);
-    m_session->do_write(std::move(relu_message));
+      NGRAPH_INFO << "Sending activation request size "
+                  << activation_ciphers.size();
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(m_activation_mutex);
+      m_activation_results_received = 0;
+      m_round_trip_result_parameter_set = result_parameter_set;
+    }
+    // Stripe over the data streams in whole groups; the client replies to
+    // each chunk at the same offset
+    size_t chunk_count = TCPMessage::chunk_count(
+        ciphertext_size(activation_ciphers.front()));
+    write_chunks(activation_ciphers.size(), chunk_count,
+                 [&activation_ciphers, &activation_prefix](size_t offset,
+                                                           size_t count) {
+                   return TCPMessage(MessageType::activation_request,
+                                     activation_ciphers, offset, count,
+                                     activation_prefix);
+                 },
+                 group_size);
 
     // Acquire lock
-    std::unique_lock<std::mutex> mlock(m_relu_mutex);
+    std::unique_lock<std::mutex> mlock(m_activation_mutex);
 
-    // Wait until Relu is done
-    m_relu_cond.wait(mlock, std::bind(&HESealExecutable::relu_done, this));
+    // Wait until activation is done
+    m_activation_cond.wait(
+        mlock, std::bind(&HESealExecutable::activation_done, this));
 
-    // Reset for next Relu call
-    m_relu_done = false;
+    // Reset for next activation call
+    m_activation_done = false;
   }
-  out_cipher->set_elements(m_relu_ciphertexts);
+  out_cipher->set_elements(m_activation_ciphertexts);
 }
@@ -20,21 +20,41 @@
 #include <boost/asio.hpp>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "he_plain_tensor.hpp"
 #include "he_tensor.hpp"
+#include "ngraph/op/convolution.hpp"
 #include "ngraph/runtime/backend.hpp"
 #include "ngraph/util.hpp"
 #include "node_wrapper.hpp"
+#include "pass/he_depth_analysis.hpp"
+#include "pass/he_rescale_placement.hpp"
+#include "pass/he_scale_planning.hpp"
+#include "seal/activation_request.hpp"
+#include "seal/convolution_taps.hpp"
+#include "seal/eval_key_request.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_cipher_tensor.hpp"
+#include "seal/kernel/kernel_epilogue.hpp"
+#include "seal/linear_plan.hpp"
+#include "seal/polynomial_activation.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_key_store.hpp"
 #include "tcp/tcp_message.hpp"
 #include "tcp/tcp_session.hpp"
+#include "tcp/transport_uri.hpp"
 
 using boost::asio::ip::tcp;
 
@@ -59,6 +79,9 @@ class HESealExecutable : public runtime::Executable {
       m_acceptor->close();
       m_acceptor = nullptr;
       m_session = nullptr;
+      m_data_sessions.clear();
+      // Handles the remaining messages and joins the message handler thread
+      m_message_queue = nullptr;
     }
   }
 
@@ -75,8 +98,15 @@ class HESealExecutable : public runtime::Executable {
 
   size_t get_port() const { return m_port; };
 
+  /// \brief Sets where the server listens for the client, given as
+  /// tcp://<host>:<port> or unix://<socket path>. Defaults to tcp://*:34000, or
+  /// the NGRAPH_HE_SERVER_URI environment variable if set. Must be called
+  /// before the client is enabled
+  void set_server_uri(const std::string& uri);
+  const std::string& get_server_uri() const { return m_server_uri; }
+
   // TODO: merge _done() methods
-  bool relu_done() const { return m_relu_done; };
+  bool activation_done() const { return m_activation_done; };
   bool max_done() const { return m_max_done; };
   bool minimum_done() const { return m_minimum_done; };
 
@@ -86,13 +116,120 @@ class HESealExecutable : public runtime::Executable {
 
   void accept_connection();
 
+  // Accepts data stream connections until m_num_data_streams are open
+  void accept_data_streams();
+
+  // Writes count elements in chunks of at most max_chunk_count elements made
+  // by make_chunk(offset, chunk_count), striped round-robin over the data
+  // streams, or on the control session if there are none. Chunks hold
+  // multiples of granularity elements, e.g. whole Softmax groups, and at
+  // least granularity elements even if that exceeds max_chunk_count
+  std::vector<std::future<void>> write_chunks(
+      size_t count, size_t max_chunk_count,
+      const std::function<TCPMessage(size_t, size_t)>& make_chunk,
+      size_t granularity = 1);
+
   void check_client_supports_function();
 
   void handle_message(const TCPMessage& message);
 
-  void handle_server_relu_op(std::shared_ptr<HESealCipherTensor>& arg0_cipher,
-                             std::shared_ptr<HESealCipherTensor>& out_cipher,
-                             const NodeWrapper& node_wrapper);
+  // Loads count ciphertexts of size ciphertext_size from data into elements
+  // [offset, offset + count) of the client inputs. Throws if the range
+  // exceeds the client inputs or overlaps a chunk received before
+  void load_client_inputs(const char* data, size_t offset, size_t count,
+                          size_t total_count, size_t ciphertext_size);
+
+  // Sends the number of (packed) parameter elements the client should encrypt
+  void send_parameter_size();
+
+  // Requests the evaluation keys in request from the client, or sends the
+  // parameter size if no keys are needed
+  void request_eval_keys(const EvalKeyRequest& request);
+
+  // Caches the session keys received so far under the session token
+  void cache_session_keys();
+
+  // Sends the encryption parameters of the parameter sets other than set 0,
+  // for which the client replies with its keys
+  void send_parameter_sets();
+
+  // Returns the backend holding the context and client keys of parameter_set
+  HESealBackend& parameter_set_backend(size_t parameter_set);
+
+  // Returns the parameter set of the outputs of node
+  size_t get_parameter_set(const Node& node) const;
+
+  // Returns the parameter set of the ciphertext arguments of node, in which
+  // node is computed
+  size_t input_parameter_set(const Node& node) const;
+
+  // Waits until the client sent its keys of parameter_set
+  void wait_for_parameter_set_keys(size_t parameter_set);
+
+  // Creates the client input tensors if they don't exist yet. Must hold
+  // m_client_inputs_mutex
+  void create_client_inputs();
+
+  // Resets the client inputs after a query's result is sent, and loads inputs
+  // of the next query received in the meantime
+  void next_client_query();
+
+  // Computes the convolution reading the client inputs in tiles of outputs
+  // whose inputs have been received, while the remaining inputs arrive
+  void stream_convolution(const ngraph::Node& convolution,
+                          std::shared_ptr<HESealCipherTensor>& arg0_cipher,
+                          std::shared_ptr<HEPlainTensor>& arg1_plain,
+                          std::shared_ptr<HESealCipherTensor>& out0_cipher,
+                          const element::Type& type,
+                          const KernelEpilogue& epilogue, bool verbose);
+
+  // Applies activation to plaintext arguments directly, and to ciphertext
+  // arguments on the client if enabled. element_order lists the elements
+  // group by group for activations of groups of elements, e.g. softmax
+  void handle_activation_op(std::shared_ptr<HESealCipherTensor>& arg_cipher,
+                            std::shared_ptr<HEPlainTensor>& arg_plain,
+                            std::shared_ptr<HESealCipherTensor>& out_cipher,
+                            std::shared_ptr<HEPlainTensor>& out_plain,
+                            const NodeWrapper& node_wrapper,
+                            const ActivationRequest& activation,
+                            const std::vector<size_t>& element_order = {});
+
+  // Evaluates m_polynomial_activation in place of Relu or BoundedRelu, on
+  // ciphertexts without decrypting them
+  void handle_polynomial_activation_op(
+      std::shared_ptr<HESealCipherTensor>& arg_cipher,
+      std::shared_ptr<HEPlainTensor>& arg_plain,
+      std::shared_ptr<HESealCipherTensor>& out_cipher,
+      std::shared_ptr<HEPlainTensor>& out_plain,
+      const NodeWrapper& node_wrapper, const HESealBackend& he_seal_backend);
+
+  // Sends the ciphertexts of arg_cipher to the client, which applies
+  // activation after decrypting them
+  void handle_server_activation_op(
+      std::shared_ptr<HESealCipherTensor>& arg_cipher,
+      std::shared_ptr<HESealCipherTensor>& out_cipher,
+      const NodeWrapper& node_wrapper, const ActivationRequest& activation,
+      const std::vector<size_t>& element_order = {});
+
+  // Returns true if the kernel of node rescales its output ciphertexts
+  bool rescales(const ngraph::Node& node) const {
+    return m_rescale_placement != nullptr &&
+           m_rescale_placement->rescales(&node);
+  }
+
+  // Returns the epilogue of the Convolution, Dot or AvgPool kernel of node:
+  // the rescale placed at node, and the bias of BiasedConvolution and
+  // BiasedDot, which is their third argument
+  KernelEpilogue kernel_epilogue(
+      const ngraph::Node& node,
+      const std::vector<std::shared_ptr<HETensor>>& args) const;
+
+  // Adds the bias of BiasedConvolution or BiasedDot, their third argument, to
+  // the plaintext output, since the plaintext kernels have no epilogue
+  void add_plain_bias(std::shared_ptr<HEPlainTensor>& out_plain,
+                      const std::vector<std::shared_ptr<HETensor>>& args,
+                      const element::Type& type,
+                      const HESealBackend& he_seal_backend);
 
   bool verbose_op(const ngraph::Node& op) {
     return m_verbose_all_ops ||
@@ -123,14 +260,25 @@ class HESealExecutable : public runtime::Executable {
   bool m_enable_client;
   size_t m_batch_size;
   size_t m_port;  // Which port the server is hosted at
+  std::string m_server_uri;  // Where the server listens for the client
 
   std::unordered_map<std::shared_ptr<const Node>, stopwatch> m_timer_map;
   std::vector<NodeWrapper> m_wrapped_nodes;
 
-  std::unique_ptr<tcp::acceptor> m_acceptor;
+  std::unique_ptr<stream_acceptor> m_acceptor;
 
   // Must be shared, since TCPSession uses enable_shared_from_this()
   std::shared_ptr<TCPSession> m_session;
+  // Connections striping bulk ciphertext messages, guarded by
+  // m_session_mutex. m_session remains the control channel
+  std::vector<std::shared_ptr<TCPSession>> m_data_sessions;
+  size_t m_next_data_session{0};
+  // Most data streams offered to the client (NGRAPH_HE_DATA_STREAMS)
+  size_t m_max_data_streams{0};
+  // Data streams the client agreed to open
+  size_t m_num_data_streams{0};
+  // Handles messages received on all sessions, in order
+  std::shared_ptr<TCPMessageQueue> m_message_queue;
   std::thread m_thread;
   boost::asio::io_context m_io_context;
 
@@ -140,7 +288,7 @@ class HESealExecutable : public runtime::Executable {
   std::vector<std::shared_ptr<ngraph::he::HETensor>> m_client_outputs;
 
   std::vector<std::shared_ptr<ngraph::he::SealCiphertextWrapper>>
-      m_relu_ciphertexts;
+      m_activation_ciphertexts;
   std::vector<std::shared_ptr<ngraph::he::SealCiphertextWrapper>>
       m_max_ciphertexts;
   std::vector<std::shared_ptr<ngraph::he::SealCiphertextWrapper>>
@@ -148,13 +296,39 @@ class HESealExecutable : public runtime::Executable {
 
   std::set<std::string> m_verbose_ops;
 
+  // Polynomial evaluated on the server in place of Relu and BoundedRelu
+  // (NGRAPH_HE_POLY_ACTIVATION), if enabled
+  PolynomialActivation m_polynomial_activation;
+
+  // Evaluation keys the client must upload for this function
+  EvalKeyRequest m_eval_key_request;
+  // Number of evaluation key messages not yet received from the client
+  size_t m_pending_eval_keys{0};
+  // Keys of the client session, cached by session token so a reconnecting
+  // client can skip uploading them
+  SealKeySet m_session_keys;
+
   std::shared_ptr<seal::SEALContext> m_context;
 
-  // To trigger when relu is done
-  std::mutex m_relu_mutex;
-  std::condition_variable m_relu_cond;
-  bool m_relu_done;
-  std::vector<size_t> m_unknown_relu_idx;
+  // Backends of the parameter sets of segments after a client round trip, by
+  // parameter set. Parameter set 0 is m_he_seal_backend
+  std::map<size_t, std::shared_ptr<HESealBackend>> m_parameter_set_backends;
+  // Parameter set of the outputs of ops not in parameter set 0
+  std::unordered_map<const Node*, size_t> m_node_parameter_sets;
+  // Parameter set of the results of the pending client round trip
+  size_t m_round_trip_result_parameter_set{0};
+
+  // To trigger when the client sent the keys of a parameter set
+  std::mutex m_parameter_set_mutex;
+  std::condition_variable m_parameter_set_cond;
+  std::set<size_t> m_parameter_set_keys_received;
+
+  // To trigger when the client applied an activation
+  std::mutex m_activation_mutex;
+  std::condition_variable m_activation_cond;
+  bool m_activation_done;
+  std::vector<size_t> m_unknown_activation_idx;
+  size_t m_activation_results_received{0};
 
   // To trigger when maxpool is done
   std::mutex m_max_mutex;
@@ -180,6 +354,98 @@ class HESealExecutable : public runtime::Executable {
   std::mutex m_client_inputs_mutex;
   std::condition_variable m_client_inputs_cond;
   bool m_client_inputs_received;
+  // Number of client inputs loaded without gaps from the first input
+  size_t m_client_inputs_prefix{0};
+  // Loaded chunks (offset => count) not yet contiguous with the prefix
+  std::map<size_t, size_t> m_client_input_chunks;
+  // Chunks (offset => count) of the current query accepted for loading, to
+  // reject chunks received twice
+  std::map<size_t, size_t> m_client_input_ranges;
+
+  // Client query the inputs belong to. The client may send inputs of later
+  // queries while a query is computed; these are held until it is done
+  struct PendingInputChunk {
+    size_t offset;
+    size_t count;
+    size_t total_count;
+    size_t ciphertext_size;
+    std::vector<char> data;
+  };
+  size_t m_client_query_id{0};
+  std::map<size_t, std::vector<PendingInputChunk>> m_pending_input_chunks;
+
+  // Op which is computed while the client inputs are still arriving
+  const Node* m_stream_input_op{nullptr};
+
+  // Ciphertext ops of the function and their multiplicative depth
+  std::shared_ptr<pass::HEDepthAnalysis> m_depth_analysis;
+  // Ops whose kernels rescale their outputs, unless naive rescaling
+  std::shared_ptr<pass::HERescalePlacement> m_rescale_placement;
+  // Encoding scales of the constant weights (NGRAPH_HE_SCALE_PLANNING), if
+  // enabled
+  std::shared_ptr<pass::HEScalePlanning> m_scale_planning;
+  // Fractional bits of precision (NGRAPH_HE_PRECISION_BITS)
+  int m_precision_bits{14};
+  // Index plans of Convolution and Dot ops with sparse or repeated constant
+  // weights
+  std::unordered_map<const Node*, std::unique_ptr<LinearPlan>> m_linear_plans;
+  // Gather-index tables of the Convolution ops computed with the gather
+  // kernel, from their shapes
+  std::unordered_map<const Node*, ConvolutionTaps> m_convolution_taps;
+  // Computes 3x3 convolutions of ciphertexts with plaintexts with the
+  // Winograd kernel (NGRAPH_HE_WINOGRAD)
+  bool m_winograd{false};
+  // Convolution ops computed with the Winograd kernel, with their constant
+  // filter transformed once at compile time
+  struct WinogradConvolution {
+    CoordinateDiff padding_below;
+    std::vector<HEPlaintext> transformed_filter;
+  };
+  std::unordered_map<const Node*, WinogradConvolution> m_winograd_convolutions;
+
+  // Determines which evaluation keys are needed by finding
+  // ciphertext-ciphertext multiplications in the function
+  void set_eval_key_request();
+
+  // Splits the function into segments between client round trips, each of
+  // which uses the cheapest parameter set in NGRAPH_HE_SEAL_SEGMENT_CONFIGS
+  // supporting its multiplicative depth
+  void set_parameter_sets();
+
+  // Compares the backend encryption parameters with the smallest secure
+  // parameters supporting the depth of the function, and writes the latter
+  // to NGRAPH_HE_SEAL_CONFIG_OUT if set
+  void check_encryption_parameters();
+
+  // Finds an op whose computation can start before all client inputs arrive
+  void set_stream_input_op();
+
+  // Returns the gather-index table of the Convolution node, from its shapes
+  ConvolutionTaps make_convolution_taps(const ngraph::Node& node) const;
+
+  // Builds the gather-index tables of the Convolution ops computed with the
+  // gather kernel, shared by all calls. Runs after the index plans and
+  // Winograd convolutions are chosen
+  void set_convolution_taps();
+
+  // Returns the gather-index table of the Convolution node, built on first
+  // use if set_convolution_taps skipped it
+  const ConvolutionTaps& convolution_taps(const ngraph::Node& node);
+
+  // Builds the index plans of the Convolution and Dot ops with constant
+  // weights, which need fewer multiplications with the plan
+  void set_linear_plans();
+
+  // Returns the index plan of node, or nullptr if it has none
+  const LinearPlan* linear_plan(const ngraph::Node& node) const {
+    auto it = m_linear_plans.find(&node);
+    return it == m_linear_plans.end() ? nullptr : it->second.get();
+  }
+
+  // Finds the Convolution ops with constant filters which the Winograd kernel
+  // computes with fewer multiplications than their index plans or
+  // gather-index tables, and transforms their filters
+  void set_winograd_convolutions();
 
   void generate_calls(const element::Type& type, const NodeWrapper& op,
                       const std::vector<std::shared_ptr<HETensor>>& outputs,
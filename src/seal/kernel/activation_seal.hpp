@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "seal/activation_request.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Applies activation to arg. element_order lists the elements group by
+/// group, as returned by grouped_element_order; elementwise activations may
+/// pass an empty element_order
+inline void activation_seal(const std::vector<HEPlaintext>& arg,
+                            std::vector<HEPlaintext>& out,
+                            const ActivationRequest& activation,
+                            const std::vector<size_t>& element_order) {
+  const size_t group_size = activation.group_size;
+  const size_t group_count = arg.size() / group_size;
+  NGRAPH_CHECK(element_order.empty() || element_order.size() == arg.size(),
+               "Element order size ", element_order.size(),
+               " doesn't match element count ", arg.size());
+
+#pragma omp parallel for
+  for (size_t group_idx = 0; group_idx < group_count; ++group_idx) {
+    std::vector<size_t> element_indices(group_size);
+    size_t value_count = 0;
+    for (size_t i = 0; i < group_size; ++i) {
+      size_t pos = group_idx * group_size + i;
+      element_indices[i] = element_order.empty() ? pos : element_order[pos];
+      value_count =
+          std::max(value_count, arg[element_indices[i]].num_values());
+    }
+
+    // Single values are broadcast over the batch
+    std::vector<std::vector<float>> out_values(group_size,
+                                               std::vector<float>(value_count));
+    std::vector<float> group_values(group_size);
+    for (size_t value_idx = 0; value_idx < value_count; ++value_idx) {
+      for (size_t i = 0; i < group_size; ++i) {
+        const auto& values = arg[element_indices[i]].values();
+        group_values[i] = values.size() == 1 ? values[0] : values[value_idx];
+      }
+      activation.apply(group_values);
+      for (size_t i = 0; i < group_size; ++i) {
+        out_values[i][value_idx] = group_values[i];
+      }
+    }
+    for (size_t i = 0; i < group_size; ++i) {
+      out[element_indices[i]].values() = std::move(out_values[i]);
+    }
+  }
+}
+
+/// \brief Applies activation to arg by decrypting it. Not privacy-preserving;
+/// used when no client is enabled
+inline void activation_seal(
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg,
+    std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
+    const ActivationRequest& activation,
+    const std::vector<size_t>& element_order,
+    const HESealBackend& he_seal_backend) {
+  const size_t count = arg.size();
+  std::vector<HEPlaintext> plains(count);
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    he_seal_backend.decrypt(plains[i], *arg[i]);
+  }
+
+  activation_seal(plains, plains, activation, element_order);
+
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    he_seal_backend.encrypt(out[i], plains[i],
+                            he_seal_backend.complex_packing());
+  }
+}
+}  // namespace he
+}  // namespace ngraph
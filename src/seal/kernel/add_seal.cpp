@@ -69,8 +69,7 @@ void ngraph::he::scalar_add_seal(
     return;
   }
 
-  // TODO: handle case where arg1 = {0, 0, 0, 0, ...}
-  bool add_zero = arg1.is_single_value() && (arg1.values()[0] == 0.0f);
+  bool add_zero = arg1.is_uniform() && (arg1.values()[0] == 0.0f);
 
   if (add_zero) {
     SealCiphertextWrapper tmp(arg0);
@@ -81,7 +80,7 @@ void ngraph::he::scalar_add_seal(
   } else {
     bool complex_packing = arg0.complex_packing();
     // TODO: optimize for adding single complex number
-    if (arg1.is_single_value() && !complex_packing) {
+    if (arg1.is_uniform() && !complex_packing) {
       float value = arg1.values()[0];
       double double_val = double(value);
       add_plain(arg0.ciphertext(), double_val, out->ciphertext(),
@@ -25,6 +25,7 @@
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_plaintext_wrapper.hpp"
+#include "seal/seal_util.hpp"
 
 namespace ngraph {
 namespace he {
@@ -57,11 +58,14 @@ inline void add_seal(
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg1,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const element::Type& element_type, const HESealBackend& he_seal_backend,
-    size_t count,
+    size_t count, bool rescale = false,
     const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_add_seal(*arg0[i], *arg1[i], out[i], element_type, he_seal_backend);
+    if (rescale) {
+      rescale_output_inplace(*out[i], he_seal_backend);
+    }
   }
 }
 
@@ -70,12 +74,15 @@ inline void add_seal(
     const std::vector<HEPlaintext>& arg1,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const element::Type& element_type, const HESealBackend& he_seal_backend,
-    size_t count,
+    size_t count, bool rescale = false,
     const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_add_seal(*arg0[i], arg1[i], out[i], element_type, he_seal_backend,
                     pool);
+    if (rescale) {
+      rescale_output_inplace(*out[i], he_seal_backend, pool);
+    }
   }
 }
 
@@ -84,9 +91,10 @@ inline void add_seal(
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg1,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const element::Type& element_type, const HESealBackend& he_seal_backend,
-    size_t count,
+    size_t count, bool rescale = false,
     const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
-  add_seal(arg1, arg0, out, element_type, he_seal_backend, count, pool);
+  add_seal(arg1, arg0, out, element_type, he_seal_backend, count, rescale,
+           pool);
 }
 
 inline void add_seal(std::vector<HEPlaintext>& arg0,
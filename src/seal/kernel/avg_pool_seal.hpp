@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -25,18 +26,36 @@
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/kernel_epilogue.hpp"
 #include "seal/kernel/multiply_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_util.hpp"
 
 namespace ngraph {
 namespace he {
+/// \brief Returns true if every pooling window averages the same number of
+/// elements. Then the division by the window size of ciphertexts is a scale
+/// division, which consumes no level and needs no rescaling
+inline bool avg_pool_scale_division(const Shape& padding_below,
+                                    const Shape& padding_above,
+                                    bool include_padding_in_avg_computation) {
+  auto is_zero = [](size_t pad) { return pad == 0; };
+  return include_padding_in_avg_computation ||
+         (std::all_of(padding_below.begin(), padding_below.end(), is_zero) &&
+          std::all_of(padding_above.begin(), padding_above.end(), is_zero));
+}
+
 inline void avg_pool_seal(
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const Shape& arg_shape, const Shape& out_shape, const Shape& window_shape,
     const Strides& window_movement_strides, const Shape& padding_below,
     const Shape& padding_above, bool include_padding_in_avg_computation,
-    const HESealBackend& he_seal_backend) {
+    const HESealBackend& he_seal_backend,
+    const KernelEpilogue& epilogue = KernelEpilogue()) {
+  const bool scale_division = avg_pool_scale_division(
+      padding_below, padding_above, include_padding_in_avg_computation);
+
   // At the outermost level we will walk over every output coordinate O.
   CoordinateTransform output_transform(out_shape);
 
@@ -144,12 +163,22 @@ inline void avg_pool_seal(
     if (n_elements == 0) {
       throw std::runtime_error("AvgPool elements == 0, must be non-zero");
     }
-    auto inv_n_elements = HEPlaintext({1.f / n_elements});
-
-    ngraph::he::scalar_multiply_seal(*sum, inv_n_elements, sum, element::f32,
-                                     he_seal_backend);
+    if (scale_division) {
+      if (sum->known_value()) {
+        sum->value() /= n_elements;
+      } else {
+        divide_scale_inplace(sum->ciphertext(), n_elements, he_seal_backend);
+      }
+    } else {
+      auto inv_n_elements = HEPlaintext({1.f / n_elements});
+      ngraph::he::scalar_multiply_seal(*sum, inv_n_elements, sum, element::f32,
+                                       he_seal_backend);
+    }
 
-    out[output_transform.index(out_coord)] = sum;
+    const size_t out_index = output_transform.index(out_coord);
+    out[out_index] = sum;
+    apply_kernel_epilogue(out[out_index], out_index, epilogue, element::f32,
+                          he_seal_backend);
   }
 };
 
@@ -16,11 +16,11 @@
 
 #pragma once
 
+#include <cmath>
 #include <memory>
 #include <vector>
 
 #include "he_plaintext.hpp"
-#include "ngraph/coordinate_transform.hpp"
 #include "ngraph/shape_util.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
@@ -31,64 +31,53 @@
 
 namespace ngraph {
 namespace he {
-void batch_norm_inference_seal(
-    double eps, std::vector<HEPlaintext>& gamma, std::vector<HEPlaintext>& beta,
+/// \brief Computes gamma * (input - mean) / sqrt(variance + eps) + beta as
+/// scale * input + bias, with scale and bias precomputed per channel. Both are
+/// single values, so each element costs one scalar multiply_plain and one
+/// scalar add_plain, without encoding a plaintext
+inline void batch_norm_inference_seal(
+    double eps, const std::vector<HEPlaintext>& gamma,
+    const std::vector<HEPlaintext>& beta,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& input,
-    std::vector<HEPlaintext>& mean, std::vector<HEPlaintext>& variance,
+    const std::vector<HEPlaintext>& mean,
+    const std::vector<HEPlaintext>& variance,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& normed_input,
-    const Shape& input_shape, const size_t batch_size,
-    const HESealBackend& he_seal_backend) {
-  CoordinateTransform input_transform(input_shape);
+    const Shape& input_shape, const HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(input_shape.size() >= 2, "BatchNorm input shape ", input_shape,
+               " has no channel axis");
+  const size_t channels = input_shape[1];
+  NGRAPH_CHECK(gamma.size() == channels && beta.size() == channels &&
+                   mean.size() == channels && variance.size() == channels,
+               "BatchNorm parameters do not match ", channels, " channels");
 
-  // Store input coordinates for parallelization
-  std::vector<ngraph::Coordinate> input_coords;
-  for (const Coordinate& in_coord : input_transform) {
-    input_coords.emplace_back(in_coord);
+  std::vector<HEPlaintext> channel_scales(channels);
+  std::vector<HEPlaintext> channel_biases(channels);
+  for (size_t c = 0; c < channels; ++c) {
+    NGRAPH_CHECK(gamma[c].is_single_value());
+    NGRAPH_CHECK(beta[c].is_single_value());
+    NGRAPH_CHECK(mean[c].is_single_value());
+    NGRAPH_CHECK(variance[c].is_single_value());
+    double scale =
+        gamma[c].values()[0] / std::sqrt(variance[c].values()[0] + eps);
+    double bias = beta[c].values()[0] - scale * mean[c].values()[0];
+    channel_scales[c] = HEPlaintext(static_cast<float>(scale));
+    channel_biases[c] = HEPlaintext(static_cast<float>(bias));
   }
-  size_t input_transform_size = input_coords.size();
 
-#pragma omp parallel for
-  for (size_t i = 0; i < input_transform_size; ++i) {
-    Coordinate input_coord = input_coords[i];
-    // for (Coordinate input_coord : input_transform) {
-    auto channel_num = input_coord[1];
-    auto channel_gamma = gamma[channel_num];
-    auto channel_beta = beta[channel_num];
-    auto channel_mean = mean[channel_num];
-    auto channel_var = variance[channel_num];
-
-    auto input_index = input_transform.index(input_coord);
-
-    std::vector<float> channel_gamma_vals = channel_gamma.values();
-    std::vector<float> channel_beta_vals = channel_beta.values();
-    std::vector<float> channel_mean_vals = channel_mean.values();
-    std::vector<float> channel_var_vals = channel_var.values();
-
-    NGRAPH_CHECK(channel_gamma_vals.size() == 1);
-    NGRAPH_CHECK(channel_beta_vals.size() == 1);
-    NGRAPH_CHECK(channel_mean_vals.size() == 1);
-    NGRAPH_CHECK(channel_var_vals.size() == 1);
-
-    float scale = channel_gamma_vals[0] / std::sqrt(channel_var_vals[0] + eps);
-    float bias =
-        channel_beta_vals[0] - (channel_gamma_vals[0] * channel_mean_vals[0]) /
-                                   std::sqrt(channel_var_vals[0] + eps);
-
-    std::vector<float> scale_vec(batch_size, scale);
-    std::vector<float> bias_vec(batch_size, bias);
-
-    auto plain_scale = HEPlaintext(scale_vec);
-    auto plain_bias = HEPlaintext(bias_vec);
+  const size_t input_size = shape_size(input_shape);
+  // Number of consecutive elements of each channel
+  const size_t channel_size = input_size / (input_shape[0] * channels);
 
+#pragma omp parallel for
+  for (size_t i = 0; i < input_size; ++i) {
+    const size_t channel = (i / channel_size) % channels;
     auto output = he_seal_backend.create_empty_ciphertext();
-
-    ngraph::he::scalar_multiply_seal(*input[input_index], plain_scale, output,
-                                     element::f32, he_seal_backend);
-
-    ngraph::he::scalar_add_seal(*output, plain_bias, output, element::f32,
-                                he_seal_backend);
-    normed_input[input_index] = output;
+    ngraph::he::scalar_multiply_seal(*input[i], channel_scales[channel],
+                                     output, element::f32, he_seal_backend);
+    ngraph::he::scalar_add_seal(*output, channel_biases[channel], output,
+                                element::f32, he_seal_backend);
+    normed_input[i] = output;
   }
-};
+}
 }  // namespace he
 }  // namespace ngraph
@@ -21,21 +21,27 @@
 
 #include "he_plaintext.hpp"
 #include "ngraph/coordinate_transform.hpp"
+#include "ngraph/shape.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/kernel_epilogue.hpp"
 #include "seal/kernel/multiply_seal.hpp"
+#include "seal/linear_plan.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_util.hpp"
 
 namespace ngraph {
 namespace he {
 // TODO: templatize?
+// The ciphertext kernels apply epilogue to each output
 inline void dot_seal(
     const std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg0,
     const std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg1,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
     size_t reduction_axes_count, const element::Type& element_type,
-    const HESealBackend& he_seal_backend) {
+    const HESealBackend& he_seal_backend,
+    const KernelEpilogue& epilogue = KernelEpilogue()) {
   // Get the sizes of the dot axes. It's easiest to pull them from arg1
   // because they're right up front.
   Shape dot_axis_sizes(reduction_axes_count);
@@ -153,6 +159,8 @@ inline void dot_seal(
     } else {
       out[out_index] = sum;
     }
+    apply_kernel_epilogue(out[out_index], out_index, epilogue, element_type,
+                          he_seal_backend, pool);
   }
 }
 // End CCC
@@ -164,7 +172,8 @@ inline void dot_seal(
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
     size_t reduction_axes_count, const element::Type& element_type,
-    const HESealBackend& he_seal_backend) {
+    const HESealBackend& he_seal_backend,
+    const KernelEpilogue& epilogue = KernelEpilogue()) {
   // Get the sizes of the dot axes. It's easiest to pull them from arg1
   // because they're right up front.
   Shape dot_axis_sizes(reduction_axes_count);
@@ -283,6 +292,8 @@ inline void dot_seal(
     } else {
       out[out_index] = sum;
     }
+    apply_kernel_epilogue(out[out_index], out_index, epilogue, element_type,
+                          he_seal_backend, pool);
   }
 }
 
@@ -292,7 +303,8 @@ inline void dot_seal(
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
     size_t reduction_axes_count, const element::Type& element_type,
-    const HESealBackend& he_seal_backend) {
+    const HESealBackend& he_seal_backend,
+    const KernelEpilogue& epilogue = KernelEpilogue()) {
   // Get the sizes of the dot axes. It's easiest to pull them from arg1
   // because they're right up front.
   Shape dot_axis_sizes(reduction_axes_count);
@@ -411,6 +423,8 @@ inline void dot_seal(
     } else {
       out[out_index] = sum;
     }
+    apply_kernel_epilogue(out[out_index], out_index, epilogue, element_type,
+                          he_seal_backend, pool);
   }
 }
 
@@ -531,5 +545,60 @@ inline void dot_seal(const std::vector<HEPlaintext>& arg0,
     out[out_index] = sum;
   }
 }
+
+/// \brief Returns, for each output index, the pairs of the arg0 index and the
+/// arg1 index which the dot multiplies for that output
+inline std::vector<LinearPlan::Taps> dot_taps(const Shape& arg0_shape,
+                                              const Shape& arg1_shape,
+                                              const Shape& out_shape,
+                                              size_t reduction_axes_count) {
+  Shape dot_axis_sizes(reduction_axes_count);
+  std::copy(arg1_shape.begin(), arg1_shape.begin() + reduction_axes_count,
+            dot_axis_sizes.begin());
+
+  size_t arg0_projected_rank = arg0_shape.size() - reduction_axes_count;
+  size_t arg1_projected_rank = arg1_shape.size() - reduction_axes_count;
+  Shape arg0_projected_shape(arg0_projected_rank);
+  std::copy(arg0_shape.begin(), arg0_shape.begin() + arg0_projected_rank,
+            arg0_projected_shape.begin());
+  Shape arg1_projected_shape(arg1_projected_rank);
+  std::copy(arg1_shape.begin() + reduction_axes_count, arg1_shape.end(),
+            arg1_projected_shape.begin());
+
+  CoordinateTransform arg0_transform(arg0_shape);
+  CoordinateTransform arg1_transform(arg1_shape);
+  CoordinateTransform output_transform(out_shape);
+  CoordinateTransform dot_axes_transform(dot_axis_sizes);
+
+  std::vector<LinearPlan::Taps> taps(shape_size(out_shape));
+  for (const Coordinate& arg0_projected_coord :
+       CoordinateTransform(arg0_projected_shape)) {
+    for (const Coordinate& arg1_projected_coord :
+         CoordinateTransform(arg1_projected_shape)) {
+      // The output coordinate is the concatenation of the projected
+      // coordinates
+      Coordinate out_coord(arg0_projected_coord);
+      out_coord.insert(out_coord.end(), arg1_projected_coord.begin(),
+                       arg1_projected_coord.end());
+      LinearPlan::Taps& out_taps = taps[output_transform.index(out_coord)];
+
+      Coordinate arg0_coord(arg0_shape.size());
+      Coordinate arg1_coord(arg1_shape.size());
+      auto arg0_it = std::copy(arg0_projected_coord.begin(),
+                               arg0_projected_coord.end(), arg0_coord.begin());
+      for (const Coordinate& dot_axis_positions : dot_axes_transform) {
+        std::copy(dot_axis_positions.begin(), dot_axis_positions.end(),
+                  arg0_it);
+        auto arg1_it = std::copy(dot_axis_positions.begin(),
+                                 dot_axis_positions.end(), arg1_coord.begin());
+        std::copy(arg1_projected_coord.begin(), arg1_projected_coord.end(),
+                  arg1_it);
+        out_taps.emplace_back(arg0_transform.index(arg0_coord),
+                              arg1_transform.index(arg1_coord));
+      }
+    }
+  }
+  return taps;
+}
 }  // namespace he
 }  // namespace ngraph
@@ -0,0 +1,56 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "ngraph/type/element_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/add_seal.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Per-output work which the Convolution, Dot and AvgPool kernels apply
+/// to each output ciphertext right after computing it, while it is still in
+/// cache, instead of in separate passes over the output tensor
+struct KernelEpilogue {
+  /// \brief Plaintext added to the outputs, with the layout of the output
+  /// tensor, e.g. the bias of BiasedConvolution. Unused if nullptr
+  const std::vector<HEPlaintext>* bias{nullptr};
+  /// \brief Whether to rescale the outputs after adding the bias
+  bool rescale{false};
+};
+
+inline void apply_kernel_epilogue(
+    std::shared_ptr<SealCiphertextWrapper>& out, size_t out_index,
+    const KernelEpilogue& epilogue, const element::Type& element_type,
+    const HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
+  if (epilogue.bias != nullptr) {
+    scalar_add_seal(*out, (*epilogue.bias)[out_index], out, element_type,
+                    he_seal_backend, pool);
+  }
+  if (epilogue.rescale) {
+    rescale_output_inplace(*out, he_seal_backend, pool);
+  }
+}
+}  // namespace he
+}  // namespace ngraph
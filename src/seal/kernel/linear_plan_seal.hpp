@@ -0,0 +1,84 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "ngraph/type/element_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/kernel_epilogue.hpp"
+#include "seal/kernel/multiply_seal.hpp"
+#include "seal/linear_plan.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Computes the Convolution or Dot of the ciphertexts arg with the
+/// constant weights of plan, with one multiplication per distinct nonzero
+/// weight of each output
+inline void linear_plan_seal(
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg,
+    std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
+    const LinearPlan& plan, const element::Type& element_type,
+    const HESealBackend& he_seal_backend,
+    const KernelEpilogue& epilogue = KernelEpilogue()) {
+  NGRAPH_CHECK(out.size() == plan.output_count(), "Index plan of ",
+               plan.output_count(), " outputs does not match ", out.size(),
+               " outputs");
+#pragma omp parallel for
+  for (size_t out_index = 0; out_index < plan.output_count(); ++out_index) {
+    // Init thread-local memory pool for each thread
+    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+
+    std::shared_ptr<SealCiphertextWrapper> sum;
+    for (const LinearPlan::Group& group : plan.groups(out_index)) {
+      // Sum the inputs which share the weight before multiplying
+      std::shared_ptr<SealCiphertextWrapper> inputs =
+          arg[group.input_indices[0]];
+      if (group.input_indices.size() > 1) {
+        inputs = std::make_shared<SealCiphertextWrapper>(*inputs);
+        for (size_t i = 1; i < group.input_indices.size(); ++i) {
+          scalar_add_seal(*inputs, *arg[group.input_indices[i]], inputs,
+                          element_type, he_seal_backend, pool);
+        }
+      }
+      HEPlaintext weight(group.weight);
+      weight.encoding_scale() = plan.encoding_scale();
+      auto prod = he_seal_backend.create_empty_ciphertext(pool);
+      scalar_multiply_seal(*inputs, weight, prod, element_type,
+                           he_seal_backend, pool);
+      if (sum == nullptr) {
+        sum = prod;
+      } else {
+        scalar_add_seal(*sum, *prod, sum, element_type, he_seal_backend, pool);
+      }
+    }
+    if (sum == nullptr) {
+      sum = std::make_shared<SealCiphertextWrapper>();
+      sum->known_value() = true;
+      sum->value() = 0;
+    }
+    out[out_index] = sum;
+    apply_kernel_epilogue(out[out_index], out_index, epilogue, element_type,
+                          he_seal_backend, pool);
+  }
+}
+}  // namespace he
+}  // namespace ngraph
@@ -102,11 +102,14 @@ void ngraph::he::scalar_multiply_seal(
                   [](float f) { return std::abs(f) < 1e-5f; })) {
     out->known_value() = true;
     out->value() = 0;
-  } else if (arg1.is_single_value()) {
+  } else if (arg1.is_uniform()) {
+    // Scalar multiplication avoids encoding the plaintext
     double value = static_cast<double>(arg1.values()[0]);
 
-    multiply_plain(arg0.ciphertext(), value, out->ciphertext(), he_seal_backend,
-                   pool);
+    multiply_plain(arg0.ciphertext(), value,
+                   plaintext_multiply_scale(arg0.ciphertext(), arg1,
+                                            he_seal_backend),
+                   out->ciphertext(), he_seal_backend, pool);
 
     if (out->ciphertext().is_transparent()) {
       NGRAPH_WARN << "Result ciphertext is transparent";
@@ -121,8 +124,10 @@ void ngraph::he::scalar_multiply_seal(
   } else {
     // Never complex-pack for multiplication
     auto p = SealPlaintextWrapper(false);
-    he_seal_backend.encode(p, arg1, arg0.ciphertext().parms_id(),
-                           arg0.ciphertext().scale(), false);
+    he_seal_backend.encode(
+        p, arg1, arg0.ciphertext().parms_id(),
+        plaintext_multiply_scale(arg0.ciphertext(), arg1, he_seal_backend),
+        false);
 
     size_t chain_ind0 = get_chain_index(arg0, he_seal_backend);
     size_t chain_ind1 = get_chain_index(p.plaintext(), he_seal_backend);
@@ -0,0 +1,188 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+#include <map>
+
+#include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/multiply_seal.hpp"
+#include "seal/kernel/polynomial_seal.hpp"
+#include "seal/seal_util.hpp"
+
+namespace {
+using CipherPtr = std::shared_ptr<ngraph::he::SealCiphertextWrapper>;
+
+// Returns coefficient * arg, rescaled unless coefficient is +-1
+CipherPtr multiply_scalar(const CipherPtr& arg, double coefficient,
+                          const ngraph::he::HESealBackend& he_seal_backend) {
+  auto out = std::make_shared<ngraph::he::SealCiphertextWrapper>(*arg);
+  if (coefficient == -1) {
+    he_seal_backend.get_evaluator()->negate_inplace(out->ciphertext());
+  } else if (coefficient != 1) {
+    ngraph::he::multiply_plain_inplace(out->ciphertext(), coefficient,
+                                       he_seal_backend);
+    he_seal_backend.get_evaluator()->rescale_to_next_inplace(
+        out->ciphertext());
+  }
+  return out;
+}
+
+// Returns arg0 * arg1, relinearized and rescaled
+CipherPtr multiply_rescale(const CipherPtr& arg0, const CipherPtr& arg1,
+                           const ngraph::he::HESealBackend& he_seal_backend) {
+  // Matching the chain indices modifies the arguments, which may be cached
+  // powers
+  auto lhs = std::make_shared<ngraph::he::SealCiphertextWrapper>(*arg0);
+  auto rhs = arg0 == arg1
+                 ? lhs
+                 : std::make_shared<ngraph::he::SealCiphertextWrapper>(*arg1);
+  auto out = std::make_shared<ngraph::he::SealCiphertextWrapper>(false);
+  ngraph::he::scalar_multiply_seal(*lhs, *rhs, out, ngraph::element::f32,
+                                   he_seal_backend);
+  he_seal_backend.get_evaluator()->rescale_to_next_inplace(out->ciphertext());
+  return out;
+}
+
+// Returns arg0 + arg1, where nullptr stands for zero. Modifies arg0
+CipherPtr add(const CipherPtr& arg0, const CipherPtr& arg1,
+              const ngraph::he::HESealBackend& he_seal_backend) {
+  if (arg0 == nullptr) {
+    return arg1;
+  }
+  if (arg1 == nullptr) {
+    return arg0;
+  }
+  CipherPtr out = arg0;
+  ngraph::he::scalar_add_seal(*arg0, *arg1, out, ngraph::element::f32,
+                              he_seal_backend);
+  return out;
+}
+
+// Powers of a ciphertext x, where x^n = x^p * x^(n - p) for the largest power
+// of two p < n, so x^n has the minimal depth ceil(log2(n))
+class PowerCache {
+ public:
+  PowerCache(const CipherPtr& x,
+             const ngraph::he::HESealBackend& he_seal_backend)
+      : m_he_seal_backend(he_seal_backend) {
+    m_powers[1] = x;
+  }
+
+  const CipherPtr& get(size_t n) {
+    auto it = m_powers.find(n);
+    if (it != m_powers.end()) {
+      return it->second;
+    }
+    size_t p = 1;
+    while (2 * p < n) {
+      p *= 2;
+    }
+    CipherPtr power = multiply_rescale(get(p), get(n - p), m_he_seal_backend);
+    return m_powers[n] = power;
+  }
+
+ private:
+  const ngraph::he::HESealBackend& m_he_seal_backend;
+  std::map<size_t, CipherPtr> m_powers;
+};
+
+// Returns sum_{i in (begin, end)} c_i x^(i - begin), i.e. the block of
+// coefficients [begin, end) without its constant term, or nullptr if it is
+// zero. Blocks of more than baby_step + 1 coefficients are split into
+// quotient and remainder of a giant step power x^m, i.e.
+// q(x) * x^m + r(x), as in the Paterson-Stockmeyer algorithm
+CipherPtr evaluate_block(const ngraph::he::PolynomialActivation& polynomial,
+                         size_t begin, size_t end, PowerCache& powers,
+                         const ngraph::he::HESealBackend& he_seal_backend) {
+  const std::vector<double>& coefficients = polynomial.coefficients();
+  end = polynomial.trimmed_end(begin, end);
+  if (end - begin <= polynomial.baby_step() + 1) {
+    CipherPtr result;
+    for (size_t i = begin + 1; i < end; ++i) {
+      if (coefficients[i] != 0) {
+        result = add(result,
+                     multiply_scalar(powers.get(i - begin), coefficients[i],
+                                     he_seal_backend),
+                     he_seal_backend);
+      }
+    }
+    return result;
+  }
+
+  const size_t giant_step = polynomial.split_step(end - begin);
+  const size_t high_begin = begin + giant_step;
+  // The constant term of the quotient multiplies x^m by a scalar
+  CipherPtr high;
+  if (coefficients[high_begin] != 0) {
+    high = multiply_scalar(powers.get(giant_step), coefficients[high_begin],
+                           he_seal_backend);
+  }
+  CipherPtr quotient =
+      evaluate_block(polynomial, high_begin, end, powers, he_seal_backend);
+  if (quotient != nullptr) {
+    high = add(high,
+               multiply_rescale(quotient, powers.get(giant_step),
+                                he_seal_backend),
+               he_seal_backend);
+  }
+  CipherPtr low = evaluate_block(polynomial, begin, high_begin, powers,
+                                 he_seal_backend);
+  return add(high, low, he_seal_backend);
+}
+}  // namespace
+
+void ngraph::he::scalar_polynomial_seal(
+    const HEPlaintext& arg, HEPlaintext& out,
+    const PolynomialActivation& polynomial) {
+  const std::vector<float>& arg_vals = arg.values();
+  std::vector<float> out_vals(arg.num_values());
+  std::transform(arg_vals.begin(), arg_vals.end(), out_vals.begin(),
+                 [&polynomial](float f) { return polynomial.evaluate(f); });
+  out.values() = out_vals;
+}
+
+void ngraph::he::scalar_polynomial_seal(
+    const SealCiphertextWrapper& arg,
+    std::shared_ptr<SealCiphertextWrapper>& out,
+    const PolynomialActivation& polynomial,
+    const HESealBackend& he_seal_backend) {
+  if (arg.known_value()) {
+    out->known_value() = true;
+    out->value() = polynomial.evaluate(arg.value());
+    out->complex_packing() = arg.complex_packing();
+    return;
+  }
+  NGRAPH_CHECK(!arg.complex_packing(),
+               "Polynomial activations do not support complex packing");
+  const size_t depth = polynomial.depth();
+  NGRAPH_CHECK(get_chain_index(arg, he_seal_backend) >= depth,
+               "Polynomial activation of depth ", depth,
+               " exceeds the remaining multiplicative depth ",
+               get_chain_index(arg, he_seal_backend));
+
+  auto x = std::make_shared<SealCiphertextWrapper>(arg);
+  PowerCache powers(x, he_seal_backend);
+  const std::vector<double>& coefficients = polynomial.coefficients();
+  CipherPtr result = evaluate_block(polynomial, 0, coefficients.size(),
+                                    powers, he_seal_backend);
+  NGRAPH_CHECK(result != nullptr, "Polynomial activation is constant");
+  if (coefficients[0] != 0) {
+    add_plain_inplace(result->ciphertext(), coefficients[0], he_seal_backend);
+  }
+  result->known_value() = false;
+  result->complex_packing() = false;
+  out = result;
+}
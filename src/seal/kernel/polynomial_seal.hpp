@@ -0,0 +1,58 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/polynomial_activation.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph {
+namespace he {
+void scalar_polynomial_seal(const HEPlaintext& arg, HEPlaintext& out,
+                            const PolynomialActivation& polynomial);
+
+/// \brief Evaluates polynomial on arg with the Paterson-Stockmeyer algorithm,
+/// consuming polynomial.depth() rescalings
+void scalar_polynomial_seal(const SealCiphertextWrapper& arg,
+                            std::shared_ptr<SealCiphertextWrapper>& out,
+                            const PolynomialActivation& polynomial,
+                            const HESealBackend& he_seal_backend);
+
+inline void polynomial_seal(const std::vector<HEPlaintext>& arg,
+                            std::vector<HEPlaintext>& out, size_t count,
+                            const PolynomialActivation& polynomial) {
+  for (size_t i = 0; i < count; ++i) {
+    scalar_polynomial_seal(arg[i], out[i], polynomial);
+  }
+}
+
+inline void polynomial_seal(
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg,
+    std::vector<std::shared_ptr<SealCiphertextWrapper>>& out, size_t count,
+    const PolynomialActivation& polynomial,
+    const HESealBackend& he_seal_backend) {
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    scalar_polynomial_seal(*arg[i], out[i], polynomial, he_seal_backend);
+  }
+}
+}  // namespace he
+}  // namespace ngraph
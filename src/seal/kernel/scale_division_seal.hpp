@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph {
+namespace he {
+inline void scalar_scale_division_seal(const HEPlaintext& arg,
+                                       HEPlaintext& out, size_t divisor) {
+  std::vector<float> out_vals(arg.values());
+  for (float& value : out_vals) {
+    value /= divisor;
+  }
+  out.values() = out_vals;
+}
+
+inline void scalar_scale_division_seal(
+    const SealCiphertextWrapper& arg,
+    std::shared_ptr<SealCiphertextWrapper>& out, size_t divisor,
+    const HESealBackend& he_seal_backend) {
+  out = std::make_shared<SealCiphertextWrapper>(arg);
+  if (arg.known_value()) {
+    out->value() = arg.value() / divisor;
+  } else {
+    divide_scale_inplace(out->ciphertext(), divisor, he_seal_backend);
+  }
+}
+
+inline void scale_division_seal(const std::vector<HEPlaintext>& arg,
+                                std::vector<HEPlaintext>& out, size_t divisor,
+                                size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    scalar_scale_division_seal(arg[i], out[i], divisor);
+  }
+}
+
+inline void scale_division_seal(
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg,
+    std::vector<std::shared_ptr<SealCiphertextWrapper>>& out, size_t divisor,
+    const HESealBackend& he_seal_backend, size_t count) {
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    scalar_scale_division_seal(*arg[i], out[i], divisor, he_seal_backend);
+  }
+}
+}  // namespace he
+}  // namespace ngraph
@@ -23,6 +23,7 @@
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_plaintext_wrapper.hpp"
+#include "seal/seal_util.hpp"
 
 namespace ngraph {
 namespace he {
@@ -51,12 +52,15 @@ inline void subtract_seal(
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg1,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const element::Type& element_type, const HESealBackend& he_seal_backend,
-    size_t count,
+    size_t count, bool rescale = false,
     const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_subtract_seal(*arg0[i], *arg1[i], out[i], element_type,
                          he_seal_backend);
+    if (rescale) {
+      rescale_output_inplace(*out[i], he_seal_backend);
+    }
   }
 }
 
@@ -65,11 +69,14 @@ inline void subtract_seal(
     const std::vector<HEPlaintext>& arg1,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const element::Type& element_type, const HESealBackend& he_seal_backend,
-    size_t count) {
+    size_t count, bool rescale = false) {
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_subtract_seal(*arg0[i], arg1[i], out[i], element_type,
                          he_seal_backend);
+    if (rescale) {
+      rescale_output_inplace(*out[i], he_seal_backend);
+    }
   }
 }
 
@@ -78,11 +85,14 @@ inline void subtract_seal(
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg1,
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
     const element::Type& element_type, const HESealBackend& he_seal_backend,
-    size_t count) {
+    size_t count, bool rescale = false) {
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_subtract_seal(arg0[i], *arg1[i], out[i], element_type,
                          he_seal_backend);
+    if (rescale) {
+      rescale_output_inplace(*out[i], he_seal_backend);
+    }
   }
 }
 
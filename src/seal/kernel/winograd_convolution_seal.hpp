@@ -0,0 +1,289 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/coordinate_diff.hpp"
+#include "ngraph/shape.hpp"
+#include "ngraph/strides.hpp"
+#include "ngraph/type/element_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/kernel_epilogue.hpp"
+#include "seal/kernel/multiply_seal.hpp"
+#include "seal/kernel/negate_seal.hpp"
+#include "seal/kernel/subtract_seal.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Returns true if the Winograd kernel supports the convolution: 2D
+/// with a 3x3 filter, unit strides and no dilation
+inline bool winograd_applicable(const Shape& arg1_shape,
+                                const Strides& window_movement_strides,
+                                const Strides& window_dilation_strides,
+                                const Strides& data_dilation_strides) {
+  auto is_unit = [](const Strides& strides) {
+    for (size_t stride : strides) {
+      if (stride != 1) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return arg1_shape.size() == 4 && arg1_shape[2] == 3 && arg1_shape[3] == 3 &&
+         is_unit(window_movement_strides) && is_unit(window_dilation_strides) &&
+         is_unit(data_dilation_strides);
+}
+
+/// \brief Returns the number of multiplications of the Winograd kernel
+inline size_t winograd_multiply_count(const Shape& arg1_shape,
+                                      const Shape& out_shape) {
+  const size_t tiles = out_shape[0] * ((out_shape[2] + 1) / 2) *
+                       ((out_shape[3] + 1) / 2);
+  return tiles * 16 * arg1_shape[0] * arg1_shape[1];
+}
+
+/// \brief Returns the transformed filter G g G^T of each output and input
+/// channel of the filter of shape (C_out, C_in, 3, 3), with 16 values per
+/// pair of channels, at the encoding scale of the filter
+inline std::vector<HEPlaintext> winograd_filter_transform(
+    const std::vector<HEPlaintext>& arg1, const Shape& arg1_shape) {
+  const size_t channel_pairs = arg1_shape[0] * arg1_shape[1];
+  NGRAPH_CHECK(arg1.size() == channel_pairs * 9, "Winograd filter of ",
+               arg1.size(), " values does not match shape ", arg1_shape);
+  // G = [1, 0, 0; 1/2, 1/2, 1/2; 1/2, -1/2, 1/2; 0, 0, 1]
+  auto transform = [](const std::array<float, 3>& g) {
+    return std::array<float, 4>{g[0], (g[0] + g[1] + g[2]) / 2,
+                                (g[0] - g[1] + g[2]) / 2, g[2]};
+  };
+
+  std::vector<HEPlaintext> out(channel_pairs * 16);
+  for (size_t pair = 0; pair < channel_pairs; ++pair) {
+    auto weight = [&](size_t row, size_t col) {
+      const HEPlaintext& plaintext = arg1[pair * 9 + row * 3 + col];
+      NGRAPH_CHECK(plaintext.is_single_value(),
+                   "Winograd filter values must be single values");
+      return plaintext.values()[0];
+    };
+    // G g, one column of the filter at a time
+    std::array<std::array<float, 4>, 3> columns;
+    for (size_t col = 0; col < 3; ++col) {
+      columns[col] =
+          transform({weight(0, col), weight(1, col), weight(2, col)});
+    }
+    // (G g) G^T
+    for (size_t row = 0; row < 4; ++row) {
+      std::array<float, 4> values =
+          transform({columns[0][row], columns[1][row], columns[2][row]});
+      for (size_t col = 0; col < 4; ++col) {
+        HEPlaintext& plaintext = out[pair * 16 + row * 4 + col];
+        plaintext = HEPlaintext(values[col]);
+        plaintext.encoding_scale() = arg1[pair * 9].encoding_scale();
+      }
+    }
+  }
+  return out;
+}
+
+/// \brief Returns arg0 + arg1, or arg0 - arg1 if subtract, as a new
+/// ciphertext, where nullptr stands for zero
+inline std::shared_ptr<SealCiphertextWrapper> winograd_combine(
+    const std::shared_ptr<SealCiphertextWrapper>& arg0,
+    const std::shared_ptr<SealCiphertextWrapper>& arg1, bool subtract,
+    const element::Type& element_type, const HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool) {
+  if (arg0 == nullptr && arg1 == nullptr) {
+    return nullptr;
+  }
+  if (arg1 == nullptr) {
+    return std::make_shared<SealCiphertextWrapper>(*arg0);
+  }
+  if (arg0 == nullptr && !subtract) {
+    return std::make_shared<SealCiphertextWrapper>(*arg1);
+  }
+  auto out = he_seal_backend.create_empty_ciphertext(pool);
+  if (arg0 == nullptr) {
+    scalar_negate_seal(*arg1, out, element_type, he_seal_backend);
+  } else if (subtract) {
+    scalar_subtract_seal(*arg0, *arg1, out, element_type, he_seal_backend);
+  } else {
+    scalar_add_seal(*arg0, *arg1, out, element_type, he_seal_backend, pool);
+  }
+  return out;
+}
+
+/// \brief Computes the convolution of the ciphertexts arg0 of shape
+/// (N, C_in, H, W) with the filter transformed by winograd_filter_transform,
+/// with the Winograd algorithm F(2x2, 3x3). Each 2x2 output tile is computed
+/// from a 4x4 input tile d as
+///   Y = A^T [sum_c (G g_c G^T) . (B^T d_c B)] A
+/// where . is the elementwise product. B^T and A^T only add and subtract
+/// ciphertexts, so a tile takes 16 instead of 36 multiplications per input
+/// and output channel
+inline void winograd_convolution_seal(
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& arg0,
+    const std::vector<HEPlaintext>& transformed_filter,
+    std::vector<std::shared_ptr<SealCiphertextWrapper>>& out,
+    const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
+    const CoordinateDiff& padding_below, const element::Type& element_type,
+    const HESealBackend& he_seal_backend, bool verbose = true,
+    const KernelEpilogue& epilogue = KernelEpilogue()) {
+  using CipherPtr = std::shared_ptr<SealCiphertextWrapper>;
+  using Tile = std::array<CipherPtr, 16>;
+  const size_t in_channels = arg0_shape[1];
+  const size_t out_channels = arg1_shape[0];
+  const size_t tiles_y = (out_shape[2] + 1) / 2;
+  const size_t tiles_x = (out_shape[3] + 1) / 2;
+  const size_t tile_count = out_shape[0] * tiles_y * tiles_x;
+  if (verbose) {
+    NGRAPH_INFO << "Winograd convolution of " << tile_count << " tiles";
+  }
+
+  // Applies B^T or A^T to a column of 4 values
+  auto transform_input = [&](const CipherPtr* d, size_t stride,
+                             const seal::MemoryPoolHandle& pool) {
+    // B^T = [1, 0, -1, 0; 0, 1, 1, 0; 0, -1, 1, 0; 0, 1, 0, -1]
+    return std::array<CipherPtr, 4>{
+        winograd_combine(d[0], d[2 * stride], true, element_type,
+                         he_seal_backend, pool),
+        winograd_combine(d[stride], d[2 * stride], false, element_type,
+                         he_seal_backend, pool),
+        winograd_combine(d[2 * stride], d[stride], true, element_type,
+                         he_seal_backend, pool),
+        winograd_combine(d[stride], d[3 * stride], true, element_type,
+                         he_seal_backend, pool)};
+  };
+  auto transform_output = [&](const CipherPtr* m, size_t stride,
+                              const seal::MemoryPoolHandle& pool) {
+    // A^T = [1, 1, 1, 0; 0, 1, -1, -1]
+    CipherPtr sum = winograd_combine(m[0], m[stride], false, element_type,
+                                     he_seal_backend, pool);
+    CipherPtr diff = winograd_combine(m[stride], m[2 * stride], true,
+                                      element_type, he_seal_backend, pool);
+    return std::array<CipherPtr, 2>{
+        winograd_combine(sum, m[2 * stride], false, element_type,
+                         he_seal_backend, pool),
+        winograd_combine(diff, m[3 * stride], true, element_type,
+                         he_seal_backend, pool)};
+  };
+
+#pragma omp parallel for
+  for (size_t tile_idx = 0; tile_idx < tile_count; ++tile_idx) {
+    // Init thread-local memory pool for each thread
+    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+
+    const size_t batch = tile_idx / (tiles_y * tiles_x);
+    const size_t y0 = 2 * ((tile_idx / tiles_x) % tiles_y);
+    const size_t x0 = 2 * (tile_idx % tiles_x);
+
+    // B^T d B of each input channel, where nullptr stands for zero padding
+    std::vector<Tile> inputs(in_channels);
+    for (size_t in_channel = 0; in_channel < in_channels; ++in_channel) {
+      Tile d;
+      for (size_t row = 0; row < 4; ++row) {
+        for (size_t col = 0; col < 4; ++col) {
+          const std::ptrdiff_t y = std::ptrdiff_t(y0 + row) - padding_below[0];
+          const std::ptrdiff_t x = std::ptrdiff_t(x0 + col) - padding_below[1];
+          if (y >= 0 && x >= 0 && y < std::ptrdiff_t(arg0_shape[2]) &&
+              x < std::ptrdiff_t(arg0_shape[3])) {
+            d[row * 4 + col] =
+                arg0[((batch * in_channels + in_channel) * arg0_shape[2] + y) *
+                         arg0_shape[3] +
+                     x];
+          }
+        }
+      }
+      Tile columns;
+      for (size_t col = 0; col < 4; ++col) {
+        std::array<CipherPtr, 4> column = transform_input(&d[col], 4, pool);
+        for (size_t row = 0; row < 4; ++row) {
+          columns[row * 4 + col] = column[row];
+        }
+      }
+      for (size_t row = 0; row < 4; ++row) {
+        std::array<CipherPtr, 4> values =
+            transform_input(&columns[row * 4], 1, pool);
+        std::copy(values.begin(), values.end(),
+                  inputs[in_channel].begin() + row * 4);
+      }
+    }
+
+    for (size_t out_channel = 0; out_channel < out_channels; ++out_channel) {
+      // Elementwise products, summed over the input channels
+      Tile m;
+      for (size_t in_channel = 0; in_channel < in_channels; ++in_channel) {
+        const size_t pair = out_channel * in_channels + in_channel;
+        for (size_t i = 0; i < 16; ++i) {
+          if (inputs[in_channel][i] == nullptr) {
+            continue;
+          }
+          auto prod = he_seal_backend.create_empty_ciphertext(pool);
+          scalar_multiply_seal(*inputs[in_channel][i],
+                               transformed_filter[pair * 16 + i], prod,
+                               element_type, he_seal_backend, pool);
+          if (m[i] == nullptr) {
+            m[i] = prod;
+          } else {
+            scalar_add_seal(*m[i], *prod, m[i], element_type, he_seal_backend,
+                            pool);
+          }
+        }
+      }
+
+      // A^T m A
+      std::array<std::array<CipherPtr, 2>, 4> rows;
+      for (size_t col = 0; col < 4; ++col) {
+        rows[col] = transform_output(&m[col], 4, pool);
+      }
+      for (size_t row = 0; row < 2; ++row) {
+        std::array<CipherPtr, 4> s{rows[0][row], rows[1][row], rows[2][row],
+                                   rows[3][row]};
+        std::array<CipherPtr, 2> values = transform_output(s.data(), 1, pool);
+        for (size_t col = 0; col < 2; ++col) {
+          const size_t y = y0 + row;
+          const size_t x = x0 + col;
+          // Odd output sizes leave half tiles at the border
+          if (y >= out_shape[2] || x >= out_shape[3]) {
+            continue;
+          }
+          const size_t out_index =
+              ((batch * out_channels + out_channel) * out_shape[2] + y) *
+                  out_shape[3] +
+              x;
+          CipherPtr value = values[col];
+          if (value == nullptr) {
+            value = std::make_shared<SealCiphertextWrapper>();
+            value->known_value() = true;
+            value->value() = 0;
+          }
+          out[out_index] = value;
+          apply_kernel_epilogue(out[out_index], out_index, epilogue,
+                                element_type, he_seal_backend, pool);
+        }
+      }
+    }
+  }
+}
+}  // namespace he
+}  // namespace ngraph
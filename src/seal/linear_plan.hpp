@@ -0,0 +1,111 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Index plan of a Convolution or Dot of ciphertexts with constant
+/// weights, computed at compile time. For each output, only the taps with
+/// nonzero weights are kept, grouped by weight value, so the kernel
+/// multiplies the pre-summed inputs of each group once:
+///   sum_i w_i x_i = sum_w w (sum_{i : w_i = w} x_i)
+/// Weights of +-1 are still multiplied, so all products have the same scale.
+class LinearPlan {
+ public:
+  /// \brief Inputs which share a weight
+  struct Group {
+    float weight;
+    std::vector<size_t> input_indices;
+  };
+
+  /// \brief Pairs of the indices of the two arguments multiplied for an output
+  using Taps = std::vector<std::pair<size_t, size_t>>;
+
+  /// \param taps Taps of each output
+  /// \param weights Constant weights
+  /// \param weight_arg Which index of a tap, 0 or 1, indexes the weights
+  /// \param encoding_scale Scale at which the weights are encoded, or 0 to
+  /// use the scale of the ciphertexts
+  LinearPlan(const std::vector<Taps>& taps, const std::vector<float>& weights,
+             size_t weight_arg, double encoding_scale = 0)
+      : LinearPlan(taps.size(),
+                   [&taps](size_t out_index) { return taps[out_index]; },
+                   weights, weight_arg, encoding_scale) {}
+
+  /// \param output_count Number of outputs
+  /// \param output_taps Returns the taps of an output, so the taps of all
+  /// outputs need not be stored at once
+  /// \param weights Constant weights
+  /// \param weight_arg Which index of a tap, 0 or 1, indexes the weights
+  /// \param encoding_scale Scale at which the weights are encoded, or 0 to
+  /// use the scale of the ciphertexts
+  LinearPlan(size_t output_count,
+             const std::function<Taps(size_t)>& output_taps,
+             const std::vector<float>& weights, size_t weight_arg,
+             double encoding_scale = 0)
+      : m_groups(output_count), m_encoding_scale(encoding_scale) {
+    NGRAPH_CHECK(weight_arg < 2, "Invalid weight argument ", weight_arg);
+    for (size_t out_index = 0; out_index < output_count; ++out_index) {
+      std::map<float, std::vector<size_t>> inputs_by_weight;
+      for (const std::pair<size_t, size_t>& tap : output_taps(out_index)) {
+        const size_t weight_index = weight_arg == 0 ? tap.first : tap.second;
+        const size_t input_index = weight_arg == 0 ? tap.second : tap.first;
+        const float weight = weights.at(weight_index);
+        m_tap_count++;
+        // Like scalar_multiply_seal, treat tiny weights as zero
+        if (std::abs(weight) >= 1e-5f) {
+          inputs_by_weight[weight].emplace_back(input_index);
+        }
+      }
+      for (auto& weight_inputs : inputs_by_weight) {
+        m_groups[out_index].push_back(
+            Group{weight_inputs.first, std::move(weight_inputs.second)});
+      }
+      m_multiply_count += m_groups[out_index].size();
+    }
+  }
+
+  size_t output_count() const { return m_groups.size(); }
+
+  const std::vector<Group>& groups(size_t out_index) const {
+    return m_groups[out_index];
+  }
+
+  double encoding_scale() const { return m_encoding_scale; }
+
+  /// \brief Returns the number of multiplications without the plan
+  size_t tap_count() const { return m_tap_count; }
+
+  /// \brief Returns the number of multiplications with the plan
+  size_t multiply_count() const { return m_multiply_count; }
+
+ private:
+  std::vector<std::vector<Group>> m_groups;
+  double m_encoding_scale;
+  size_t m_tap_count{0};
+  size_t m_multiply_count{0};
+};
+}  // namespace he
+}  // namespace ngraph
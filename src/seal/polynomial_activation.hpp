@@ -0,0 +1,200 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "ngraph/except.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Polynomial which replaces Relu and BoundedRelu, so activations are
+/// evaluated on the server without a client round trip. Specified by
+/// NGRAPH_HE_POLY_ACTIVATION as one of
+///   square: x^2, as in Cryptonets
+///   relu2, relu3, relu4: least-squares fit of relu of that degree on [-1, 1].
+///     The cubic fit has no cubic term, since relu(x) - x / 2 is even.
+///     A suffix :<bound> fits relu on [-bound, bound] instead, e.g. relu4:8
+///   c0,c1,...: the polynomial c0 + c1 x + c2 x^2 + ...
+class PolynomialActivation {
+ public:
+  PolynomialActivation() = default;
+
+  PolynomialActivation(std::vector<double> coefficients)
+      : m_coefficients(std::move(coefficients)) {
+    // Drop leading zero coefficients, which would only cost depth
+    while (!m_coefficients.empty() && m_coefficients.back() == 0) {
+      m_coefficients.pop_back();
+    }
+  }
+
+  static PolynomialActivation parse(const std::string& spec) {
+    std::string name = spec;
+    double bound = 1;
+    size_t colon = spec.find(':');
+    if (colon != std::string::npos) {
+      name = spec.substr(0, colon);
+      bound = parse_double(spec.substr(colon + 1));
+      NGRAPH_CHECK(bound > 0, "Invalid polynomial activation bound ", bound);
+    }
+
+    const bool relu = name.compare(0, 4, "relu") == 0;
+    NGRAPH_CHECK(relu || colon == std::string::npos,
+                 "Bound is only supported for relu polynomials");
+
+    std::vector<double> coefficients;
+    if (name == "square") {
+      coefficients = {0, 0, 1};
+    } else if (name == "relu2" || name == "relu3") {
+      coefficients = {3. / 32, 1. / 2, 15. / 32};
+    } else if (name == "relu4") {
+      coefficients = {15. / 256, 1. / 2, 105. / 128, 0, -105. / 256};
+    } else {
+      size_t begin = 0;
+      while (begin <= name.size()) {
+        size_t end = std::min(name.find(',', begin), name.size());
+        coefficients.emplace_back(
+            parse_double(name.substr(begin, end - begin)));
+        begin = end + 1;
+      }
+    }
+    if (relu) {
+      // relu(x) = bound * relu(x / bound)
+      for (size_t i = 0; i < coefficients.size(); ++i) {
+        coefficients[i] *= std::pow(bound, 1. - static_cast<double>(i));
+      }
+    }
+    PolynomialActivation activation(coefficients);
+    NGRAPH_CHECK(activation.degree() > 0,
+                 "Polynomial activation must not be constant");
+    return activation;
+  }
+
+  bool enabled() const { return !m_coefficients.empty(); }
+
+  const std::vector<double>& coefficients() const { return m_coefficients; }
+
+  size_t degree() const {
+    return m_coefficients.empty() ? 0 : m_coefficients.size() - 1;
+  }
+
+  /// \brief Returns the largest power of the Paterson-Stockmeyer baby steps,
+  /// which is the smallest power of two at least sqrt(degree + 1)
+  size_t baby_step() const {
+    size_t step = 1;
+    while (step * step < degree() + 1) {
+      step *= 2;
+    }
+    return step;
+  }
+
+  /// \brief Returns the multiplicative depth of the Paterson-Stockmeyer
+  /// evaluation, i.e. the number of rescalings it consumes
+  size_t depth() const { return block_depth(0, m_coefficients.size()); }
+
+  /// \brief Returns the depth of sum_{i in [begin, end)} c_i x^(i - begin),
+  /// split like the ciphertext evaluation. Constant blocks have depth 0
+  size_t block_depth(size_t begin, size_t end) const {
+    end = trimmed_end(begin, end);
+    if (end - begin <= baby_step() + 1) {
+      // Scalar multiples of the baby step powers
+      size_t depth = 0;
+      for (size_t i = begin + 1; i < end; ++i) {
+        if (m_coefficients[i] != 0) {
+          depth = std::max(depth, term_depth(i - begin, m_coefficients[i]));
+        }
+      }
+      return depth;
+    }
+    size_t giant_step = split_step(end - begin);
+    size_t low_depth = block_depth(begin, begin + giant_step);
+    size_t high_begin = begin + giant_step;
+    size_t high_depth = 0;
+    if (trimmed_end(high_begin, end) == high_begin + 1) {
+      // Scalar multiple of the giant step power
+      high_depth = term_depth(giant_step, m_coefficients[high_begin]);
+    } else {
+      high_depth =
+          std::max(block_depth(high_begin, end), power_depth(giant_step)) + 1;
+    }
+    return std::max(low_depth, high_depth);
+  }
+
+  /// \brief Returns the end of the coefficients [begin, end) without leading
+  /// zeros
+  size_t trimmed_end(size_t begin, size_t end) const {
+    while (end > begin + 1 && m_coefficients[end - 1] == 0) {
+      --end;
+    }
+    return end;
+  }
+
+  /// \brief Returns the depth of coefficient * x^power. Multiplying by +-1
+  /// needs no rescaling
+  static size_t term_depth(size_t power, double coefficient) {
+    return power_depth(power) + (std::abs(coefficient) == 1 ? 0 : 1);
+  }
+
+  /// \brief Returns the power at which a block of coefficient_count
+  /// coefficients is split into quotient and remainder: the largest
+  /// baby_step * 2^j below coefficient_count
+  size_t split_step(size_t coefficient_count) const {
+    size_t step = baby_step();
+    while (2 * step < coefficient_count) {
+      step *= 2;
+    }
+    return step;
+  }
+
+  /// \brief Returns the depth of x^power computed by repeated squaring
+  static size_t power_depth(size_t power) {
+    size_t depth = 0;
+    while ((size_t(1) << depth) < power) {
+      ++depth;
+    }
+    return depth;
+  }
+
+  template <typename T>
+  T evaluate(T value) const {
+    T result = 0;
+    for (auto it = m_coefficients.rbegin(); it != m_coefficients.rend(); ++it) {
+      result = result * value + static_cast<T>(*it);
+    }
+    return result;
+  }
+
+ private:
+  static double parse_double(const std::string& str) {
+    char* end = nullptr;
+    double value = std::strtod(str.c_str(), &end);
+    if (str.empty() || end != str.c_str() + str.size()) {
+      throw ngraph_error("Invalid polynomial activation coefficient " + str);
+    }
+    return value;
+  }
+
+  // Coefficients in increasing order of degree
+  std::vector<double> m_coefficients;
+};
+}  // namespace he
+}  // namespace ngraph
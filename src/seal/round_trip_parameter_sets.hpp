@@ -0,0 +1,63 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Encryption parameter sets of the ciphertexts of a client round trip.
+/// The client decrypts the ciphertexts of the request with the keys of
+/// parameter_set and encrypts its results under result_parameter_set, so the
+/// function segment after the round trip may use smaller parameters.
+/// Parameter set 0 holds the encryption_parameters sent at setup; other sets
+/// are announced in parameter_set messages.
+struct RoundTripParameterSets {
+  std::uint64_t parameter_set{0};
+  std::uint64_t result_parameter_set{0};
+
+  enum { serialized_size = 2 * sizeof(std::uint64_t) };
+
+  std::string save() const {
+    std::string data(serialized_size, '\0');
+    std::memcpy(&data[0], &parameter_set, sizeof(parameter_set));
+    std::memcpy(&data[sizeof(parameter_set)], &result_parameter_set,
+                sizeof(result_parameter_set));
+    return data;
+  }
+
+  /// \brief Loads parameter sets saved at data[offset]. An empty data, as sent
+  /// by servers using a single parameter set, selects parameter set 0
+  void load(const std::string& data, size_t offset = 0) {
+    if (data.empty()) {
+      *this = RoundTripParameterSets();
+      return;
+    }
+    NGRAPH_CHECK(data.size() >= offset + serialized_size,
+                 "Error loading round trip parameter sets of size ",
+                 data.size());
+    std::memcpy(&parameter_set, &data[offset], sizeof(parameter_set));
+    std::memcpy(&result_parameter_set, &data[offset + sizeof(parameter_set)],
+                sizeof(result_parameter_set));
+  }
+};
+}  // namespace he
+}  // namespace ngraph
@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <istream>
 #include <memory>
+#include <streambuf>
 
 #include "seal/seal.h"
 
@@ -75,5 +77,24 @@ inline size_t ciphertext_size(const seal::Ciphertext& cipher) {
   return expected_size;
 }
 
+// Read-only stream buffer over existing bytes
+class ConstBufferStreambuf : public std::streambuf {
+ public:
+  ConstBufferStreambuf(const char* data, size_t size) {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+/// \brief Loads cipher from the size bytes at data, as saved by
+/// seal::Ciphertext::save, without first copying them into a stream
+inline void load_ciphertext(seal::Ciphertext& cipher,
+                            std::shared_ptr<seal::SEALContext> context,
+                            const char* data, size_t size) {
+  ConstBufferStreambuf buffer(data, size);
+  std::istream stream(&buffer);
+  cipher.load(context, stream);
+}
+
 }  // namespace he
 }  // namespace ngraph
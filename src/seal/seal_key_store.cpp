@@ -0,0 +1,215 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include "ngraph/check.hpp"
+#include "ngraph/log.hpp"
+#include "seal/seal_key_store.hpp"
+
+namespace {
+const char key_set_magic[8] = {'H', 'E', 'S', 'E', 'A', 'L', 'K', 'S'};
+const std::uint32_t key_set_version = 1;
+const size_t session_token_length = 32;
+
+enum KeySetFlags : std::uint8_t {
+  has_secret_key = 1,
+  has_public_key = 2,
+  has_relin_keys = 4,
+  has_galois_keys = 8
+};
+}  // namespace
+
+void ngraph::he::SealKeySet::save(std::ostream& stream) const {
+  std::uint32_t version = key_set_version;
+  std::uint64_t token_size = session_token.size();
+  std::uint8_t flags = (secret_key ? has_secret_key : 0) |
+                       (public_key ? has_public_key : 0) |
+                       (relin_keys ? has_relin_keys : 0) |
+                       (galois_keys ? has_galois_keys : 0);
+
+  stream.write(key_set_magic, sizeof(key_set_magic));
+  stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  stream.write(reinterpret_cast<const char*>(&token_size), sizeof(token_size));
+  stream.write(session_token.data(), token_size);
+  stream.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+  if (secret_key) {
+    secret_key->save(stream);
+  }
+  if (public_key) {
+    public_key->save(stream);
+  }
+  if (relin_keys) {
+    relin_keys->save(stream);
+  }
+  if (galois_keys) {
+    galois_keys->save(stream);
+  }
+  NGRAPH_CHECK(stream.good(), "Error saving key set");
+}
+
+void ngraph::he::SealKeySet::load(std::shared_ptr<seal::SEALContext> context,
+                                  std::istream& stream) {
+  char magic[sizeof(key_set_magic)];
+  std::uint32_t version;
+  std::uint64_t token_size;
+  stream.read(magic, sizeof(magic));
+  stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+  stream.read(reinterpret_cast<char*>(&token_size), sizeof(token_size));
+  NGRAPH_CHECK(stream.good(), "Error loading key set");
+  NGRAPH_CHECK(std::equal(magic, magic + sizeof(magic), key_set_magic),
+               "Not a key set");
+  NGRAPH_CHECK(version == key_set_version, "Unsupported key set version ",
+               version);
+  NGRAPH_CHECK(token_size <= session_token_length, "Invalid session token");
+
+  session_token.resize(token_size);
+  stream.read(&session_token[0], token_size);
+  std::uint8_t flags;
+  stream.read(reinterpret_cast<char*>(&flags), sizeof(flags));
+  NGRAPH_CHECK(stream.good(), "Error loading key set");
+
+  // SEAL checks the keys are valid for context
+  secret_key = nullptr;
+  public_key = nullptr;
+  relin_keys = nullptr;
+  galois_keys = nullptr;
+  if (flags & has_secret_key) {
+    secret_key = std::make_shared<seal::SecretKey>();
+    secret_key->load(context, stream);
+  }
+  if (flags & has_public_key) {
+    public_key = std::make_shared<seal::PublicKey>();
+    public_key->load(context, stream);
+  }
+  if (flags & has_relin_keys) {
+    relin_keys = std::make_shared<seal::RelinKeys>();
+    relin_keys->load(context, stream);
+  }
+  if (flags & has_galois_keys) {
+    galois_keys = std::make_shared<seal::GaloisKeys>();
+    galois_keys->load(context, stream);
+  }
+}
+
+std::string ngraph::he::parms_id_to_string(const seal::SEALContext& context) {
+  std::stringstream ss;
+  for (const std::uint64_t word : context.key_parms_id()) {
+    ss << std::hex << std::setw(16) << std::setfill('0') << word;
+  }
+  return ss.str();
+}
+
+std::string ngraph::he::generate_session_token() {
+  std::random_device rd;
+  std::stringstream ss;
+  for (size_t i = 0; i < session_token_length / 8; ++i) {
+    ss << std::hex << std::setw(8) << std::setfill('0')
+       << static_cast<std::uint32_t>(rd());
+  }
+  return ss.str();
+}
+
+bool ngraph::he::is_valid_session_token(const std::string& token) {
+  return token.size() == session_token_length &&
+         token.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
+
+void ngraph::he::save_key_set(const std::string& path, const SealKeySet& keys) {
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    NGRAPH_CHECK(file.is_open(), "Cannot open key store file ", tmp_path);
+    // Restrict access before any key is written
+    NGRAPH_CHECK(::chmod(tmp_path.c_str(), S_IRUSR | S_IWUSR) == 0,
+                 "Cannot restrict access to key store file ", tmp_path);
+    keys.save(file);
+  }
+  NGRAPH_CHECK(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+               "Cannot write key store file ", path);
+}
+
+bool ngraph::he::load_key_set(const std::string& path,
+                              std::shared_ptr<seal::SEALContext> context,
+                              SealKeySet& keys) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  try {
+    keys.load(context, file);
+  } catch (const std::exception& e) {
+    NGRAPH_INFO << "Ignoring key store file " << path << ": " << e.what();
+    return false;
+  }
+  return true;
+}
+
+std::shared_ptr<ngraph::he::SealKeySet> ngraph::he::ServerKeyCache::find(
+    const std::string& token, std::shared_ptr<seal::SEALContext> context) {
+  if (!is_valid_session_token(token)) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto keys_it = m_keys.find(token);
+  if (keys_it != m_keys.end()) {
+    const auto& keys = keys_it->second;
+    if (keys->public_key->parms_id() == context->key_parms_id()) {
+      return keys;
+    }
+    return nullptr;
+  }
+  if (m_directory.empty()) {
+    return nullptr;
+  }
+  auto keys = std::make_shared<SealKeySet>();
+  if (!load_key_set(path(token, *context), context, *keys) ||
+      keys->session_token != token || !keys->public_key) {
+    return nullptr;
+  }
+  m_keys[token] = keys;
+  return keys;
+}
+
+void ngraph::he::ServerKeyCache::insert(
+    const SealKeySet& keys, std::shared_ptr<seal::SEALContext> context) {
+  NGRAPH_CHECK(is_valid_session_token(keys.session_token),
+               "Invalid session token");
+  NGRAPH_CHECK(keys.public_key != nullptr,
+               "Cannot cache keys without public key");
+  auto cached_keys = std::make_shared<SealKeySet>(keys);
+  cached_keys->secret_key = nullptr;
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_keys[keys.session_token] = cached_keys;
+  if (!m_directory.empty()) {
+    save_key_set(path(keys.session_token, *context), *cached_keys);
+  }
+}
+
+std::string ngraph::he::ServerKeyCache::path(
+    const std::string& token, const seal::SEALContext& context) const {
+  return m_directory + "/" + parms_id_to_string(context) + "_" + token +
+         ".keys";
+}
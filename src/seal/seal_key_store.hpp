@@ -0,0 +1,92 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "seal/seal.h"
+
+namespace ngraph {
+namespace he {
+/// \brief Keys of one client session. The client stores all of them; the
+/// server stores all but the secret key, under the session token.
+struct SealKeySet {
+  std::string session_token;
+  std::shared_ptr<seal::SecretKey> secret_key;
+  std::shared_ptr<seal::PublicKey> public_key;
+  std::shared_ptr<seal::RelinKeys> relin_keys;
+  std::shared_ptr<seal::GaloisKeys> galois_keys;
+
+  void save(std::ostream& stream) const;
+
+  /// \brief Loads a key set saved by save(). Throws if the stream is corrupt
+  /// or the keys are not valid for context
+  void load(std::shared_ptr<seal::SEALContext> context, std::istream& stream);
+};
+
+/// \brief Returns the hash of the encryption parameters of context as a hex
+/// string, used to name key store files
+std::string parms_id_to_string(const seal::SEALContext& context);
+
+/// \brief Returns a new random session token
+std::string generate_session_token();
+
+/// \brief Returns whether token was generated by generate_session_token(), so
+/// it can be used in a file name
+bool is_valid_session_token(const std::string& token);
+
+/// \brief Saves keys to path, readable only by the current user. Writes to a
+/// temporary file first, so an interrupted save keeps the previous keys
+void save_key_set(const std::string& path, const SealKeySet& keys);
+
+/// \brief Loads keys from path. Returns false if path does not exist or does
+/// not hold valid keys for context
+bool load_key_set(const std::string& path,
+                  std::shared_ptr<seal::SEALContext> context,
+                  SealKeySet& keys);
+
+/// \brief Server-side cache of client public and evaluation keys by session
+/// token, so a reconnecting client can skip uploading its keys. If directory
+/// is non-empty, keys are also persisted there and survive server restarts
+class ServerKeyCache {
+ public:
+  ServerKeyCache(const std::string& directory = "") : m_directory(directory) {}
+
+  /// \brief Returns the keys cached for token, or nullptr
+  std::shared_ptr<SealKeySet> find(const std::string& token,
+                                   std::shared_ptr<seal::SEALContext> context);
+
+  /// \brief Caches keys under keys.session_token. The secret key is never
+  /// cached
+  void insert(const SealKeySet& keys,
+              std::shared_ptr<seal::SEALContext> context);
+
+ private:
+  std::string path(const std::string& token,
+                   const seal::SEALContext& context) const;
+
+  std::string m_directory;
+  std::mutex m_mutex;
+  std::unordered_map<std::string, std::shared_ptr<SealKeySet>> m_keys;
+};
+}  // namespace he
+}  // namespace ngraph
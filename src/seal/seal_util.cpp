@@ -17,6 +17,7 @@
 // Licensed under the MIT license.
 
 #include <chrono>
+#include <cmath>
 #include <limits>
 #include <utility>
 
@@ -28,41 +29,78 @@
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/util/polyarithsmallmod.h"
 
-// Matches the modulus chain for the two elements in-place
-// The elements are modified if necessary
+namespace {
+// Multiplies the scales of arg0 and arg1 by the smallest integers a and b
+// with a * scale0 = b * scale1, up to rounding of the moduli. The smaller
+// scale may be lifted by a large factor a, e.g. a power of two between
+// products with different planned plaintext scales
+void lift_to_common_scale(ngraph::he::SealCiphertextWrapper& arg0,
+                          ngraph::he::SealCiphertextWrapper& arg1,
+                          const ngraph::he::HESealBackend& he_seal_backend) {
+  constexpr std::uint64_t max_factor = 64;
+  constexpr double max_lift = 1UL << 30;
+  const bool lift0 = arg0.scale() < arg1.scale();
+  ngraph::he::SealCiphertextWrapper& lower = lift0 ? arg0 : arg1;
+  ngraph::he::SealCiphertextWrapper& higher = lift0 ? arg1 : arg0;
+  const double ratio = higher.scale() / lower.scale();
+  for (std::uint64_t b = 1; b <= max_factor; ++b) {
+    const double a = std::round(ratio * b);
+    if (a > max_lift ||
+        !ngraph::he::within_rescale_tolerance(a, ratio * b, 1.01)) {
+      continue;
+    }
+    if (a > 1) {
+      ngraph::he::multiply_scale_inplace(
+          lower.ciphertext(), static_cast<std::uint64_t>(a), he_seal_backend);
+    }
+    if (b > 1) {
+      ngraph::he::multiply_scale_inplace(higher.ciphertext(), b,
+                                         he_seal_backend);
+    }
+    return;
+  }
+  NGRAPH_CHECK(false, "Scale ", arg0.scale(), " does not match scale ",
+               arg1.scale());
+}
+}  // namespace
+
 void ngraph::he::match_modulus_and_scale_inplace(
     SealCiphertextWrapper& arg0, SealCiphertextWrapper& arg1,
     const HESealBackend& he_seal_backend, seal::MemoryPoolHandle pool) {
   size_t chain_ind0 = ngraph::he::get_chain_index(arg0, he_seal_backend);
   size_t chain_ind1 = ngraph::he::get_chain_index(arg1, he_seal_backend);
 
-  if (chain_ind0 == chain_ind1) {
-    return;
-  }
-  bool rescale = !ngraph::he::within_rescale_tolerance(arg0, arg1);
-
-  if (chain_ind0 < chain_ind1) {
-    auto arg0_parms_id = arg0.ciphertext().parms_id();
-    if (rescale) {
-      he_seal_backend.get_evaluator()->rescale_to_inplace(arg1.ciphertext(),
-                                                          arg0_parms_id);
-    } else {
-      he_seal_backend.get_evaluator()->mod_switch_to_inplace(arg1.ciphertext(),
-                                                             arg0_parms_id);
+  if (chain_ind0 != chain_ind1) {
+    SealCiphertextWrapper& higher = chain_ind0 > chain_ind1 ? arg0 : arg1;
+    const SealCiphertextWrapper& lower = chain_ind0 > chain_ind1 ? arg1 : arg0;
+    const auto lower_parms_id = lower.ciphertext().parms_id();
+
+    // Rescaling divides the scale by each dropped modulus
+    double rescaled_scale = higher.scale();
+    auto context_data = he_seal_backend.get_context()->get_context_data(
+        higher.ciphertext().parms_id());
+    while (context_data->parms_id() != lower_parms_id) {
+      rescaled_scale /= context_data->parms().coeff_modulus().back().value();
+      context_data = context_data->next_context_data();
     }
-    chain_ind1 = ngraph::he::get_chain_index(arg1, he_seal_backend);
-  } else {  // chain_ind0 > chain_ind1
-    auto arg1_parms_id = arg1.ciphertext().parms_id();
+    bool rescale =
+        !ngraph::he::within_rescale_tolerance(higher, lower) &&
+        ngraph::he::within_rescale_tolerance(rescaled_scale, lower.scale());
+
     if (rescale) {
-      he_seal_backend.get_evaluator()->rescale_to_inplace(arg0.ciphertext(),
-                                                          arg1_parms_id);
+      he_seal_backend.get_evaluator()->rescale_to_inplace(higher.ciphertext(),
+                                                          lower_parms_id);
     } else {
-      he_seal_backend.get_evaluator()->mod_switch_to_inplace(arg0.ciphertext(),
-                                                             arg1_parms_id);
+      he_seal_backend.get_evaluator()->mod_switch_to_inplace(
+          higher.ciphertext(), lower_parms_id);
     }
     chain_ind0 = ngraph::he::get_chain_index(arg0, he_seal_backend);
+    chain_ind1 = ngraph::he::get_chain_index(arg1, he_seal_backend);
   }
   NGRAPH_CHECK(chain_ind0 == chain_ind1);
+  if (!ngraph::he::within_rescale_tolerance(arg0, arg1)) {
+    lift_to_common_scale(arg0, arg1, he_seal_backend);
+  }
   ngraph::he::match_scale(arg0, arg1, he_seal_backend);
 }
 
@@ -278,8 +316,44 @@ void ngraph::he::add_plain_inplace(seal::Ciphertext& encrypted, double value,
 #endif
 }
 
+namespace {
+// Multiplies each RNS component j of encrypted by scalar_vals[j]
+void multiply_scalar_coeffmod_inplace(
+    seal::Ciphertext& encrypted, const std::vector<std::uint64_t>& scalar_vals,
+    const ngraph::he::HESealBackend& he_seal_backend) {
+  auto& context_data =
+      *he_seal_backend.get_context()->get_context_data(encrypted.parms_id());
+  auto& coeff_modulus = context_data.parms().coeff_modulus();
+  size_t coeff_count = context_data.parms().poly_modulus_degree();
+  size_t coeff_mod_count = coeff_modulus.size();
+  auto& barrett64_ratio_map = he_seal_backend.barrett64_ratio_map();
+
+  for (size_t i = 0; i < encrypted.size(); i++) {
+    for (size_t j = 0; j < coeff_mod_count; j++) {
+      // Multiply by scalar instead of doing dyadic product
+      if (coeff_modulus[j].value() < (1UL << 31)) {
+        const std::uint64_t modulus_value = coeff_modulus[j].value();
+        auto iter = barrett64_ratio_map.find(modulus_value);
+        NGRAPH_CHECK(iter != barrett64_ratio_map.end(), "Modulus value ",
+                     modulus_value, "not in Barrett64 ratio map");
+        const std::uint64_t barrett_ratio = iter->second;
+        ngraph::he::multiply_poly_scalar_coeffmod64(
+            encrypted.data(i) + (j * coeff_count), coeff_count,
+            scalar_vals[j], modulus_value, barrett_ratio,
+            encrypted.data(i) + (j * coeff_count));
+      } else {
+        seal::util::multiply_poly_scalar_coeffmod(
+            encrypted.data(i) + (j * coeff_count), coeff_count,
+            scalar_vals[j], coeff_modulus[j],
+            encrypted.data(i) + (j * coeff_count));
+      }
+    }
+  }
+}
+}  // namespace
+
 void ngraph::he::multiply_plain_inplace(seal::Ciphertext& encrypted,
-                                        double value,
+                                        double value, double scale,
                                         const HESealBackend& he_seal_backend,
                                         seal::MemoryPoolHandle pool) {
   // Verify parameters.
@@ -312,12 +386,9 @@ void ngraph::he::multiply_plain_inplace(seal::Ciphertext& encrypted,
   }
 
   std::vector<std::uint64_t> plaintext_vals(coeff_mod_count, 0);
-  // TODO: explore using different scales! Smaller scales might reduce # of
-  // rescalings
-  double scale = encrypted.scale();
   ngraph::he::encode(value, scale, encrypted.parms_id(), plaintext_vals,
                      he_seal_backend);
-  double new_scale = scale * scale;
+  double new_scale = encrypted.scale() * scale;
   // Check that scale is positive and not too large
   if (new_scale <= 0 || (static_cast<int>(log2(new_scale)) >=
                          context_data.total_coeff_modulus_bit_count())) {
@@ -328,30 +399,44 @@ void ngraph::he::multiply_plain_inplace(seal::Ciphertext& encrypted,
     throw ngraph_error("scale out of bounds");
   }
 
-  auto& barrett64_ratio_map = he_seal_backend.barrett64_ratio_map();
+  multiply_scalar_coeffmod_inplace(encrypted, plaintext_vals, he_seal_backend);
+  // Set the scale
+  encrypted.scale() = new_scale;
+}
 
-  for (size_t i = 0; i < encrypted_ntt_size; i++) {
-    for (size_t j = 0; j < coeff_mod_count; j++) {
-      // Multiply by scalar instead of doing dyadic product
-      if (coeff_modulus[j].value() < (1UL << 31)) {
-        const std::uint64_t modulus_value = coeff_modulus[j].value();
-        auto iter = barrett64_ratio_map.find(modulus_value);
-        NGRAPH_CHECK(iter != barrett64_ratio_map.end(), "Modulus value ",
-                     modulus_value, "not in Barrett64 ratio map");
-        const std::uint64_t barrett_ratio = iter->second;
-        ngraph::he::multiply_poly_scalar_coeffmod64(
-            encrypted.data(i) + (j * coeff_count), coeff_count,
-            plaintext_vals[j], modulus_value, barrett_ratio,
-            encrypted.data(i) + (j * coeff_count));
-      } else {
-        seal::util::multiply_poly_scalar_coeffmod(
-            encrypted.data(i) + (j * coeff_count), coeff_count,
-            plaintext_vals[j], coeff_modulus[j],
-            encrypted.data(i) + (j * coeff_count));
-      }
-    }
+void ngraph::he::multiply_scale_inplace(seal::Ciphertext& encrypted,
+                                        std::uint64_t factor,
+                                        const HESealBackend& he_seal_backend) {
+  auto context = he_seal_backend.get_context();
+  if (!seal::is_metadata_valid_for(encrypted, context)) {
+    throw ngraph_error("encrypted is not valid for encryption parameters");
   }
-  // Set the scale
+  auto& context_data = *context->get_context_data(encrypted.parms_id());
+  const double new_scale = encrypted.scale() * factor;
+  NGRAPH_CHECK(static_cast<int>(log2(new_scale)) <
+                   context_data.total_coeff_modulus_bit_count(),
+               "Scale ", new_scale, " out of bounds");
+
+  // The integer factor is the same in every RNS component and NTT slot
+  const auto& coeff_modulus = context_data.parms().coeff_modulus();
+  std::vector<std::uint64_t> factor_vals(coeff_modulus.size());
+  for (size_t j = 0; j < coeff_modulus.size(); j++) {
+    factor_vals[j] = factor % coeff_modulus[j].value();
+  }
+  multiply_scalar_coeffmod_inplace(encrypted, factor_vals, he_seal_backend);
+  encrypted.scale() = new_scale;
+}
+
+void ngraph::he::divide_scale_inplace(seal::Ciphertext& encrypted,
+                                      double divisor,
+                                      const HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(divisor > 0, "Scale divisor ", divisor, " is not positive");
+  auto context = he_seal_backend.get_context();
+  auto& context_data = *context->get_context_data(encrypted.parms_id());
+  const double new_scale = encrypted.scale() * divisor;
+  NGRAPH_CHECK(static_cast<int>(log2(new_scale)) <
+                   context_data.total_coeff_modulus_bit_count(),
+               "Scale ", new_scale, " out of bounds");
   encrypted.scale() = new_scale;
 }
 
@@ -61,17 +61,19 @@ size_t match_to_smallest_chain_index(
     std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphers,
     const HESealBackend& he_seal_backend);
 
-template <typename S, typename T>
-inline bool within_rescale_tolerance(const S& arg0, const T& arg1,
+inline bool within_rescale_tolerance(double scale0, double scale1,
                                      double factor = 1.05) {
-  const auto scale0 = arg0.scale();
-  const auto scale1 = arg1.scale();
-
   bool within_tolerance =
       (scale0 / scale1 <= factor && scale1 / scale0 <= factor);
   return within_tolerance;
 }
 
+template <typename S, typename T>
+inline bool within_rescale_tolerance(const S& arg0, const T& arg1,
+                                     double factor = 1.05) {
+  return within_rescale_tolerance(arg0.scale(), arg1.scale(), factor);
+}
+
 template <typename S, typename T>
 inline void match_scale(S& arg0, T& arg1,
                         const HESealBackend& he_seal_backend) {
@@ -82,6 +84,59 @@ inline void match_scale(S& arg0, T& arg1,
   arg0.scale() = arg1.scale();
 }
 
+/// \brief Returns the scale at which to encode a plaintext multiplying
+/// encrypted. This is the scale of encrypted, unless a scale division raised it
+/// above the backend scale. Then the backend scale is used, so the product
+/// rescales back to the scale of encrypted instead of squaring the excess
+inline double plaintext_multiply_scale(const seal::Ciphertext& encrypted,
+                                       const HESealBackend& he_seal_backend,
+                                       double factor = 1.05) {
+  const double scale = encrypted.scale();
+  const double backend_scale = he_seal_backend.get_scale();
+  return scale > backend_scale * factor ? backend_scale : scale;
+}
+
+/// \brief Returns the scale at which to encode plaintext multiplying
+/// encrypted: its planned encoding scale if any, see HEScalePlanning
+inline double plaintext_multiply_scale(const seal::Ciphertext& encrypted,
+                                       const HEPlaintext& plaintext,
+                                       const HESealBackend& he_seal_backend) {
+  if (plaintext.encoding_scale() > 0) {
+    return plaintext.encoding_scale();
+  }
+  return plaintext_multiply_scale(encrypted, he_seal_backend);
+}
+
+/// \brief Multiplies encrypted and its scale by the integer factor, so it
+/// represents the same values at a larger scale. Unlike a plaintext multiply,
+/// this consumes no level
+void multiply_scale_inplace(seal::Ciphertext& encrypted, std::uint64_t factor,
+                            const HESealBackend& he_seal_backend);
+
+/// \brief Divides the values represented by encrypted by divisor, by
+/// multiplying its scale. Unlike a plaintext multiply, this consumes no level
+/// and leaves the ciphertext data untouched
+void divide_scale_inplace(seal::Ciphertext& encrypted, double divisor,
+                          const HESealBackend& he_seal_backend);
+
+/// \brief Rescales cipher to the next chain index, as the epilogue of a
+/// kernel whose op HERescalePlacement rescales. Known values are left as they
+/// are, as are ciphertexts which would reach chain index 0
+inline void rescale_output_inplace(
+    SealCiphertextWrapper& cipher, const HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
+  if (cipher.known_value() || get_chain_index(cipher, he_seal_backend) <= 1) {
+    return;
+  }
+  he_seal_backend.get_evaluator()->rescale_to_next_inplace(cipher.ciphertext(),
+                                                           pool);
+}
+
+/// \brief Matches the modulus and the scale of arg0 and arg1 in-place.
+/// Ciphertexts at a higher chain index are rescaled if that brings the
+/// scales within tolerance, and mod-switched otherwise. Scales which still
+/// differ by a small rational factor, e.g. after a scale division, are lifted
+/// to their least common multiple by multiply_scale_inplace
 void match_modulus_and_scale_inplace(
     SealCiphertextWrapper& arg0, SealCiphertextWrapper& arg1,
     const HESealBackend& he_seal_backend,
@@ -148,18 +203,29 @@ inline void add_poly_scalar_coeffmod(const std::uint64_t* poly,
   }
 }
 
+/// \brief Multiplies encrypted by value encoded at scale
 void multiply_plain_inplace(
-    seal::Ciphertext& encrypted, double value,
+    seal::Ciphertext& encrypted, double value, double scale,
     const HESealBackend& he_seal_backend,
     seal::MemoryPoolHandle pool = seal::MemoryManager::GetPool());
 
+inline void multiply_plain_inplace(
+    seal::Ciphertext& encrypted, double value,
+    const HESealBackend& he_seal_backend,
+    seal::MemoryPoolHandle pool = seal::MemoryManager::GetPool()) {
+  ngraph::he::multiply_plain_inplace(
+      encrypted, value,
+      ngraph::he::plaintext_multiply_scale(encrypted, he_seal_backend),
+      he_seal_backend, std::move(pool));
+}
+
 inline void multiply_plain(
-    const seal::Ciphertext& encrypted, double value,
+    const seal::Ciphertext& encrypted, double value, double scale,
     seal::Ciphertext& destination, const HESealBackend& he_seal_backend,
     seal::MemoryPoolHandle pool = seal::MemoryManager::GetPool()) {
   destination = encrypted;
-  ngraph::he::multiply_plain_inplace(destination, value, he_seal_backend,
-                                     std::move(pool));
+  ngraph::he::multiply_plain_inplace(destination, value, scale,
+                                     he_seal_backend, std::move(pool));
 }
 }  // namespace he
 }  // namespace ngraph
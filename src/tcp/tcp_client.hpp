@@ -23,10 +23,13 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "ngraph/log.hpp"
 
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_queue.hpp"
+#include "tcp/transport_uri.hpp"
 
 using boost::asio::ip::tcp;
 
@@ -34,45 +37,106 @@ namespace ngraph {
 namespace he {
 class TCPClient {
  public:
-  // Connects client to hostname:port and reads message
+  // Connects client to the server at uri and reads message
   // message_handler will handle responses from the server
-  TCPClient(boost::asio::io_context& io_context,
-            const tcp::resolver::results_type& endpoints,
+  TCPClient(boost::asio::io_context& io_context, const TransportURI& uri,
             std::function<void(const ngraph::he::TCPMessage&)> message_handler)
+      : TCPClient(io_context, uri.resolve(io_context),
+                  std::make_shared<TCPMessageQueue>(message_handler)) {}
+
+  void close() {
+    NGRAPH_INFO << "Closing socket";
+    // Called from the message handler, so close the socket on the I/O thread
+    boost::asio::post(m_io_context, [this]() {
+      for (auto& data_stream : m_data_streams) {
+        data_stream->close_socket();
+      }
+      close_socket();
+    });
+  }
+
+  // Messages are written in order. May be called from any thread, since the
+  // message handler runs off the I/O thread
+  void write_message(ngraph::he::TCPMessage&& message) {
+    auto shared_message = std::make_shared<TCPMessage>(std::move(message));
+    boost::asio::post(m_io_context, [this, shared_message]() {
+      enqueue_write(std::move(*shared_message));
+    });
+  }
+
+  // Writes a chunk of a bulk message on the next data stream, round-robin, or
+  // on the control connection if no data streams are open
+  void write_data_message(ngraph::he::TCPMessage&& message) {
+    auto shared_message = std::make_shared<TCPMessage>(std::move(message));
+    boost::asio::post(m_io_context, [this, shared_message]() {
+      if (m_data_streams.empty()) {
+        enqueue_write(std::move(*shared_message));
+      } else {
+        auto& data_stream =
+            m_data_streams[m_next_data_stream++ % m_data_streams.size()];
+        data_stream->enqueue_write(std::move(*shared_message));
+      }
+    });
+  }
+
+  // Opens count data connections to the server. Messages received on them
+  // are handled by the same message handler, in the order they are read
+  void open_data_streams(size_t count) {
+    boost::asio::post(m_io_context, [this, count]() {
+      NGRAPH_INFO << "Client opening " << count << " data streams";
+      for (size_t i = 0; i < count; ++i) {
+        m_data_streams.emplace_back(std::unique_ptr<TCPClient>(
+            new TCPClient(m_io_context, m_endpoints, m_message_queue)));
+      }
+    });
+  }
+
+ private:
+  TCPClient(boost::asio::io_context& io_context,
+            const std::vector<stream_protocol::endpoint>& endpoints,
+            std::shared_ptr<TCPMessageQueue> message_queue)
       : m_io_context(io_context),
         m_socket(io_context),
+        m_endpoints(endpoints),
+        m_read_message(std::make_unique<TCPMessage>()),
         m_first_connect(true),
-        m_message_callback(std::bind(message_handler, std::placeholders::_1)) {
+        m_connected(false),
+        m_message_queue(std::move(message_queue)) {
     NGRAPH_INFO << "Client starting async connection";
 
     // m_socket.set_option(boost::asio::ip::tcp::no_delay(true));
     // m_socket.set_option(boost::asio::socket_base::reuse_address(true));
 
-    do_connect(endpoints);
+    do_connect();
   }
 
-  void close() {
-    NGRAPH_INFO << "Closing socket";
-    m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both);
-    boost::asio::post(m_io_context, [this]() { m_socket.close(); });
+  // Must run on the I/O thread
+  void close_socket() {
+    boost::system::error_code ec;
+    m_socket.shutdown(boost::asio::socket_base::shutdown_both, ec);
+    m_socket.close(ec);
   }
 
-  void write_message(ngraph::he::TCPMessage&& message) {
-    bool write_in_progress = !m_message_queue.empty();
-    m_message_queue.emplace_back(std::move(message));
-    if (!write_in_progress) {
-      boost::asio::post(m_io_context, [this]() { do_write(); });
+  // Must run on the I/O thread
+  void enqueue_write(ngraph::he::TCPMessage&& message) {
+    bool write_in_progress = !m_write_queue.empty();
+    m_write_queue.emplace_back(std::move(message));
+    if (!write_in_progress && m_connected) {
+      do_write();
     }
   }
 
- private:
-  void do_connect(const tcp::resolver::results_type& endpoints) {
+  void do_connect() {
     boost::asio::async_connect(
-        m_socket, endpoints,
-        [this, &endpoints](boost::system::error_code ec, tcp::endpoint) {
+        m_socket, m_endpoints,
+        [this](boost::system::error_code ec,
+               const stream_protocol::endpoint&) {
           if (!ec) {
             NGRAPH_INFO << "Connected to server";
-
+            m_connected = true;
+            if (!m_write_queue.empty()) {
+              do_write();
+            }
             do_read_header();
           } else {
             if (true || m_first_connect) {
@@ -82,7 +146,7 @@ class TCPClient {
             }
             std::this_thread::sleep_for(std::chrono::seconds(1));
             NGRAPH_INFO << "Trying to connect again";
-            do_connect(std::move(endpoints));
+            do_connect();
           }
         });
   }
@@ -90,10 +154,10 @@ class TCPClient {
   void do_read_header() {
     boost::asio::async_read(
         m_socket,
-        boost::asio::buffer(m_read_message.header_ptr(),
+        boost::asio::buffer(m_read_message->header_ptr(),
                             ngraph::he::TCPMessage::header_length),
         [this](boost::system::error_code ec, std::size_t length) {
-          if (!ec && m_read_message.decode_header()) {
+          if (!ec && m_read_message->decode_header()) {
             do_read_body();
           } else {
             NGRAPH_INFO << "Client error reading header: " << ec.message();
@@ -105,12 +169,15 @@ class TCPClient {
   void do_read_body() {
     boost::asio::async_read(
         m_socket,
-        boost::asio::buffer(m_read_message.body_ptr(),
-                            m_read_message.body_length()),
+        boost::asio::buffer(m_read_message->body_ptr(),
+                            m_read_message->body_length()),
         [this](boost::system::error_code ec, std::size_t length) {
           if (!ec) {
-            m_read_message.decode_body();
-            m_message_callback(m_read_message);
+            m_read_message->decode_body();
+            // Handle the message on the worker and read the next one into a
+            // new buffer right away
+            m_message_queue->push(std::move(m_read_message));
+            m_read_message = std::make_unique<TCPMessage>();
             do_read_header();
           } else {
             NGRAPH_INFO << "Client error reading body; " << ec.message();
@@ -122,12 +189,12 @@ class TCPClient {
   void do_write() {
     boost::asio::async_write(
         m_socket,
-        boost::asio::buffer(m_message_queue.front().header_ptr(),
-                            m_message_queue.front().num_bytes()),
+        boost::asio::buffer(m_write_queue.front().header_ptr(),
+                            m_write_queue.front().num_bytes()),
         [this](boost::system::error_code ec, std::size_t length) {
           if (!ec) {
-            m_message_queue.pop_front();
-            if (!m_message_queue.empty()) {
+            m_write_queue.pop_front();
+            if (!m_write_queue.empty()) {
               do_write();
             }
           } else {
@@ -138,15 +205,22 @@ class TCPClient {
   }
 
   boost::asio::io_context& m_io_context;
-  tcp::socket m_socket;
+  stream_protocol::socket m_socket;
+  std::vector<stream_protocol::endpoint> m_endpoints;
 
-  TCPMessage m_read_message;
-  std::deque<ngraph::he::TCPMessage> m_message_queue;
+  std::unique_ptr<TCPMessage> m_read_message;
+  std::deque<ngraph::he::TCPMessage> m_write_queue;
 
   bool m_first_connect;
+  bool m_connected;
+
+  // Calls the message handler on received messages. Shared with the data
+  // streams, whose messages are read on the same I/O thread
+  std::shared_ptr<TCPMessageQueue> m_message_queue;
 
-  // How to handle the message
-  std::function<void(const ngraph::he::TCPMessage&)> m_message_callback;
+  // Additional connections striping bulk ciphertext messages
+  std::vector<std::unique_ptr<TCPClient>> m_data_streams;
+  size_t m_next_data_stream{0};
 };
 }  // namespace he
 }  // namespace ngraph
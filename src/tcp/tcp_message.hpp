@@ -35,21 +35,26 @@ namespace ngraph {
 namespace he {
 enum class MessageType {
   none,
+  activation_request,
+  activation_result,
+  data_streams,
   encryption_parameters,
   eval_key,
+  eval_key_request,
   execute,
+  galois_key,
   max_request,
   max_result,
   minimum_request,
   minimum_result,
+  parameter_set,
+  parameter_set_keys,
   parameter_shape_request,
   parameter_size,
   public_key,
-  relu_request,
-  relu6_request,
-  relu_result,
   result,
-  result_request
+  result_request,
+  session_token
 };
 
 inline std::string message_type_to_string(const MessageType& type) {
@@ -57,12 +62,27 @@ inline std::string message_type_to_string(const MessageType& type) {
     case MessageType::none:
       return "none";
       break;
+    case MessageType::activation_request:
+      return "activation_request";
+      break;
+    case MessageType::activation_result:
+      return "activation_result";
+      break;
+    case MessageType::data_streams:
+      return "data_streams";
+      break;
     case MessageType::encryption_parameters:
       return "encryption_parameters";
       break;
     case MessageType::eval_key:
       return "eval_key";
       break;
+    case MessageType::eval_key_request:
+      return "eval_key_request";
+      break;
+    case MessageType::galois_key:
+      return "galois_key";
+      break;
     case MessageType::public_key:
       return "public_key";
       break;
@@ -81,168 +101,225 @@ inline std::string message_type_to_string(const MessageType& type) {
     case MessageType::max_result:
       return "max_result";
       break;
+    case MessageType::parameter_set:
+      return "parameter_set";
+      break;
+    case MessageType::parameter_set_keys:
+      return "parameter_set_keys";
+      break;
     case MessageType::parameter_size:
       return "parameter_size";
       break;
     case MessageType::parameter_shape_request:
       return "parameter_shape_request";
       break;
-    case MessageType::relu_result:
-      return "relu_result";
-      break;
-    case MessageType::relu_request:
-      return "relu_request";
-      break;
-    case MessageType::relu6_request:
-      return "relu6_request";
-      break;
     case MessageType::result:
       return "result";
       break;
     case MessageType::result_request:
       return "result_request";
       break;
+    case MessageType::session_token:
+      return "session_token";
+      break;
     default:
       return "Unknown message type";
   }
 }
 
 // @brief Describes TCP messages of the form:
-// header        | message_type | count        | data  |
-// ^- header_ptr   ^- body_ptr    ^- count_ptr   ^- data_ptr
-//               | ---------------  body  ------------ |
+// header | message_type | count | offset | total_count | query_id |
+//        | prefix_size | prefix | data |
+//        | ---------------  body  ---------------------------------- |
+// with pointers header_ptr, body_ptr, count_ptr, offset_ptr,
+// total_count_ptr, query_id_ptr, prefix_size_ptr, prefix_ptr and data_ptr to
+// the respective fields
 // @param count number of elements of data
 // @param size number of bytes of data in message. Must be a multiple of
 // count
+// Large messages may be split into chunks, each of which stores elements
+// [offset, offset + count) of a message of total_count elements. Unchunked
+// messages have offset 0 and total_count == count.
+// query_id identifies the client query whose inputs or results a message
+// carries, so a client may have several queries in flight.
+// The optional prefix holds prefix_size bytes describing the data, e.g. the
+// activation to apply to the ciphertexts of a chunk. It is not part of the
+// count elements of data.
 class TCPMessage {
  public:
   enum { header_length = 15 };
   enum { max_body_length = 39900000000UL };
-  enum { default_body_length = 400000000UL };
+  enum { default_chunk_length = 16777216UL };
   enum { message_type_length = sizeof(MessageType) };
   enum { message_count_length = sizeof(size_t) };
+  enum { message_offset_length = sizeof(size_t) };
+  enum { message_total_count_length = sizeof(size_t) };
+  enum { message_query_id_length = sizeof(size_t) };
+  enum { message_prefix_size_length = sizeof(size_t) };
 
-  // Creates message with data buffer large enough to store default_body_length
+  // Creates message without data. Received messages grow their data buffer to
+  // fit the body in decode_header
   TCPMessage(const MessageType type)
-      : m_type(type), m_count(0), m_data_size(0) {
+      : m_type(type),
+        m_count(0),
+        m_offset(0),
+        m_total_count(0),
+        m_data_size(0) {
     std::set<MessageType> request_types{
-        MessageType::relu_request, MessageType::parameter_shape_request,
-        MessageType::result_request, MessageType::none};
+        MessageType::parameter_shape_request, MessageType::result_request,
+        MessageType::none};
 
     if (request_types.find(type) == request_types.end()) {
       throw std::invalid_argument("Request type not valid");
     }
     check_arguments();
-    size_t body_malloc_size =
-        std::max(body_length(), (size_t)default_body_length);
-    m_data = (char*)ngraph_malloc(header_length + body_malloc_size);
+    allocate(body_length());
     encode_header();
-    encode_message_type();
-    encode_count();
+    encode_body_info();
   }
 
   TCPMessage() : TCPMessage(MessageType::none) {}
 
-  // Encodes message of count elements using data in stream
-  TCPMessage(const MessageType type, size_t count, std::stringstream&& stream)
-      : m_type(type), m_count(count) {
+  // Encodes message of count elements using data in stream, preceded by
+  // prefix
+  TCPMessage(const MessageType type, size_t count, std::stringstream&& stream,
+             const std::string& prefix = "")
+      : m_type(type),
+        m_count(count),
+        m_offset(0),
+        m_total_count(count),
+        m_prefix_size(prefix.size()) {
     stream.seekp(0, std::ios::end);
     m_data_size = stream.tellp();
 
     check_arguments();
-    size_t body_malloc_size =
-        std::max(body_length(), (size_t)default_body_length);
-    m_data = (char*)ngraph_malloc(header_length + body_malloc_size);
+    allocate(body_length());
     encode_header();
-    encode_message_type();
-    encode_count();
+    encode_body_info();
+    std::memcpy(prefix_ptr(), prefix.data(), m_prefix_size);
     encode_data(std::move(stream));
   }
 
   TCPMessage(const MessageType type,
              const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphers)
-      : m_type(type), m_count(ciphers.size()) {
-    NGRAPH_CHECK(ciphers.size() > 0, "No ciphertexts in TCPMessage");
-    size_t cipher_size = ciphertext_size(ciphers[0]->ciphertext());
+      : TCPMessage(type, ciphers, 0, ciphers.size()) {}
+
+  // Encodes chunk of count ciphertexts starting at ciphers[offset], preceded
+  // by prefix
+  TCPMessage(const MessageType type,
+             const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphers,
+             size_t offset, size_t count, const std::string& prefix = "")
+      : m_type(type),
+        m_count(count),
+        m_offset(offset),
+        m_total_count(ciphers.size()),
+        m_prefix_size(prefix.size()) {
+    NGRAPH_CHECK(count > 0, "No ciphertexts in TCPMessage");
+    NGRAPH_CHECK(offset + count <= ciphers.size(), "Chunk [", offset, ", ",
+                 offset + count, ") out of bounds for ", ciphers.size(),
+                 " ciphertexts");
+    size_t cipher_size = ciphertext_size(ciphers[offset]->ciphertext());
     m_data_size = cipher_size * m_count;
 
     check_arguments();
-    size_t body_malloc_size =
-        std::max(body_length(), (size_t)default_body_length);
-    m_data = (char*)ngraph_malloc(header_length + body_malloc_size);
+    allocate(body_length());
     encode_header();
-    encode_message_type();
-    encode_count();
+    encode_body_info();
+    std::memcpy(prefix_ptr(), prefix.data(), m_prefix_size);
 
 #pragma omp parallel for
-    for (size_t i = 0; i < ciphers.size(); ++i) {
-      size_t offset = i * cipher_size;
+    for (size_t i = 0; i < count; ++i) {
+      const auto& cipher = ciphers[offset + i];
       std::stringstream ss;
       // TODO: save directly to buffer
-      ciphers[i]->save(ss);
-      NGRAPH_CHECK(ciphertext_size(ciphers[i]->ciphertext()) == cipher_size,
+      cipher->save(ss);
+      NGRAPH_CHECK(ciphertext_size(cipher->ciphertext()) == cipher_size,
                    "Cipher sizes don't match. Got size ",
-                   ciphertext_size(ciphers[i]->ciphertext()), ", expected ",
+                   ciphertext_size(cipher->ciphertext()), ", expected ",
                    cipher_size);
 
       std::stringbuf* pbuf = ss.rdbuf();
-      pbuf->sgetn(data_ptr() + offset, cipher_size);
+      pbuf->sgetn(data_ptr() + i * cipher_size, cipher_size);
     }
   }
 
   TCPMessage(const MessageType type,
              const std::vector<seal::Ciphertext>& ciphers)
-      : m_type(type), m_count(ciphers.size()) {
-    NGRAPH_CHECK(ciphers.size() > 0, "No ciphertexts in TCPMessage");
-    size_t cipher_size = ciphertext_size(ciphers[0]);
+      : TCPMessage(type, ciphers, 0, ciphers.size()) {}
+
+  // Encodes chunk of count ciphertexts starting at ciphers[offset], preceded
+  // by prefix
+  TCPMessage(const MessageType type,
+             const std::vector<seal::Ciphertext>& ciphers, size_t offset,
+             size_t count, const std::string& prefix = "")
+      : m_type(type),
+        m_count(count),
+        m_offset(offset),
+        m_total_count(ciphers.size()),
+        m_prefix_size(prefix.size()) {
+    NGRAPH_CHECK(count > 0, "No ciphertexts in TCPMessage");
+    NGRAPH_CHECK(offset + count <= ciphers.size(), "Chunk [", offset, ", ",
+                 offset + count, ") out of bounds for ", ciphers.size(),
+                 " ciphertexts");
+    size_t cipher_size = ciphertext_size(ciphers[offset]);
     m_data_size = cipher_size * m_count;
 
     check_arguments();
-    size_t body_malloc_size =
-        std::max(body_length(), (size_t)default_body_length);
-    m_data = (char*)ngraph_malloc(header_length + body_malloc_size);
+    allocate(body_length());
     encode_header();
-    encode_message_type();
-    encode_count();
+    encode_body_info();
+    std::memcpy(prefix_ptr(), prefix.data(), m_prefix_size);
 
 #pragma omp parallel for
-    for (size_t i = 0; i < ciphers.size(); ++i) {
-      size_t offset = i * cipher_size;
+    for (size_t i = 0; i < count; ++i) {
+      const seal::Ciphertext& cipher = ciphers[offset + i];
       std::stringstream ss;
       // TODO: save directly to buffer
-      ciphers[i].save(ss);
-      NGRAPH_CHECK(ciphertext_size(ciphers[i]) == cipher_size,
+      cipher.save(ss);
+      NGRAPH_CHECK(ciphertext_size(cipher) == cipher_size,
                    "Cipher sizes don't match. Got size ",
-                   ciphertext_size(ciphers[i]), " at index ", i, " expected ",
-                   cipher_size);
+                   ciphertext_size(cipher), " at index ", offset + i,
+                   " expected ", cipher_size);
 
       std::stringbuf* pbuf = ss.rdbuf();
-      pbuf->sgetn(data_ptr() + offset, cipher_size);
+      pbuf->sgetn(data_ptr() + i * cipher_size, cipher_size);
     }
   }
 
   TCPMessage(const MessageType type, const size_t count, const size_t size,
              const char* data)
-      : m_type(type), m_count(count), m_data_size(size) {
+      : m_type(type),
+        m_count(count),
+        m_offset(0),
+        m_total_count(count),
+        m_data_size(size) {
     check_arguments();
-    size_t body_malloc_size =
-        std::max(body_length(), (size_t)default_body_length);
-    m_data = (char*)ngraph_malloc(header_length + body_malloc_size);
+    allocate(body_length());
     encode_header();
-    encode_message_type();
-    encode_count();
+    encode_body_info();
     encode_data(data);
   }
 
   TCPMessage& operator=(TCPMessage&& other) {
     if (this != &other) {
+      ngraph_free(m_data);
       m_type = other.m_type;
       m_count = other.m_count;
+      m_offset = other.m_offset;
+      m_total_count = other.m_total_count;
+      m_query_id = other.m_query_id;
+      m_prefix_size = other.m_prefix_size;
       m_data_size = other.m_data_size;
+      m_body_capacity = other.m_body_capacity;
       m_data = other.m_data;
       other.m_data = nullptr;
+      other.m_body_capacity = 0;
       other.m_data_size = 0;
       other.m_count = 0;
+      other.m_offset = 0;
+      other.m_total_count = 0;
+      other.m_query_id = 0;
+      other.m_prefix_size = 0;
       other.m_type = MessageType::none;
     }
     return *this;
@@ -251,11 +328,23 @@ class TCPMessage {
   TCPMessage(TCPMessage&& other)
       : m_type(other.m_type),
         m_count(other.m_count),
+        m_offset(other.m_offset),
+        m_total_count(other.m_total_count),
+        m_query_id(other.m_query_id),
+        m_prefix_size(other.m_prefix_size),
         m_data_size(other.m_data_size),
+        m_body_capacity(other.m_body_capacity),
         m_data(other.m_data) {
     other.m_data = nullptr;
+    other.m_body_capacity = 0;
   };
 
+  /// @brief Returns the number of ciphertexts of size cipher_size to store in
+  /// each chunk of a chunked message
+  static size_t chunk_count(size_t cipher_size) {
+    return std::max(size_t(1), (size_t)default_chunk_length / cipher_size);
+  }
+
   TCPMessage& operator=(const TCPMessage&) = delete;
   TCPMessage(const TCPMessage& other) = delete;
 
@@ -265,6 +354,9 @@ class TCPMessage {
     if (m_count < 0) {
       throw std::invalid_argument("m_count must be non-negative");
     }
+    if (m_count > m_total_count || m_offset > m_total_count - m_count) {
+      throw std::invalid_argument("Chunk exceeds total count");
+    }
     if (m_count != 0 && m_data_size % m_count != 0) {
       NGRAPH_INFO << "Error: size " << m_data_size
                   << " not a multiple of count " << m_count;
@@ -277,9 +369,39 @@ class TCPMessage {
     }
   }
 
+  /// @brief Marks the message as the chunk of elements
+  /// [offset, offset + count) of a message of total_count elements, e.g. to
+  /// reply to a chunk with a chunk at the same position
+  void set_chunk(size_t offset, size_t total_count) {
+    m_offset = offset;
+    m_total_count = total_count;
+    check_arguments();
+    encode_offset();
+    encode_total_count();
+  }
+
+  /// @brief Tags the message with the client query it belongs to
+  void set_query_id(size_t query_id) {
+    m_query_id = query_id;
+    encode_query_id();
+  }
+
   size_t count() { return m_count; }
   const size_t count() const { return m_count; }
 
+  size_t offset() { return m_offset; }
+  const size_t offset() const { return m_offset; }
+
+  size_t total_count() { return m_total_count; }
+  const size_t total_count() const { return m_total_count; }
+
+  size_t query_id() { return m_query_id; }
+  const size_t query_id() const { return m_query_id; }
+
+  std::string prefix() const {
+    return std::string(prefix_ptr(), m_prefix_size);
+  }
+
   size_t element_size() {
     if (m_count == 0) {
       throw std::invalid_argument("m_count == 0");
@@ -313,7 +435,13 @@ class TCPMessage {
   const size_t data_size() const { return m_data_size; }
 
   size_t body_length() const {
-    return message_type_length + message_count_length + m_data_size;
+    return body_info_length() + m_prefix_size + m_data_size;
+  }
+
+  static size_t body_info_length() {
+    return message_type_length + message_count_length + message_offset_length +
+           message_total_count_length + message_query_id_length +
+           message_prefix_size_length;
   }
 
   MessageType message_type() { return m_type; }
@@ -328,8 +456,33 @@ class TCPMessage {
   char* count_ptr() { return body_ptr() + message_type_length; }
   const char* count_ptr() const { return body_ptr() + message_type_length; }
 
-  char* data_ptr() { return count_ptr() + message_count_length; }
-  const char* data_ptr() const { return count_ptr() + message_count_length; }
+  char* offset_ptr() { return count_ptr() + message_count_length; }
+  const char* offset_ptr() const { return count_ptr() + message_count_length; }
+
+  char* total_count_ptr() { return offset_ptr() + message_offset_length; }
+  const char* total_count_ptr() const {
+    return offset_ptr() + message_offset_length;
+  }
+
+  char* query_id_ptr() {
+    return total_count_ptr() + message_total_count_length;
+  }
+  const char* query_id_ptr() const {
+    return total_count_ptr() + message_total_count_length;
+  }
+
+  char* prefix_size_ptr() { return query_id_ptr() + message_query_id_length; }
+  const char* prefix_size_ptr() const {
+    return query_id_ptr() + message_query_id_length;
+  }
+
+  char* prefix_ptr() { return prefix_size_ptr() + message_prefix_size_length; }
+  const char* prefix_ptr() const {
+    return prefix_size_ptr() + message_prefix_size_length;
+  }
+
+  char* data_ptr() { return prefix_ptr() + m_prefix_size; }
+  const char* data_ptr() const { return prefix_ptr() + m_prefix_size; }
 
   // Given
   void encode_header() {
@@ -353,12 +506,18 @@ class TCPMessage {
       NGRAPH_INFO << "Body length " << body_length << " too large";
       throw std::invalid_argument("Cannot decode header");
     }
-    m_data_size = body_length - message_type_length - message_count_length;
+    if (body_length < body_info_length()) {
+      NGRAPH_INFO << "Body length " << body_length << " too small";
+      throw std::invalid_argument("Cannot decode header");
+    }
+    // Includes the prefix until decode_body
+    m_prefix_size = 0;
+    m_data_size = body_length - body_info_length();
 
     // Resize to fit message
-    if (body_length > default_body_length) {
+    if (body_length > m_body_capacity) {
       ngraph_free(m_data);
-      m_data = (char*)ngraph_malloc(header_length + body_length);
+      allocate(body_length);
       encode_header();
     }
 
@@ -381,6 +540,53 @@ class TCPMessage {
     std::memcpy(&m_count, count_ptr(), message_count_length);
   }
 
+  void encode_offset() {
+    std::memcpy(offset_ptr(), &m_offset, message_offset_length);
+  }
+
+  void decode_offset() {
+    std::memcpy(&m_offset, offset_ptr(), message_offset_length);
+  }
+
+  void encode_total_count() {
+    std::memcpy(total_count_ptr(), &m_total_count, message_total_count_length);
+  }
+
+  void decode_total_count() {
+    std::memcpy(&m_total_count, total_count_ptr(), message_total_count_length);
+  }
+
+  void encode_query_id() {
+    std::memcpy(query_id_ptr(), &m_query_id, message_query_id_length);
+  }
+
+  void decode_query_id() {
+    std::memcpy(&m_query_id, query_id_ptr(), message_query_id_length);
+  }
+
+  void encode_prefix_size() {
+    std::memcpy(prefix_size_ptr(), &m_prefix_size, message_prefix_size_length);
+  }
+
+  void decode_prefix_size() {
+    size_t prefix_size;
+    std::memcpy(&prefix_size, prefix_size_ptr(), message_prefix_size_length);
+    if (prefix_size > m_data_size) {
+      throw std::invalid_argument("Prefix size exceeds body");
+    }
+    m_prefix_size = prefix_size;
+    m_data_size -= prefix_size;
+  }
+
+  void encode_body_info() {
+    encode_message_type();
+    encode_count();
+    encode_offset();
+    encode_total_count();
+    encode_query_id();
+    encode_prefix_size();
+  }
+
   void encode_data(const char* data) {
     std::memcpy(data_ptr(), data, m_data_size);
   }
@@ -393,13 +599,31 @@ class TCPMessage {
   bool decode_body() {
     decode_message_type();
     decode_count();
+    decode_offset();
+    decode_total_count();
+    decode_query_id();
+    decode_prefix_size();
+    // The counts come from the network. This also checks that the data holds
+    // count elements of equal size after the prefix
+    check_arguments();
     return true;
   }
 
  private:
+  // Allocates the header and a body of body_size bytes
+  void allocate(size_t body_size) {
+    m_data = (char*)ngraph_malloc(header_length + body_size);
+    m_body_capacity = body_size;
+  }
+
   MessageType m_type;  // What data is being transmitted
   size_t m_count;      // Number of datatype in message
+  size_t m_offset;     // Index of first element in chunk
+  size_t m_total_count;  // Number of elements across all chunks
+  size_t m_query_id{0};  // Client query the message belongs to
+  size_t m_prefix_size{0};  // Number of bytes in prefix part of message
   size_t m_data_size;  // Nubmer of bytes in data part of message
+  size_t m_body_capacity{0};  // Number of bytes allocated for the body
   char* m_data;
 };
 }  // namespace he
@@ -0,0 +1,109 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <boost/lockfree/spsc_queue.hpp>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph {
+namespace he {
+/// \brief Hands received messages from the I/O thread to a worker thread, which
+/// calls the message handler on each message in the order it was received.
+/// This lets the I/O thread read the next message while the previous one is
+/// deserialized.
+class TCPMessageQueue {
+ public:
+  enum { queue_capacity = 1024 };
+
+  TCPMessageQueue(
+      std::function<void(const ngraph::he::TCPMessage&)> message_handler)
+      : m_message_callback(std::move(message_handler)),
+        m_stopped(false),
+        m_worker([this]() { run(); }) {}
+
+  ~TCPMessageQueue() { stop(); }
+
+  TCPMessageQueue(const TCPMessageQueue&) = delete;
+  TCPMessageQueue& operator=(const TCPMessageQueue&) = delete;
+
+  /// \brief Queues a message for the worker. Must only be called from a single
+  /// (I/O) thread
+  void push(std::unique_ptr<TCPMessage> message) {
+    TCPMessage* raw_message = message.release();
+    while (!m_messages.push(raw_message)) {
+      std::this_thread::yield();
+    }
+    // Take the lock so the notification can't be lost between the worker
+    // checking the queue and going to sleep
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+    m_cond.notify_one();
+  }
+
+  /// \brief Handles the remaining messages and joins the worker
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_stopped) {
+        return;
+      }
+      m_stopped = true;
+    }
+    m_cond.notify_one();
+    if (m_worker.joinable()) {
+      m_worker.join();
+    }
+  }
+
+ private:
+  void run() {
+    while (true) {
+      TCPMessage* raw_message;
+      if (m_messages.pop(raw_message)) {
+        std::unique_ptr<TCPMessage> message(raw_message);
+        m_message_callback(*message);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cond.wait(lock, [this]() {
+        return m_stopped || m_messages.read_available() > 0;
+      });
+      if (m_stopped && m_messages.read_available() == 0) {
+        return;
+      }
+    }
+  }
+
+  std::function<void(const ngraph::he::TCPMessage&)> m_message_callback;
+  boost::lockfree::spsc_queue<TCPMessage*,
+                              boost::lockfree::capacity<queue_capacity>>
+      m_messages;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_stopped;
+
+  // Declared last, so it starts after the members it uses
+  std::thread m_worker;
+};
+}  // namespace he
+}  // namespace ngraph
@@ -17,12 +17,16 @@
 #pragma once
 
 #include <boost/asio.hpp>
+#include <deque>
 #include <functional>
+#include <future>
 #include <memory>
-#include <mutex>
+#include <stdexcept>
 
 #include "ngraph/log.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_queue.hpp"
+#include "tcp/transport_uri.hpp"
 
 using boost::asio::ip::tcp;
 
@@ -30,11 +34,13 @@ namespace ngraph {
 namespace he {
 class TCPSession : public std::enable_shared_from_this<TCPSession> {
  public:
-  TCPSession(tcp::socket socket,
-             std::function<void(const ngraph::he::TCPMessage&)> message_handler)
-      : m_socket(std::move(socket)),
-        m_writing(false),
-        m_message_callback(std::bind(message_handler, std::placeholders::_1)) {}
+  // Received messages are handed to message_queue, which may be shared by
+  // the sessions of one client
+  TCPSession(stream_protocol::socket socket,
+             std::shared_ptr<TCPMessageQueue> message_queue)
+      : m_message(std::make_unique<TCPMessage>()),
+        m_socket(std::move(socket)),
+        m_message_queue(std::move(message_queue)) {}
 
   void start() { do_read_header(); }
 
@@ -43,10 +49,10 @@ class TCPSession : public std::enable_shared_from_this<TCPSession> {
     auto self(shared_from_this());
     boost::asio::async_read(
         m_socket,
-        boost::asio::buffer(m_message.header_ptr(),
+        boost::asio::buffer(m_message->header_ptr(),
                             ngraph::he::TCPMessage::header_length),
         [this, self](boost::system::error_code ec, std::size_t length) {
-          if (!ec & m_message.decode_header()) {
+          if (!ec && m_message->decode_header()) {
             do_read_body();
           } else {
             if (ec) {
@@ -61,11 +67,14 @@ class TCPSession : public std::enable_shared_from_this<TCPSession> {
     auto self(shared_from_this());
     boost::asio::async_read(
         m_socket,
-        boost::asio::buffer(m_message.body_ptr(), m_message.body_length()),
+        boost::asio::buffer(m_message->body_ptr(), m_message->body_length()),
         [this, self](boost::system::error_code ec, std::size_t length) {
           if (!ec) {
-            m_message.decode_body();
-            m_message_callback(m_message);
+            m_message->decode_body();
+            // Handle the message on the worker and read the next one into a
+            // new buffer right away
+            m_message_queue->push(std::move(m_message));
+            m_message = std::make_unique<TCPMessage>();
             do_read_header();
           } else {
             NGRAPH_INFO << "Server error reading message: " << ec.message();
@@ -74,32 +83,64 @@ class TCPSession : public std::enable_shared_from_this<TCPSession> {
         });
   }
 
-  void do_write(const TCPMessage&& message) {
-    std::lock_guard<std::mutex> lock(m_write_mtx);
+  // Queues message to be written after all previously queued messages. May
+  // be called from any thread. The returned future is ready once the message
+  // is written, or holds the error if writing failed
+  std::future<void> do_write(TCPMessage&& message) {
+    auto pending_write = std::make_shared<PendingWrite>(std::move(message));
+    std::future<void> written = pending_write->written.get_future();
+
+    auto self(shared_from_this());
+    boost::asio::post(m_socket.get_executor(), [this, self, pending_write]() {
+      bool write_in_progress = !m_write_queue.empty();
+      m_write_queue.emplace_back(pending_write);
+      if (!write_in_progress) {
+        write_front();
+      }
+    });
+    return written;
+  }
+
+  std::unique_ptr<TCPMessage> m_message;
+  stream_protocol::socket m_socket;
+
+  // Calls the message handler on received messages
+  std::shared_ptr<TCPMessageQueue> m_message_queue;
+
+ private:
+  struct PendingWrite {
+    PendingWrite(TCPMessage&& msg) : message(std::move(msg)) {}
+
+    TCPMessage message;
+    std::promise<void> written;
+  };
+
+  // Must run on the I/O thread
+  void write_front() {
     auto self(shared_from_this());
-    m_writing = true;
+    const TCPMessage& message = m_write_queue.front()->message;
     boost::asio::async_write(
         m_socket,
         boost::asio::buffer(message.header_ptr(), message.num_bytes()),
         [this, self](boost::system::error_code ec, std::size_t length) {
+          auto pending_write = m_write_queue.front();
+          m_write_queue.pop_front();
           if (ec) {
             NGRAPH_INFO << "Error writing message in session: " << ec.message();
-
+            pending_write->written.set_exception(std::make_exception_ptr(
+                std::runtime_error("Error writing message in session: " +
+                                   ec.message())));
           } else {
-            m_writing = false;
+            pending_write->written.set_value();
+          }
+          if (!m_write_queue.empty()) {
+            write_front();
           }
         });
   }
 
-  bool is_writing() const { return m_writing; }
-
-  TCPMessage m_message;
-  tcp::socket m_socket;
-  bool m_writing;
-  std::mutex m_write_mtx;
-
-  // Called after message is received
-  std::function<void(const ngraph::he::TCPMessage&)> m_message_callback;
+  // Messages waiting to be written; the front message is being written
+  std::deque<std::shared_ptr<PendingWrite>> m_write_queue;
 };
 }  // namespace he
 }  // namespace ngraph
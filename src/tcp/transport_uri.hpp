@@ -0,0 +1,118 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <string>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "ngraph/except.hpp"
+
+namespace ngraph {
+namespace he {
+// Sessions and clients use generic stream sockets, so the same message
+// handling runs over TCP and Unix domain sockets
+using stream_protocol = boost::asio::generic::stream_protocol;
+using stream_acceptor = boost::asio::basic_socket_acceptor<stream_protocol>;
+
+/// \brief Selects the transport between server and client. Supported URIs are
+/// tcp://<host>:<port> and unix://<socket path>. A server given the tcp host
+/// "*" listens on all IPv4 interfaces.
+class TransportURI {
+ public:
+  enum class Scheme { tcp, unix_socket };
+
+  TransportURI(const std::string& uri) : m_uri(uri) {
+    const std::string tcp_prefix{"tcp://"};
+    const std::string unix_prefix{"unix://"};
+
+    if (uri.compare(0, tcp_prefix.size(), tcp_prefix) == 0) {
+      m_scheme = Scheme::tcp;
+      std::string host_port = uri.substr(tcp_prefix.size());
+      size_t colon_pos = host_port.rfind(':');
+      NGRAPH_CHECK(colon_pos != std::string::npos && colon_pos > 0 &&
+                       colon_pos + 1 < host_port.size(),
+                   "Transport URI ", uri, " must be tcp://<host>:<port>");
+      m_host = host_port.substr(0, colon_pos);
+      std::string port_str = host_port.substr(colon_pos + 1);
+      NGRAPH_CHECK(port_str.find_first_not_of("0123456789") ==
+                       std::string::npos,
+                   "Invalid port in transport URI ", uri);
+      m_port = std::stoul(port_str);
+      NGRAPH_CHECK(m_port <= 65535, "Invalid port in transport URI ", uri);
+    } else if (uri.compare(0, unix_prefix.size(), unix_prefix) == 0) {
+      m_scheme = Scheme::unix_socket;
+      m_path = uri.substr(unix_prefix.size());
+      NGRAPH_CHECK(!m_path.empty(), "Transport URI ", uri,
+                   " must be unix://<socket path>");
+    } else {
+      throw ngraph_error("Unsupported transport URI " + uri +
+                         " (expected tcp:// or unix://)");
+    }
+  }
+
+  static TransportURI from_host_port(const std::string& hostname,
+                                     size_t port) {
+    return TransportURI("tcp://" + hostname + ":" + std::to_string(port));
+  }
+
+  Scheme scheme() const { return m_scheme; }
+  const std::string& host() const { return m_host; }
+  size_t port() const { return m_port; }
+  const std::string& path() const { return m_path; }
+  const std::string& to_string() const { return m_uri; }
+
+  /// \brief Returns the endpoints a client tries to connect to
+  std::vector<stream_protocol::endpoint> resolve(
+      boost::asio::io_context& io_context) const {
+    std::vector<stream_protocol::endpoint> endpoints;
+    if (m_scheme == Scheme::tcp) {
+      boost::asio::ip::tcp::resolver resolver(io_context);
+      for (const auto& entry :
+           resolver.resolve(m_host, std::to_string(m_port))) {
+        endpoints.emplace_back(entry.endpoint());
+      }
+    } else {
+      endpoints.emplace_back(
+          boost::asio::local::stream_protocol::endpoint(m_path));
+    }
+    return endpoints;
+  }
+
+  /// \brief Returns the endpoint a server listens on
+  stream_protocol::endpoint listen_endpoint() const {
+    if (m_scheme == Scheme::tcp) {
+      if (m_host == "*") {
+        return boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(),
+                                              m_port);
+      }
+      return boost::asio::ip::tcp::endpoint(
+          boost::asio::ip::make_address(m_host), m_port);
+    }
+    return boost::asio::local::stream_protocol::endpoint(m_path);
+  }
+
+ private:
+  std::string m_uri;
+  Scheme m_scheme;
+  std::string m_host;
+  size_t m_port{0};
+  std::string m_path;
+};
+}  // namespace he
+}  // namespace ngraph
@@ -450,3 +450,46 @@ NGRAPH_TEST(${BACKEND_NAME}, batch_norm_fusion_he_batch) {
   EXPECT_TRUE(test::all_close(read_vector<float>(t_orig_result),
                               read_vector<float>(t_opt_result), 0.6f));
 }
+
+NGRAPH_TEST(${BACKEND_NAME}, batch_norm_folding_dot_bias) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+  he_backend->set_pack_data(false);
+
+  Shape shape_input{2, 3};
+  Shape shape_weights{3, 2};
+  Shape shape_norm{2};
+  auto et = element::f32;
+
+  std::vector<float> input{1.25f, -2.5f, 0.5f, -0.75f, 3.f, 2.f};
+  std::vector<float> weight_vals{0.5f, -1.f, 2.f, 0.25f, -0.5f, 1.5f};
+  std::vector<float> bias_vals{0.5f, -1.25f};
+  std::vector<float> gamma_vals{-0.25f, 0.5f};
+  std::vector<float> beta_vals{1.5f, -0.5f};
+  std::vector<float> mean_vals{0.125f, 0.25f};
+  std::vector<float> var_vals{0.25f, 2.f};
+
+  auto make_function = [=]() {
+    auto input = std::make_shared<op::Parameter>(et, shape_input);
+    auto weights =
+        std::make_shared<op::Constant>(et, shape_weights, weight_vals);
+    auto bias = std::make_shared<op::Broadcast>(
+        std::make_shared<op::Constant>(et, shape_norm, bias_vals),
+        Shape{2, 2}, AxisSet{0});
+    auto gamma = std::make_shared<op::Constant>(et, shape_norm, gamma_vals);
+    auto beta = std::make_shared<op::Constant>(et, shape_norm, beta_vals);
+    auto mean = std::make_shared<op::Constant>(et, shape_norm, mean_vals);
+    auto var = std::make_shared<op::Constant>(et, shape_norm, var_vals);
+    auto dot = std::make_shared<op::Dot>(input, weights);
+    auto add = std::make_shared<op::Add>(dot, bias);
+    auto bn = std::make_shared<op::BatchNormInference>(add, gamma, beta, mean,
+                                                       var, 0.001);
+    return make_shared<Function>(NodeVector{bn}, ParameterVector{input});
+  };
+
+  // The batch norm is folded into the Dot weights and bias
+  check_against_interpreter(
+      backend.get(), make_function, {input}, [](const shared_ptr<Function>& f) {
+        EXPECT_EQ(0, count_ops_of_type<op::BatchNormInference>(f));
+      });
+}
@@ -342,3 +342,53 @@ NGRAPH_TEST(${BACKEND_NAME}, convolution_2d_2items_strided_padded) {
         1e-3f));
   }
 }
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_2d_sparse_constant_filter) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  auto shape_a = Shape{1, 1, 3, 3};
+  auto a = make_shared<op::Parameter>(element::f32, shape_a);
+  // The zero tap is dropped, and the taps of weight 1 share a product
+  auto b = op::Constant::create<float>(element::f32, Shape{1, 1, 2, 2},
+                                       {1, 0, 1, -2});
+  auto t = make_shared<op::Convolution>(a, b);
+  auto f = make_shared<Function>(t, ParameterVector{a});
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape_a);
+  auto t_result =
+      he_backend->create_cipher_tensor(element::f32, t->get_shape());
+  copy_data(t_a, vector<float>{1, -2, 3, 0.5, 4, -1, 2, 2, -3});
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(all_close(read_vector<float>(t_result),
+                        vector<float>{-6.5, 4, -1.5, 12}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_2d_winograd) {
+  Shape shape_a{1, 2, 5, 5};
+  Shape shape_b{2, 2, 3, 3};
+  vector<float> filter(shape_size(shape_b));
+  for (size_t i = 0; i < filter.size(); ++i) {
+    filter[i] = 0.1f * i - 1.75f;
+  }
+  // Odd output sizes leave half tiles at the border
+  auto make_function = [&]() {
+    auto a = make_shared<op::Parameter>(element::f32, shape_a);
+    auto b = op::Constant::create<float>(element::f32, shape_b, filter);
+    auto t = make_shared<op::Convolution>(
+        a, b, Strides{1, 1}, Strides{1, 1}, CoordinateDiff{1, 1},
+        CoordinateDiff{1, 1});
+    return make_shared<Function>(t, ParameterVector{a});
+  };
+  vector<float> input(shape_size(shape_a));
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = (i % 5) * 0.5f - 1;
+  }
+
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  setenv("NGRAPH_HE_WINOGRAD", "1", 1);
+  check_against_interpreter(backend.get(), make_function, {input});
+  unsetenv("NGRAPH_HE_WINOGRAD");
+}
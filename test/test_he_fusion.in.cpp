@@ -16,7 +16,12 @@
 
 #include "ngraph/ngraph.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/scale_division.hpp"
+#include "pass/he_depth_analysis.hpp"
 #include "pass/he_fusion.hpp"
+#include "pass/he_linear_composition.hpp"
+#include "pass/he_rescale_placement.hpp"
+#include "pass/he_scale_planning.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
@@ -81,3 +86,295 @@ NGRAPH_TEST(${BACKEND_NAME}, bounded_relu_fusion) {
   check_bounded_relu(Shape{4, 3}, 4.0f);
   check_bounded_relu(Shape{4, 3, 2}, 2.0f);
 }
+
+NGRAPH_TEST(${BACKEND_NAME}, scale_division_fusion) {
+  Shape shape{2, 3};
+  auto make_function = [shape]() {
+    auto a = make_shared<op::Parameter>(element::f32, shape);
+    auto quarter = op::Constant::create<float>(element::f32, shape,
+                                               vector<float>(6, 0.25f));
+    auto third = op::Constant::create<float>(element::f32, shape,
+                                             vector<float>(6, 1.f / 3));
+    // The sum adds ciphertexts of scales in ratio 4:3
+    auto add = make_shared<op::Add>(make_shared<op::Multiply>(a, quarter),
+                                    make_shared<op::Multiply>(third, a));
+    return make_shared<Function>(add, ParameterVector{a});
+  };
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  check_against_interpreter(
+      backend.get(), make_function, {{1, -2, 3.5, 0.25, -8, 12}},
+      [](const shared_ptr<Function>& f) {
+        EXPECT_EQ(2, count_ops_of_type<op::ScaleDivision>(f));
+        EXPECT_EQ(0, count_ops_of_type<op::Multiply>(f));
+      });
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, depth_analysis) {
+  Shape shape{2, 2};
+  auto a = make_shared<op::Parameter>(element::f32, shape);
+  auto b = op::Constant::create<float>(element::f32, shape, {1, 2, 3, 4});
+  auto zero = op::Constant::create<float>(element::f32, shape, {0, 0, 0, 0});
+  auto dot = make_shared<op::Dot>(a, b);
+  auto square = make_shared<op::Multiply>(dot, dot);
+  auto relu = make_shared<op::Relu>(square);
+  auto mult = make_shared<op::Multiply>(relu, b);
+  auto known = make_shared<op::Multiply>(relu, zero);
+  auto add = make_shared<op::Add>(mult, known);
+  auto f = make_shared<Function>(add, ParameterVector{a});
+
+  ngraph::pass::Manager pass_manager;
+  auto depth_analysis =
+      pass_manager.register_pass<ngraph::he::pass::HEDepthAnalysis>(
+          false, false, ngraph::he::PolynomialActivation());
+  pass_manager.run_passes(f);
+
+  // The client round trip of Relu starts a new segment
+  EXPECT_EQ(depth_analysis->segment_levels(), (vector<size_t>{2, 1}));
+  EXPECT_EQ(depth_analysis->levels(square.get()), 2u);
+  EXPECT_EQ(depth_analysis->segment(mult.get()), 1u);
+  // Products with zero are known values
+  EXPECT_FALSE(depth_analysis->is_cipher(known.get()));
+
+  // Polynomial activations are evaluated within the segment
+  ngraph::pass::Manager poly_pass_manager;
+  auto poly_depth_analysis =
+      poly_pass_manager.register_pass<ngraph::he::pass::HEDepthAnalysis>(
+          false, false, ngraph::he::PolynomialActivation::parse("square"));
+  poly_pass_manager.run_passes(f);
+  EXPECT_EQ(poly_depth_analysis->segment_levels(), (vector<size_t>{4}));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, scale_planning) {
+  Shape shape{2, 2};
+  auto make_function = [shape]() {
+    auto a = make_shared<op::Parameter>(element::f32, shape);
+    auto w = op::Constant::create<float>(element::f32, shape,
+                                         {0.5, -1.25, 2, 3.1});
+    // The residual connections keep the Dots from being composed, and add
+    // ciphertexts of different scales
+    auto x1 = make_shared<op::Add>(make_shared<op::Dot>(a, w), a);
+    auto x2 = make_shared<op::Add>(make_shared<op::Dot>(x1, w), a);
+    auto dot = make_shared<op::Dot>(x2, w);
+    return make_shared<Function>(dot, ParameterVector{a});
+  };
+
+  // The largest weight 3.1 < 2^2 is encoded at 2^(14 - 1), so two products
+  // grow the scale by more than a 24-bit modulus
+  auto f = make_function();
+  ngraph::pass::Manager pass_manager;
+  auto scale_planning =
+      pass_manager.register_pass<ngraph::he::pass::HEScalePlanning>(14, 24);
+  auto depth_analysis =
+      pass_manager.register_pass<ngraph::he::pass::HEDepthAnalysis>(
+          false, false, ngraph::he::PolynomialActivation(), scale_planning);
+  pass_manager.run_passes(f);
+  auto w = f->get_results()[0]->get_argument(0)->get_argument(1);
+  EXPECT_EQ(scale_planning->encoding_scale(w.get()), 8192.);
+  EXPECT_EQ(depth_analysis->max_levels(), 1u);
+
+  ngraph::pass::Manager unplanned_pass_manager;
+  auto unplanned_depth_analysis =
+      unplanned_pass_manager.register_pass<ngraph::he::pass::HEDepthAnalysis>(
+          false, false, ngraph::he::PolynomialActivation());
+  unplanned_pass_manager.run_passes(f);
+  EXPECT_EQ(unplanned_depth_analysis->max_levels(), 3u);
+
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  setenv("NGRAPH_HE_SCALE_PLANNING", "1", 1);
+  check_against_interpreter(backend.get(), make_function, {{1, 2, 3, 0.5}});
+  unsetenv("NGRAPH_HE_SCALE_PLANNING");
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, rescale_placement) {
+  Shape shape{2, 2};
+  auto make_function = [shape]() {
+    auto a = make_shared<op::Parameter>(element::f32, shape);
+    auto w1 = op::Constant::create<float>(element::f32, shape,
+                                          {0.5, -1.25, 2, 3.1});
+    auto w2 = op::Constant::create<float>(element::f32, shape,
+                                          {-0.75, 1, 0.25, 1.5});
+    auto sum = make_shared<op::Add>(
+        make_shared<op::Dot>(a, w1),
+        make_shared<op::Reshape>(make_shared<op::Dot>(a, w2), AxisVector{1, 0},
+                                 shape));
+    // dot1 has two users, so it is rescaled itself
+    auto dot1 = make_shared<op::Dot>(sum, w1);
+    auto dot2 = make_shared<op::Dot>(sum, w2);
+    auto out = make_shared<op::Add>(dot1, dot2);
+    return make_shared<Function>(NodeVector{out, dot1}, ParameterVector{a});
+  };
+
+  auto f = make_function();
+  ngraph::pass::Manager pass_manager;
+  auto depth_analysis =
+      pass_manager.register_pass<ngraph::he::pass::HEDepthAnalysis>(
+          false, false, ngraph::he::PolynomialActivation());
+  auto rescale_placement =
+      pass_manager.register_pass<ngraph::he::pass::HERescalePlacement>(
+          depth_analysis);
+  pass_manager.run_passes(f);
+
+  auto out = f->get_results()[0]->get_argument(0);
+  auto dot1 = out->get_argument(0);
+  auto dot2 = out->get_argument(1);
+  auto sum = dot1->get_argument(0);
+  auto reshape = sum->get_argument(1);
+  EXPECT_FALSE(rescale_placement->rescales(sum->get_argument(0).get()));
+  EXPECT_FALSE(rescale_placement->rescales(reshape.get()));
+  EXPECT_FALSE(rescale_placement->rescales(reshape->get_argument(0).get()));
+  EXPECT_TRUE(rescale_placement->rescales(sum.get()));
+  EXPECT_TRUE(rescale_placement->rescales(dot1.get()));
+  EXPECT_TRUE(rescale_placement->rescales(dot2.get()));
+  EXPECT_FALSE(rescale_placement->rescales(out.get()));
+  EXPECT_EQ(rescale_placement->rescaled_nodes().size(), 3u);
+  EXPECT_EQ(depth_analysis->max_levels(), 2u);
+
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  check_against_interpreter(backend.get(), make_function, {{1, 2, 3, 0.5}});
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, bias_fusion) {
+  Shape shape_a{2, 1, 3, 3};
+  Shape shape_f{2, 1, 2, 2};
+  Shape shape_conv{2, 2, 2, 2};
+  auto make_function = [shape_a, shape_f, shape_conv]() {
+    auto a = make_shared<op::Parameter>(element::f32, shape_a);
+    auto f = op::Constant::create<float>(element::f32, shape_f,
+                                         {0.5, -1, 0.25, 2, 1, -0.5, 0.75, -2});
+    auto conv_bias = make_shared<op::Broadcast>(
+        op::Constant::create<float>(element::f32, Shape{2}, {0.1, -0.3}),
+        shape_conv, AxisSet{0, 2, 3});
+    auto conv = make_shared<op::Add>(make_shared<op::Convolution>(a, f),
+                                     conv_bias);
+    auto reshape =
+        make_shared<op::Reshape>(conv, AxisVector{0, 1, 2, 3}, Shape{2, 8});
+    auto w = op::Constant::create<float>(
+        element::f32, Shape{8, 2},
+        {0.5, -0.25, 1, 0.75, -1, 0.5, 0.25, -0.5, 2, 1, -0.75, 0.25, 0.5, 1,
+         -0.5, 0.25});
+    auto dot_bias =
+        op::Constant::create<float>(element::f32, Shape{2, 2}, {1, -2, 3, 4});
+    // The bias may be either argument of the Add
+    auto dot = make_shared<op::Add>(dot_bias, make_shared<op::Dot>(reshape, w));
+    return make_shared<Function>(dot, ParameterVector{a});
+  };
+
+  auto f = make_function();
+  ngraph::pass::Manager pass_manager;
+  pass_manager.register_pass<ngraph::he::pass::HEBiasFusion>();
+  pass_manager.run_passes(f);
+  auto count_ops = [&f](const string& description) {
+    size_t count = 0;
+    for (const auto& node : f->get_ordered_ops()) {
+      count += node->description() == description;
+    }
+    return count;
+  };
+  EXPECT_EQ(count_ops("BiasedConvolution"), 1u);
+  EXPECT_EQ(count_ops("BiasedDot"), 1u);
+  EXPECT_EQ(count_ops("Add"), 0u);
+
+  vector<float> input(shape_size(shape_a));
+  test::Uniform<float> rng(-1.0f, 1.0f);
+  rng.initialize(input);
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  check_against_interpreter(backend.get(), make_function, {input});
+}
+
+// Checks that composing the linear ops of the function leaves expected_ops
+// ops, which check_composed may inspect further, and compares its HE result
+// to the INTERPRETER result
+static void check_linear_composition(
+    const function<shared_ptr<Function>()>& make_function,
+    size_t expected_ops,
+    const function<void(const shared_ptr<Function>&)>& check_composed =
+        nullptr) {
+  auto f = make_function();
+  ngraph::pass::Manager pass_manager;
+  pass_manager.register_pass<ngraph::he::pass::HELinearComposition>();
+  pass_manager.run_passes(f);
+  EXPECT_EQ(f->get_ordered_ops().size(), expected_ops);
+  if (check_composed) {
+    check_composed(f);
+  }
+
+  vector<float> input(shape_size(f->get_parameters()[0]->get_shape()));
+  test::Uniform<float> rng(-1.0f, 1.0f);
+  rng.initialize(input);
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  check_against_interpreter(backend.get(), make_function, {input});
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, linear_composition) {
+  // Dot(Dot(x, W1) + bias, W2) => Dot(x, W1 W2) + bias W2
+  check_linear_composition(
+      []() {
+        auto x = make_shared<op::Parameter>(element::f32, Shape{2, 3});
+        auto w1 = op::Constant::create<float>(element::f32, Shape{3, 4},
+                                              {0.5, -1, 0.25, 2, 1, 0, -0.5,
+                                               0.75, -2, 1.5, 1, -0.25});
+        auto w2 = op::Constant::create<float>(element::f32, Shape{4, 2},
+                                              {1, -0.5, 0.25, 2, -1, 1, 0.5,
+                                               -0.75});
+        auto bias = make_shared<op::Broadcast>(
+            op::Constant::create<float>(element::f32, Shape{4},
+                                        {0.5, -0.25, 1, 0}),
+            Shape{2, 4}, AxisSet{0});
+        auto dot1 = make_shared<op::Dot>(x, w1);
+        auto add = make_shared<op::Add>(dot1, bias);
+        auto dot2 = make_shared<op::Dot>(add, w2);
+        return make_shared<Function>(dot2, ParameterVector{x});
+      },
+      // Parameter, Constant, Dot, Constant, Broadcast, Add, Result
+      7);
+
+  // AvgPool(Convolution(x, F)) => Convolution(x, F') with stride 2
+  check_linear_composition(
+      []() {
+        auto x = make_shared<op::Parameter>(element::f32, Shape{1, 1, 6, 6});
+        auto filters = op::Constant::create<float>(
+            element::f32, Shape{2, 1, 2, 2},
+            {0.5, -1, 0.25, 2, 1, 0, -0.5, 0.75});
+        auto conv = make_shared<op::Convolution>(x, filters);
+        auto avg_pool = make_shared<op::AvgPool>(conv, Shape{2, 2},
+                                                 Strides{2, 2});
+        return make_shared<Function>(avg_pool, ParameterVector{x});
+      },
+      // Parameter, Constant, Convolution, Result
+      4);
+
+  // Dot(Reshape(Convolution(x, F)), W) => Dot(Reshape(x), W'), with the
+  // padding and stride folded into W'
+  check_linear_composition(
+      []() {
+        auto x = make_shared<op::Parameter>(element::f32, Shape{1, 1, 5, 5});
+        vector<float> filter_vals(18);
+        for (size_t i = 0; i < filter_vals.size(); ++i) {
+          filter_vals[i] = 0.25f * (i % 7) - 0.75f;
+        }
+        auto filters = op::Constant::create<float>(
+            element::f32, Shape{2, 1, 3, 3}, filter_vals);
+        auto conv = make_shared<op::Convolution>(
+            x, filters, Strides{2, 2}, Strides{1, 1}, CoordinateDiff{1, 1},
+            CoordinateDiff{1, 1});
+        auto reshape = make_shared<op::Reshape>(conv, AxisVector{0, 1, 2, 3},
+                                                Shape{1, 18});
+        vector<float> weight_vals(36);
+        for (size_t i = 0; i < weight_vals.size(); ++i) {
+          weight_vals[i] = 0.125f * (i % 11) - 0.5f;
+        }
+        auto w = op::Constant::create<float>(element::f32, Shape{18, 2},
+                                             weight_vals);
+        auto dot = make_shared<op::Dot>(reshape, w);
+        return make_shared<Function>(dot, ParameterVector{x});
+      },
+      // Parameter, Reshape, Constant, Dot, Result
+      5, [](const shared_ptr<Function>& f) {
+        EXPECT_EQ(0, count_ops_of_type<op::Convolution>(f));
+        // The Dot of the Convolution output is replaced by a Dot of the input
+        auto dot = f->get_results()[0]->get_argument(0);
+        EXPECT_EQ(dot->description(), "Dot");
+        EXPECT_EQ(dot->get_argument(0)->get_argument(0)->description(),
+                  "Parameter");
+      });
+}
@@ -148,3 +148,28 @@ NGRAPH_TEST(${BACKEND_NAME}, relu_batched_cipher_2_3) {
   EXPECT_TRUE(all_close(read_vector<float>(t_result),
                         vector<float>{0, 0, 0, 0.5, 1, 1.5}, 1e-3f));
 }
+
+NGRAPH_TEST(${BACKEND_NAME}, relu_cipher_2_3_polynomial) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  auto a = make_shared<op::Parameter>(element::f32, shape);
+  auto t = make_shared<op::Relu>(a);
+  auto f = make_shared<Function>(t, ParameterVector{a});
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  copy_data(t_a, vector<float>{-1, -0.5, 0., 0.5, 1, 1.5});
+
+  // 3/32 + x/2 + 15x^2/32, evaluated without decrypting
+  setenv("NGRAPH_HE_POLY_ACTIVATION", "relu2", 1);
+  auto handle = backend->compile(f);
+  unsetenv("NGRAPH_HE_POLY_ACTIVATION");
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(all_close(
+      read_vector<float>(t_result),
+      vector<float>{0.0625, -0.0390625, 0.09375, 0.4609375, 1.0625, 1.8984375},
+      1e-3f));
+}
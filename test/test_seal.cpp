@@ -14,10 +14,20 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <cstring>
 #include <memory>
+#include <sstream>
 
 #include "gtest/gtest.h"
+#include "he_plaintext.hpp"
+#include "seal/activation_request.hpp"
+#include "seal/convolution_taps.hpp"
+#include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/linear_plan.hpp"
+#include "seal/polynomial_activation.hpp"
 #include "seal/seal.h"
+#include "seal/seal_key_store.hpp"
+#include "tcp/tcp_message.hpp"
 
 using namespace std;
 
@@ -73,3 +83,200 @@ TEST(seal_example, seal_ckks_basics) {
   decryptor.decrypt(encrypted, plain);
   encoder.decode(plain, input);
 }
+
+TEST(seal_key_store, key_set_round_trip) {
+  using namespace seal;
+
+  EncryptionParameters parms(scheme_type::CKKS);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      CoeffModulus::Create(poly_modulus_degree, {40, 30, 40}));
+  auto context = SEALContext::Create(parms);
+
+  KeyGenerator keygen(context);
+  ngraph::he::SealKeySet keys;
+  keys.session_token = ngraph::he::generate_session_token();
+  keys.secret_key = make_shared<SecretKey>(keygen.secret_key());
+  keys.public_key = make_shared<PublicKey>(keygen.public_key());
+  keys.relin_keys = make_shared<RelinKeys>(keygen.relin_keys());
+  EXPECT_TRUE(ngraph::he::is_valid_session_token(keys.session_token));
+  EXPECT_FALSE(ngraph::he::is_valid_session_token("../" + keys.session_token));
+
+  stringstream stream;
+  keys.save(stream);
+  ngraph::he::SealKeySet loaded_keys;
+  loaded_keys.load(context, stream);
+  EXPECT_EQ(loaded_keys.session_token, keys.session_token);
+  ASSERT_NE(loaded_keys.secret_key, nullptr);
+  ASSERT_NE(loaded_keys.public_key, nullptr);
+  EXPECT_NE(loaded_keys.relin_keys, nullptr);
+  EXPECT_EQ(loaded_keys.galois_keys, nullptr);
+
+  // A key generator from the loaded keys decrypts ciphertexts encrypted with
+  // the original public key
+  KeyGenerator loaded_keygen(context, *loaded_keys.secret_key,
+                             *loaded_keys.public_key);
+  Encryptor encryptor(context, *keys.public_key);
+  Decryptor decryptor(context, loaded_keygen.secret_key());
+  CKKSEncoder encoder(context);
+
+  vector<double> input{0.5, 1.5, 2.5};
+  Plaintext plain;
+  encoder.encode(input, pow(2.0, 30), plain);
+  Ciphertext encrypted;
+  encryptor.encrypt(plain, encrypted);
+  decryptor.decrypt(encrypted, plain);
+  vector<double> output;
+  encoder.decode(plain, output);
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_NEAR(input[i], output[i], 1e-3);
+  }
+}
+
+TEST(seal_parameter_sets, activation_request_round_trip) {
+  ngraph::he::ActivationRequest activation;
+  activation.type = ngraph::he::ActivationRequest::Type::bounded_relu;
+  activation.alpha = 6;
+  activation.parameter_sets.parameter_set = 2;
+  activation.parameter_sets.result_parameter_set = 1;
+
+  ngraph::he::ActivationRequest loaded;
+  loaded.load(activation.save());
+  EXPECT_EQ(loaded.type, activation.type);
+  EXPECT_EQ(loaded.alpha, 6);
+  EXPECT_EQ(loaded.parameter_sets.parameter_set, 2u);
+  EXPECT_EQ(loaded.parameter_sets.result_parameter_set, 1u);
+
+  // Messages without parameter sets use parameter set 0
+  ngraph::he::RoundTripParameterSets parameter_sets;
+  parameter_sets.parameter_set = 3;
+  parameter_sets.load("");
+  EXPECT_EQ(parameter_sets.parameter_set, 0u);
+  EXPECT_EQ(parameter_sets.result_parameter_set, 0u);
+}
+
+TEST(seal_he_plaintext, is_uniform) {
+  using ngraph::he::HEPlaintext;
+  // Uniform plaintexts take the scalar multiply_plain and add_plain paths
+  EXPECT_TRUE(HEPlaintext(2.5f).is_uniform());
+  EXPECT_TRUE(HEPlaintext(vector<float>{0.5f, 0.5f, 0.5f}).is_uniform());
+  EXPECT_FALSE(HEPlaintext(vector<float>{0.5f, 0.5f, 1.5f}).is_uniform());
+  EXPECT_FALSE(HEPlaintext().is_uniform());
+}
+
+TEST(seal_polynomial_activation, paterson_stockmeyer_depth) {
+  using ngraph::he::PolynomialActivation;
+  // Unit coefficients need no scalar multiplication
+  EXPECT_EQ(PolynomialActivation::parse("square").depth(), 1u);
+  EXPECT_EQ(PolynomialActivation::parse("relu2").depth(), 2u);
+  EXPECT_EQ(PolynomialActivation::parse("relu4").depth(), 3u);
+  // ceil(log2(degree)) + 1
+  EXPECT_EQ(PolynomialActivation::parse("1,2,3,4,5,6,7,8").depth(), 4u);
+
+  // Fits on [-bound, bound] are scaled fits on [-1, 1]
+  auto relu = PolynomialActivation::parse("relu4");
+  auto scaled_relu = PolynomialActivation::parse("relu4:8");
+  EXPECT_NEAR(scaled_relu.evaluate(4.0), 8 * relu.evaluate(0.5), 1e-9);
+}
+
+TEST(seal_linear_plan, groups_taps_by_weight) {
+  using ngraph::he::LinearPlan;
+  // Taps of (input, weight) index pairs for two outputs
+  vector<LinearPlan::Taps> taps{{{0, 0}, {1, 1}, {2, 2}, {3, 3}},
+                                {{1, 0}, {2, 1}, {3, 2}, {4, 3}}};
+  vector<float> weights{0.5f, 0.f, 0.5f, -2.f};
+  LinearPlan plan(taps, weights, 1);
+  EXPECT_EQ(plan.output_count(), 2u);
+  EXPECT_EQ(plan.tap_count(), 8u);
+  // The zero weight is dropped, and the two weights of 0.5 share a product
+  EXPECT_EQ(plan.multiply_count(), 4u);
+  ASSERT_EQ(plan.groups(1).size(), 2u);
+  EXPECT_EQ(plan.groups(1)[0].weight, -2.f);
+  EXPECT_EQ(plan.groups(1)[0].input_indices, (vector<size_t>{4}));
+  EXPECT_EQ(plan.groups(1)[1].weight, 0.5f);
+  EXPECT_EQ(plan.groups(1)[1].input_indices, (vector<size_t>{1, 3}));
+
+  // Weights may also be the first index of a tap
+  LinearPlan transposed_plan({{{2, 0}, {3, 1}}}, {0.f, 1.f, 0.f, 1.f}, 0);
+  ASSERT_EQ(transposed_plan.groups(0).size(), 1u);
+  EXPECT_EQ(transposed_plan.groups(0)[0].input_indices, (vector<size_t>{0, 1}));
+}
+
+TEST(seal_convolution_taps, padded_rotated_filter) {
+  using ngraph::he::ConvolutionTaps;
+  using ngraph::he::LinearPlan;
+  // 1D convolution of 3 inputs with a filter of 2 taps, padded by 1 on both
+  // sides
+  auto make_taps = [](bool rotate_filter) {
+    return ConvolutionTaps(ngraph::Shape{1, 1, 3}, ngraph::Shape{1, 1, 2},
+                           ngraph::Shape{1, 1, 4}, ngraph::Strides{1},
+                           ngraph::Strides{1}, ngraph::CoordinateDiff{1},
+                           ngraph::CoordinateDiff{1}, ngraph::Strides{1},
+                           rotate_filter);
+  };
+  auto all_taps = [](const ConvolutionTaps& conv_taps) {
+    vector<LinearPlan::Taps> taps;
+    for (size_t out_index = 0; out_index < conv_taps.output_count();
+         ++out_index) {
+      taps.emplace_back(conv_taps.taps(out_index));
+    }
+    return taps;
+  };
+  // Taps in the padding are skipped
+  const ConvolutionTaps taps = make_taps(false);
+  EXPECT_EQ(all_taps(taps),
+            (vector<LinearPlan::Taps>{
+                {{0, 1}}, {{0, 0}, {1, 1}}, {{1, 0}, {2, 1}}, {{2, 0}}}));
+  EXPECT_EQ(all_taps(make_taps(true)),
+            (vector<LinearPlan::Taps>{
+                {{0, 0}}, {{0, 1}, {1, 0}}, {{1, 1}, {2, 0}}, {{2, 1}}}));
+  EXPECT_EQ(taps.tap_count(), 6u);
+  EXPECT_EQ(taps.input_bound(0), 1u);
+  EXPECT_EQ(taps.input_bound(3), 3u);
+
+  // The windows are shared by the batch items and channels
+  const ConvolutionTaps channel_taps(
+      ngraph::Shape{2, 2, 3}, ngraph::Shape{3, 2, 2}, ngraph::Shape{2, 3, 2},
+      ngraph::Strides{1}, ngraph::Strides{1}, ngraph::CoordinateDiff{0},
+      ngraph::CoordinateDiff{0}, ngraph::Strides{1});
+  EXPECT_EQ(channel_taps.tap_count(), 48u);
+  // Batch item 1, output channel 2 and position 1 reads inputs 7, 8 of
+  // channel 0 and 10, 11 of channel 1
+  EXPECT_EQ(channel_taps.taps(11),
+            (LinearPlan::Taps{{7, 8}, {8, 9}, {10, 10}, {11, 11}}));
+  EXPECT_EQ(channel_taps.input_bound(11), 12u);
+}
+
+TEST(seal_tcp_message, rejects_invalid_chunk) {
+  using ngraph::he::TCPMessage;
+  auto receive = [](const TCPMessage& sent) {
+    TCPMessage received;
+    std::memcpy(received.header_ptr(), sent.header_ptr(),
+                TCPMessage::header_length);
+    received.decode_header();
+    std::memcpy(received.body_ptr(), sent.body_ptr(), sent.body_length());
+    received.decode_body();
+  };
+  std::stringstream stream;
+  stream.write("abcdef", 6);
+  TCPMessage message(ngraph::he::MessageType::execute, 3, std::move(stream));
+  EXPECT_NO_THROW(receive(message));
+
+  // Elements [2, 5) of 3
+  size_t offset = 2;
+  std::memcpy(message.offset_ptr(), &offset, sizeof(offset));
+  EXPECT_THROW(receive(message), std::invalid_argument);
+}
+
+TEST(seal_encryption_parameters, recommend_encryption_parameters) {
+  // 2 * 30 + 3 * 24 bits exceed the 109 bits of N = 4096 at 128-bit security
+  auto parms = ngraph::he::recommend_encryption_parameters(3, 1, 24);
+  EXPECT_EQ(parms.poly_modulus_degree(), 8192u);
+  EXPECT_EQ(parms.coeff_modulus_bits(), (std::vector<int>{30, 24, 24, 24, 30}));
+  EXPECT_EQ(parms.max_chain_index(), 3u);
+
+  // Slots bound N from below
+  parms = ngraph::he::recommend_encryption_parameters(0, 4096, 24);
+  EXPECT_EQ(parms.poly_modulus_degree(), 8192u);
+}
@@ -22,6 +22,7 @@
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/he_seal_client.hpp"
+#include "seal/he_seal_encryption_parameters.hpp"
 #include "seal/he_seal_executable.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
@@ -116,3 +117,325 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_cipher_plain) {
   client_thread.join();
   EXPECT_TRUE(all_close(results, vector<float>{0, 0, 3.3}, 1e-3f));
 }
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_softmax_cipher_plain) {
+  std::this_thread::sleep_for(std::chrono::seconds(10));
+
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = make_shared<op::Parameter>(element::f32, shape);
+  auto t = make_shared<op::Add>(a, b);
+  auto softmax = make_shared<op::Softmax>(t, AxisSet{1});
+  auto f = make_shared<Function>(softmax, ParameterVector{b});
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  // Used for dummy server inputs
+  float DUMMY_FLOAT = 99;
+  copy_data(t_dummy, vector<float>{DUMMY_FLOAT, DUMMY_FLOAT, DUMMY_FLOAT});
+
+  vector<float> inputs{1, 2, 3};
+  vector<float> results;
+  auto client_thread = std::thread([this, &inputs, &results, &batch_size]() {
+    auto he_client =
+        ngraph::he::HESealClient("localhost", 34000, batch_size, inputs);
+
+    while (!he_client.is_done()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    results = he_client.get_results();
+  });
+
+  auto handle = dynamic_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend->compile(f));
+  handle->enable_client();
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  EXPECT_TRUE(all_close(results, vector<float>{0.07675, 0.23057, 0.69268},
+                        1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_softmax_data_streams) {
+  std::this_thread::sleep_for(std::chrono::seconds(10));
+  // Two data streams would split the 10 ciphertexts into two chunks of 5,
+  // but the client activates whole Softmax groups
+  setenv("NGRAPH_HE_DATA_STREAMS", "2", 1);
+
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 10};
+  auto a = op::Constant::create(element::f32, shape, vector<float>(10, 0.1));
+  auto b = make_shared<op::Parameter>(element::f32, shape);
+  auto t = make_shared<op::Add>(a, b);
+  auto softmax = make_shared<op::Softmax>(t, AxisSet{1});
+  auto f = make_shared<Function>(softmax, ParameterVector{b});
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  vector<float> inputs{0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};
+  vector<float> results;
+  auto client_thread = std::thread([this, &inputs, &results, &batch_size]() {
+    auto he_client =
+        ngraph::he::HESealClient("localhost", 34000, batch_size, inputs);
+
+    while (!he_client.is_done()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    results = he_client.get_results();
+  });
+
+  auto handle = dynamic_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend->compile(f));
+  handle->enable_client();
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  unsetenv("NGRAPH_HE_DATA_STREAMS");
+  EXPECT_TRUE(all_close(results,
+                        vector<float>{0.06121, 0.06764, 0.07476, 0.08262,
+                                      0.09131, 0.10091, 0.11153, 0.12326,
+                                      0.13622, 0.15054},
+                        1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_unix_socket) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = make_shared<op::Parameter>(element::f32, shape);
+  auto t = make_shared<op::Add>(a, b);
+  auto f = make_shared<Function>(t, ParameterVector{b});
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  // Used for dummy server inputs
+  float DUMMY_FLOAT = 99;
+  copy_data(t_dummy, vector<float>{DUMMY_FLOAT, DUMMY_FLOAT, DUMMY_FLOAT});
+
+  string server_uri{"unix:///tmp/he_transformer_test.sock"};
+
+  vector<float> inputs{1, 2, 3};
+  vector<float> results;
+  auto client_thread =
+      std::thread([this, &server_uri, &inputs, &results, &batch_size]() {
+        auto he_client =
+            ngraph::he::HESealClient(server_uri, batch_size, inputs);
+
+        while (!he_client.is_done()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        results = he_client.get_results();
+      });
+
+  auto handle = dynamic_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend->compile(f));
+  handle->set_server_uri(server_uri);
+  handle->enable_client();
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  EXPECT_TRUE(all_close(results, vector<float>{1.1, 2.2, 3.3}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_multiple_queries) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = make_shared<op::Parameter>(element::f32, shape);
+  auto t = make_shared<op::Add>(a, b);
+  auto relu = make_shared<op::Relu>(t);
+  auto f = make_shared<Function>(relu, ParameterVector{b});
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  // Used for dummy server inputs
+  float DUMMY_FLOAT = 99;
+  copy_data(t_dummy, vector<float>{DUMMY_FLOAT, DUMMY_FLOAT, DUMMY_FLOAT});
+
+  vector<float> results0;
+  vector<float> results1;
+  auto client_thread =
+      std::thread([this, &results0, &results1, &batch_size]() {
+        auto he_client = ngraph::he::HESealClient("tcp://localhost:34000",
+                                                  batch_size, size_t(2));
+
+        // Both queries are in flight before the first result arrives
+        auto future0 = he_client.submit(vector<float>{1, 2, 3});
+        auto future1 = he_client.submit(vector<float>{-1, -0.2, 3});
+        results0 = future0.get();
+        results1 = future1.get();
+      });
+
+  auto handle = dynamic_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend->compile(f));
+  handle->enable_client();
+  handle->call_with_validate({t_result}, {t_dummy});
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  EXPECT_TRUE(all_close(results0, vector<float>{1.1, 2.2, 3.3}, 1e-3f));
+  EXPECT_TRUE(all_close(results1, vector<float>{0, 0, 3.3}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_segment_parameter_sets) {
+  std::this_thread::sleep_for(std::chrono::seconds(10));
+  // The Dot after the Relu round trip needs one level, so its segment uses
+  // the cheaper config, under which the client re-encrypts the Relu results
+  string cheap_config{"/tmp/he_transformer_test_segment_N1024.json"};
+  string deep_config{"/tmp/he_transformer_test_segment_N2048.json"};
+  ngraph::he::save_config(ngraph::he::HESealEncryptionParameters(
+                              "HE_SEAL", 1024, 0, {30, 30, 30, 30}),
+                          cheap_config);
+  ngraph::he::save_config(ngraph::he::HESealEncryptionParameters(
+                              "HE_SEAL", 2048, 0, {30, 30, 30, 30, 30, 30}),
+                          deep_config);
+  setenv("NGRAPH_HE_SEAL_SEGMENT_CONFIGS",
+         (cheap_config + "," + deep_config).c_str(), 1);
+
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 4};
+  auto make_function = [shape]() {
+    auto w1 = op::Constant::create<float>(
+        element::f32, Shape{4, 3},
+        {0.5, -1, 0.25, 2, 1, -0.5, 0.75, -2, 1.5, -0.25, 0.5, 1});
+    auto w2 = op::Constant::create<float>(element::f32, Shape{3, 2},
+                                          {1, -0.5, 0.25, 2, -1, 0.75});
+    auto b = make_shared<op::Parameter>(element::f32, shape);
+    auto relu = make_shared<op::Relu>(make_shared<op::Dot>(b, w1));
+    auto dot = make_shared<op::Dot>(relu, w2);
+    return make_shared<Function>(dot, ParameterVector{b});
+  };
+  Shape result_shape{batch_size, 2};
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, result_shape);
+
+  vector<float> inputs{1, -0.5, 2, 0.25};
+  vector<float> results;
+  auto client_thread = std::thread([&inputs, &results, &batch_size]() {
+    auto he_client =
+        ngraph::he::HESealClient("localhost", 34000, batch_size, inputs);
+
+    while (!he_client.is_done()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    results = he_client.get_results();
+  });
+
+  auto handle = dynamic_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend->compile(make_function()));
+  handle->enable_client();
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  unsetenv("NGRAPH_HE_SEAL_SEGMENT_CONFIGS");
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(make_function());
+  auto int_a = int_backend->create_tensor(element::f32, shape);
+  auto int_result = int_backend->create_tensor(element::f32, result_shape);
+  copy_data(int_a, inputs);
+  int_handle->call_with_validate({int_result}, {int_a});
+  EXPECT_TRUE(all_close(results, read_vector<float>(int_result), 1e-3f));
+}
+
+// Streams the client input into a Convolution, optionally followed by a bias
+// which is fused into a BiasedConvolution, and compares the result to
+// INTERPRETER
+static void check_streamed_convolution(bool biased) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  // The 576 input ciphertexts span several chunks
+  Shape shape{batch_size, 1, 24, 24};
+  Shape result_shape{batch_size, 2, 24, 24};
+  auto make_function = [shape, result_shape, biased]() {
+    auto b = make_shared<op::Parameter>(element::f32, shape);
+    auto filters = op::Constant::create<float>(
+        element::f32, Shape{2, 1, 3, 3},
+        {0.5, -1, 0.25, 2, 1, -0.5, 0.75, -2, 1.5, -0.25, 0.5, 1, 1, -0.5,
+         0.25, 2, -1, 0.75});
+    shared_ptr<Node> t = make_shared<op::Convolution>(
+        b, filters, Strides{1, 1}, Strides{1, 1}, CoordinateDiff{1, 1},
+        CoordinateDiff{1, 1});
+    if (biased) {
+      auto bias = make_shared<op::Broadcast>(
+          op::Constant::create<float>(element::f32, Shape{2}, {0.5, -0.25}),
+          result_shape, AxisSet{0, 2, 3});
+      t = make_shared<op::Add>(t, bias);
+    }
+    return make_shared<Function>(t, ParameterVector{b});
+  };
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, result_shape);
+
+  vector<float> inputs(shape_size(shape));
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i] = 0.125f * (i % 17) - 1;
+  }
+  vector<float> results;
+  auto client_thread = std::thread([&inputs, &results, &batch_size]() {
+    auto he_client =
+        ngraph::he::HESealClient("localhost", 34000, batch_size, inputs);
+
+    while (!he_client.is_done()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    results = he_client.get_results();
+  });
+
+  auto he_f = make_function();
+  auto handle = dynamic_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend->compile(he_f));
+  EXPECT_EQ(biased ? 0 : 1, count_ops_of_type<op::Convolution>(he_f));
+  handle->enable_client();
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(make_function());
+  auto int_a = int_backend->create_tensor(element::f32, shape);
+  auto int_result = int_backend->create_tensor(element::f32, result_shape);
+  copy_data(int_a, inputs);
+  int_handle->call_with_validate({int_result}, {int_a});
+  EXPECT_TRUE(all_close(results, read_vector<float>(int_result), 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_stream_convolution) {
+  std::this_thread::sleep_for(std::chrono::seconds(10));
+  check_streamed_convolution(false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_stream_biased_convolution) {
+  std::this_thread::sleep_for(std::chrono::seconds(10));
+  check_streamed_convolution(true);
+}
@@ -22,7 +22,9 @@
 #include <string>
 #include <vector>
 
+#include "gtest/gtest.h"
 #include "test_util.hpp"
+#include "util/test_tools.hpp"
 
 std::vector<float> read_constant(const std::string filename) {
   std::string data = ngraph::file_util::read_file_to_string(filename);
@@ -184,3 +186,51 @@ generate_plain_cipher_tensors(const std::vector<std::shared_ptr<Node>>& output,
   }
   return ret;
 }
+
+void check_against_interpreter(
+    runtime::Backend* backend,
+    const std::function<std::shared_ptr<Function>()>& make_function,
+    const std::vector<std::vector<float>>& inputs,
+    const std::function<void(const std::shared_ptr<Function>&)>&
+        check_compiled,
+    float atol) {
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend);
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto he_f = make_function();
+  auto int_f = make_function();
+  NGRAPH_CHECK(inputs.size() == int_f->get_parameters().size(),
+               "Expected ", int_f->get_parameters().size(), " inputs");
+
+  std::vector<std::shared_ptr<runtime::Tensor>> he_inputs;
+  std::vector<std::shared_ptr<runtime::Tensor>> int_inputs;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& param = int_f->get_parameters()[i];
+    he_inputs.emplace_back(he_backend->create_cipher_tensor(
+        param->get_element_type(), param->get_shape()));
+    int_inputs.emplace_back(int_backend->create_tensor(
+        param->get_element_type(), param->get_shape()));
+    copy_data(he_inputs.back(), inputs[i]);
+    copy_data(int_inputs.back(), inputs[i]);
+  }
+  std::vector<std::shared_ptr<runtime::Tensor>> he_results;
+  std::vector<std::shared_ptr<runtime::Tensor>> int_results;
+  for (const auto& result : int_f->get_results()) {
+    he_results.emplace_back(he_backend->create_cipher_tensor(
+        result->get_element_type(), result->get_shape()));
+    int_results.emplace_back(int_backend->create_tensor(
+        result->get_element_type(), result->get_shape()));
+  }
+
+  auto he_handle = he_backend->compile(he_f);
+  if (check_compiled) {
+    check_compiled(he_f);
+  }
+  he_handle->call_with_validate(he_results, he_inputs);
+  auto int_handle = int_backend->compile(int_f);
+  int_handle->call_with_validate(int_results, int_inputs);
+
+  for (size_t i = 0; i < he_results.size(); ++i) {
+    EXPECT_TRUE(all_close(read_vector<float>(he_results[i]),
+                          read_vector<float>(int_results[i]), atol));
+  }
+}
@@ -17,12 +17,14 @@
 #pragma once
 
 #include <complex>
+#include <functional>
 #include <string>
 #include <vector>
 
 #include "he_tensor.hpp"
 #include "ngraph/descriptor/layout/tensor_layout.hpp"
 #include "ngraph/file_util.hpp"
+#include "ngraph/function.hpp"
 #include "ngraph/node.hpp"
 #include "ngraph/runtime/tensor.hpp"
 #include "ngraph/type/element_type.hpp"
@@ -79,3 +81,15 @@ generate_plain_cipher_tensors(const std::vector<std::shared_ptr<Node>>& output,
                               const runtime::Backend* backend,
                               const bool consistent_type = false,
                               const bool skip_plain_plain = false);
+
+// Calls the functions returned by make_function on backend, with encrypted
+// inputs and results, and on INTERPRETER, and checks that each result is
+// within atol. check_compiled, if set, inspects the function compiled by
+// backend
+void check_against_interpreter(
+    runtime::Backend* backend,
+    const std::function<std::shared_ptr<Function>()>& make_function,
+    const std::vector<std::vector<float>>& inputs,
+    const std::function<void(const std::shared_ptr<Function>&)>&
+        check_compiled = nullptr,
+    float atol = 1e-3f);